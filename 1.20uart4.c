@@ -5,18 +5,107 @@
 #include "relay.h"
 #include "led.h"
 #include "D1302.h"
+#include "iap_log.h"      // EEPROM追加日志（事件/历史持久化）
+#include "timer_wheel.h"  // 软件定时器（分层时间轮）
+#include "journal.h"      // 事件日志
+#include "daymax.h"       // 每日最高温记录
+#include "uart_frame.h"   // 串口接收组帧
 #include <string.h>       // 字符串操作库
-#include <math.h>         // 数学库（用于NTC温度计算的对数运算）
+#if !NTC_USE_LUT || NTC_CAL_ENABLE
+#include <math.h>         // 数学库（用于NTC温度计算/校准修正表的对数运算）
+#endif
 
 #ifndef NULL
 #define NULL ((void*)0)
 #endif
 
+#if TMR_ID_COUNT > TW_TIMER_COUNT
+#error "TW_TIMER_COUNT in timer_wheel.h is smaller than TMR_ID_COUNT"
+#endif
+
+#if ROLLUP_REC_LEN > 250
+#error "TOTAL_SLAVES too large for one rollup record"
+#endif
+#if (ROLLUP_HOUR_SECTORS - 1) * IAP_AREA_SLOTS(ROLLUP_REC_LEN) < ROLLUP_HOURS || (ROLLUP_DAY_SECTORS - 1) * IAP_AREA_SLOTS(ROLLUP_REC_LEN) < ROLLUP_DAYS
+#error "ROLLUP_HOUR_SECTORS/ROLLUP_DAY_SECTORS too small for ROLLUP_HOURS/ROLLUP_DAYS"
+#endif
+#if (HIST_AREA_SECTORS - 1) * IAP_AREA_SLOTS_AUX(HIST_AREA_REC_LEN, HIST_AREA_AUX_LEN) < TOTAL_SLAVES * (HIST_ZIP_BLOCKS - 1)
+#error "HIST_AREA_SECTORS too small to keep HIST_ZIP_BLOCKS-1 blocks per slave"
+#endif
+#if RECORDS_PER_SLAVE >= HIST_SLOT_NONE
+#error "HIST_ZIP_BLOCKS x HIST_ZIP_BLOCK_SIZE exceeds the history slot numbers"
+#endif
+#if MAX_MAX_TEMP_EVENTS > DAY_MAX_DAYS
+#error "DAY_MAX_DAYS in daymax.h is smaller than MAX_MAX_TEMP_EVENTS"
+#endif
+#if THR_AREA_REC_LEN > 250
+#error "TOTAL_SLAVES too large for one threshold record"
+#endif
+#if NTC_CAL_AREA_REC_LEN > 250
+#error "TOTAL_SLAVES too large for one calibration record"
+#endif
+
 // ------------------- 全局变量定义 -------------------
 // UART通信相关
-unsigned char uart_rx_buff[UART_BUFF_SIZE] = {0};  // 接收缓冲区（6字节协议帧）
-unsigned char uart_rx_len = 0;                     // 接收数据长度
-bit uart_rx_complete = 0;                          // 接收完成标志（1=完成）
+bit uart_rx_complete = 0;                          // 接收完成标志（1=帧队列非空）
+unsigned char uart_frame_queue[UART_FRAME_QUEUE_DEPTH][UART_BUFF_SIZE] = {0}; // 有效帧队列（单生产者/单消费者）
+volatile unsigned char uart_frame_head = 0;        // 帧队列写指针（仅ISR修改）
+volatile unsigned char uart_frame_tail = 0;        // 帧队列读指针（仅主循环修改）
+volatile unsigned char uart_rx_idle_ms = 0xFF;     // 距上一个接收字节的静默时间（毫秒，0xFF封顶）
+static bit uart_rx_hunting = 0;                    // 组帧失步标志（1=正在滑动窗口寻找有效帧）
+
+// 发送环形缓冲区（主循环写入，UART4发送中断取出）
+static unsigned char uart_tx_buff[UART_TX_BUFF_SIZE];
+static volatile unsigned int uart_tx_head = 0;     // 写指针（主循环）
+static volatile unsigned int uart_tx_tail = 0;     // 读指针（ISR）
+static volatile bit uart_tx_busy = 0;              // 1=发送器正在工作，后续字节由中断续发
+
+// 通信质量统计相关（ISR与主循环共同修改，主循环侧递增需使用LINK_STAT_INC）
+UART_LinkStats link_stats = {0};                   // 链路质量统计计数
+unsigned int link_aid_rx[TOTAL_SLAVES] = {0};      // 各从站收到的有效帧数
+unsigned int link_aid_fail[TOTAL_SLAVES] = {0};    // 各从站失败帧数（校验失败/温度无效）
+unsigned int link_aid_offline[TOTAL_SLAVES] = {0}; // 各从站离线次数
+
+// 调试日志相关（运行期开关，编译期上限见LOG_COMPILE_LEVEL）
+unsigned char log_level = LOG_COMPILE_LEVEL;       // 运行期日志级别
+unsigned char log_module_mask = LOG_MOD_ALL;       // 运行期日志模块掩码
+
+// NTC校准相关
+NTC_Calib ntc_calib[TOTAL_SLAVES];                      // 各从站校准参数
+static short ntc_cal_corr[TOTAL_SLAVES][NTC_CAL_KNOTS]; // 各从站修正表（0.01℃，含偏移）
+static unsigned char ntc_cal_active[TOTAL_SLAVES];      // 1=该从站已校准（名义参数时跳过修正）
+static NTC_Calib ntc_cal_stage;                         // 串口校准暂存区
+static unsigned char ntc_cal_stage_aid = 0;             // 暂存区对应的AID（0=未选择）
+#if PERSIST_ENABLE && NTC_CAL_ENABLE
+static IapArea ntc_cal_area;                            // 校准区（EEPROM，全部从站校准参数一条记录）
+#endif
+
+// 预警/报警阈值相关（见uart4.h"预警/报警阈值配置"）
+SlaveThreshold slave_thr[TOTAL_SLAVES];                 // 各从站阈值
+static unsigned char thr_pending[TOTAL_SLAVES];         // 与当前级别不同的待确认级别（等于当前级别=无）
+static unsigned int thr_since[TOTAL_SLAVES];            // 待确认级别开始的节拍（TimerWheel_Now低16位）
+static unsigned char thr_sel_aid = 0;                   // UART_CMD_THR_SET作用的AID（0=全部从站）
+#if PERSIST_ENABLE
+static IapArea thr_area;                                // 阈值区（EEPROM，全部从站阈值一条记录）
+#endif
+
+// 升温速率检测相关（见uart4.h"升温速率检测配置"）
+static short ror_ref_temp[TOTAL_SLAVES];                // 参考样本温度（0.1℃，-990=无参考）
+static unsigned int ror_ref_tick[TOTAL_SLAVES];         // 参考样本节拍（TimerWheel_Now低16位）
+static short ror_ema[TOTAL_SLAVES];                     // 平均升温速率（0.1℃/分钟，ROR_EMA_Q位小数）
+static unsigned char ror_fired_map[RT_BITMAP_BYTES];    // 已产生升温速率事件、尚未回落的从站位图
+
+// 二进制遥测相关
+unsigned char telemetry_mode = TELEMETRY_MODE_ASCII;  // 遥测输出模式
+static unsigned char telemetry_saved_log_level = LOG_COMPILE_LEVEL;  // 进入二进制模式前的日志级别
+
+// 历史记录策略相关
+unsigned char hist_log_deadband_deci = HIST_LOG_DEADBAND_DECI;  // 温度死区（0.1℃）
+unsigned char hist_log_max_min = HIST_LOG_MAX_MIN;              // 心跳间隔（分钟）
+
+// 主循环中递增统计计数：屏蔽UART4/定时器0中断，避免与ISR同时修改多字节计数器
+// 恢复调用前的EA，调用者已关中断（IAP、定时器临界区等）时不会被重新打开
+#define LINK_STAT_INC(cnt)  do { bit ea_save = EA; EA = 0; (cnt)++; EA = ea_save; } while (0)
 
 // 系统计时相关
 unsigned long delay_count = 0;                     // 延时计数器
@@ -24,16 +113,43 @@ unsigned long system_tick = 0;                     // 系统滴答计时器（
 
 // RTC时间相关
 rtc_time_t current_rtc_time;                      // 当前RTC时间（年/月/日/时/分/秒）
-unsigned long rtc_refresh_counter = 0;             // RTC刷新计数器（用于控制刷新频率）
 bit need_rtc_refresh = 1;                         // RTC刷新标志（1=需要刷新）
 unsigned char current_system_date[3] = {0};       // 年、月、日（用于判断跨天）
 
 // 数据存储相关
 unsigned char slave_id;                           // 从站ID（临时存储）
 DataRecord *recent_data;                          // 最新数据指针
-Protocol_Data parsed_data = {0, 0, 0, 0.0f, 0, -990};  // 解析后的协议数据（初始化为无效值）
-DataRecord data_summary[TOTAL_RECORDS] = {0};     // 数据记录存储数组（实时+历史）
-unsigned char history_index[TOTAL_SLAVES] = {0};  // 每个从站的历史记录索引
+Protocol_Data parsed_data = {0, 0, 0, 0, 0, -990};  // 解析后的协议数据（初始化为无效值）
+unsigned char hist_zip[TOTAL_SLAVES][HIST_ZIP_BLOCK_SIZE];  // 历史数据当前块（写满后移入EEPROM历史区）
+unsigned char hist_zip_len[TOTAL_SLAVES];         // 当前块已用字节数（0=空块）
+static HistEntry hist_zip_last[TOTAL_SLAVES];     // 每个从站最近写入的值（增量基准）
+#if PERSIST_ENABLE
+static IapArea hist_area;                         // 历史区（EEPROM，各从站已写满的块）
+static IapArea rollup_hour_area;                  // 小时汇总区（EEPROM）
+static IapArea rollup_day_area;                   // 每日汇总区（EEPROM）
+static RollupAcc rollup_acc[TOTAL_SLAVES];        // 当前小时累加器（结束一天时临时用于汇总该天）
+static unsigned long rollup_hour;                 // 当前小时序号（rollup_open=1时有效）
+static bit rollup_open;                           // 1=当前小时已有样本
+static unsigned long rollup_hour_last;            // 小时区最新一条的小时序号（ROLLUP_NONE=无）
+static unsigned long rollup_day_last;             // 日区最新一条的天序号（ROLLUP_NONE=无）
+#endif
+short rt_temp_deci[TOTAL_SLAVES];                 // 实时温度（0.1℃，-990=无效）
+unsigned int rt_volt_mv[TOTAL_SLAVES];            // 实时电池电压（mV）
+unsigned char rt_pid[TOTAL_SLAVES];               // 最近一帧的PID
+unsigned long rt_last_tick[TOTAL_SLAVES];         // 最近一帧的系统滴答（ms）
+unsigned char rt_valid_map[RT_BITMAP_BYTES];      // 实时数据有效位图
+unsigned char rt_abnormal_map[RT_BITMAP_BYTES];   // 温度超过报警阈值位图
+unsigned char rt_offline_map[RT_BITMAP_BYTES];    // 离线位图（曾上报、已超时未再上报）
+unsigned char rt_level[TOTAL_SLAVES];             // 温度级别（TEMP_LEVEL_xxx）
+
+// 从站在线检测（离线超时定时器，见uart4.h"从站在线检测配置"）
+unsigned int live_timeout_s = LIVE_TIMEOUT_S;     // 离线超时（秒）
+static bit live_changed = 0;                      // 有从站离线或升温速率状态变化（主循环刷新显示后清除）
+static unsigned char live_loss_time[TOTAL_SLAVES][4];  // 各从站最近一次中断时间（月日时分，全0=未中断过）
+
+// 历史记录间隔（TMR_ID_HIST定时器：写入后先计最小间隔，到期后再计到心跳间隔）
+static unsigned char hist_open_map[RT_BITMAP_BYTES];  // 已过最小间隔（变化超过死区即记录）位图
+static unsigned char hist_beat_map[RT_BITMAP_BYTES];  // 已到心跳间隔（必须记录）位图
 unsigned char page18_hist_index[TOTAL_SLAVES] = {0}; // PAGE_18专用：每个从站独立历史索引
 
 // 显示相关
@@ -57,48 +173,60 @@ unsigned char default_password[6] = {1, 2, 3, 4, 5, 6};  // 默认密码（6位
 unsigned char current_password[6] = {0};                   // 当前密码（初始化为0）
 Password_EditState pwd_edit_state = PWD_EDIT_IDLE;          // 密码编辑状态（默认空闲）
 unsigned char pwd_edit_pos = 0;                           // 密码编辑选中位置（0-5）
-static unsigned int pwd_flash_timer = 0;                  // 密码闪烁计时器（250ms周期）
-static bit pwd_flash_state = 1;                           // 密码闪烁触发标记（1=闪烁中，0=结束）
 static unsigned char edit_temp_pwd[6] = {0};               // 临时密码存储（编辑时使用）
 
 // 通用闪烁相关
-static unsigned int flash_timer = 0;                       // 通用闪烁计时器
-static bit flash_state = 1;                               // 通用闪烁触发标记
+static bit flash_state = 1;                               // 编辑位闪烁状态（1=显示，0=空白，由TMR_ID_BLINK翻转）
 
 // 报警事件相关
-AlarmRecord alarm_events[MAX_ALARM_EVENTS] = {0};          // 报警事件记录数组（最多6条）
-unsigned char alarm_event_count = 0;                      // 当前报警事件数量
-unsigned char alarm_event_next_index = 0;                 // 下一个报警事件存储索引（循环覆盖）
 unsigned char last_abnormal_status[TOTAL_SLAVES] = {0};    // 从站上一次异常状态（1=异常，0=正常）
+static JournalRef alarm_open[TOTAL_SLAVES];                // 各从站最新一条报警事件在事件日志中的引用（已丢弃/删除时读取失败）
+static bit alarm_rescan = 0;                               // 报警事件表被删除/清空，下一帧检查全部从站
 unsigned char page10_scroll_page = 0;                    // PAGE_10分页控制（0=第1页，1=第2页）
 
-// 恢复事件相关
-RecoveryRecord recovery_events[MAX_RECOVERY_EVENTS] = {0}; // 恢复事件记录数组（最多6条）
-unsigned char recovery_event_count = 0;                   // 当前恢复事件数量
-unsigned char recovery_event_next_index = 0;              // 下一个恢复事件存储索引（循环覆盖）
+// 预警事件相关
+static PageType page11_source = PAGE_10;                  // PAGE_11详情的来源列表（PAGE_10报警/PAGE_13预警）
 
 // 最高温相关
-unsigned char max_temp_event_count = 0;                   // 最高温事件数量
-unsigned char max_temp_next_index = 0;                    // 下一个最高温事件存储索引
-bit disable_today_max_calc = 0;                          // 禁止当天最高温计算标志（0=允许，1=禁止）
-bit disable_max_temp_calc = 0;                          // 禁用最高温计算标记（0=允许，1=禁止）
 short max_temps[3] = {-990, -990, -990};                // 前3高温度（初始化无效值-990）
 rtc_time_t max_temp_times[3] = {0};                     // 前3高温度对应的发生时间
-DailyMaxTemp daily_max_temps[3] = {0};                  // 近3天最高温存储数组（0=当天，1=昨天，2=前天）
+static DayTopEntry day_top[DAY_TOP_K];                  // 当天最高温候选（第0名即当天最高温）
+static unsigned char day_top_n = 0;                     // 候选条数
+static DayTopEntry day_min;                             // 当天最低温
+static bit day_min_valid = 0;                           // 当天已有最低温
+static SlaveDayStat slave_day[SLAVE_DAY_DAYS][TOTAL_SLAVES];  // 各从站每日统计（按天循环，slave_day_head行为当天）
+static unsigned char slave_day_date[SLAVE_DAY_DAYS][3];        // 各行对应的日期（年月日，全0=未使用）
+static unsigned char slave_day_head = 0;                       // 当天所在行
+static rtc_time_t page28_date;                                 // PAGE_28查看的日期
 
 // PAGE_19相关
 Page19_AutoRecord page19_auto_records[3][4] = {0};        // PAGE_19自动记录数组（3个从站×4条记录）
 unsigned char page19_record_index[3] = {0};              // 每个从站的PAGE_19记录索引
 unsigned long page19_last_read_time[3] = {0};            // 每个从站的PAGE_19上次读取时间
-static unsigned char page19_selected_record = 0;          // PAGE_19当前选中的记录索引（0-3）
+static unsigned char page19_selected_record = 0;          // PAGE_19当前选中的记录索引（0~RECORDS_PER_SLAVE-1）
 static unsigned char page19_selected_slave = 0;           // PAGE_19当前选中的从站索引（0-2）
-static unsigned long last_save_time[TOTAL_SLAVES] = {0};  // 每个从站上次保存历史数据的时间（10分钟间隔）
 static unsigned long page19_trigger_timer = 0;            // PAGE_19独立触发计时器（1秒周期）
 unsigned char page18_scroll_page = 0;                    // PAGE_18当前滚动页（0-3，对应4页）
 
 // ------------------- 静态函数声明 -------------------
 // UART相关
 static void UART4_ClearBuffer(unsigned char *ptr, unsigned int len);  // 清空缓冲区
+static void UART4_ProcessFrame(unsigned char *frame); // 处理一帧有效数据（解析+存储+报警判断）
+static void UART4_HandleCommand(unsigned char *frame); // 处理上位机命令帧
+#if NTC_CAL_ENABLE
+static void NTC_CalibCommand(unsigned char *frame);   // 处理NTC校准命令
+static void NTC_CalibDump(unsigned char aid);         // 输出指定从站校准参数
+static void NTC_CalibSave(void);                      // 全部从站校准参数写入校准区
+#endif
+#if PERSIST_ENABLE && NTC_CAL_ENABLE
+static void NTC_CalibMount(void);                     // 挂载校准区，恢复最新一条校准参数
+#endif
+static void Threshold_Command(unsigned char *frame);  // 处理阈值设置命令
+static void Threshold_Dump(unsigned char aid);        // 输出指定从站阈值
+static void Threshold_Save(void);                     // 全部从站阈值写入阈值区
+#if PERSIST_ENABLE
+static void Threshold_Mount(void);                    // 挂载阈值区，恢复最新一条阈值
+#endif
 
 // 显示相关
 static void DisplayFixedLabels(void);                 // 显示固定标签（首次初始化时调用）
@@ -129,10 +257,15 @@ static void DisplayPage23(void);   // 最高温度删除确认页面（PAGE_23
 static void DisplayPage24(void);   // 修改日期时间页面（PAGE_24）
 static void DisplayPage25(void);   // 修改密码页面（PAGE_25）
 static void DisplayPage26(void);   // 恢复出厂设置确认页面（PAGE_26）
+static void DisplayPage27(void);   // 通信诊断页面（PAGE_27）
+static void DisplayPage28(void);   // 从站每日统计页面（PAGE_28）
 
 // 页面更新相关（局部刷新函数）
 static void UpdateDisplayForPage1(void);              // 局部刷新PAGE_1数据
 static void UpdateDisplayForPage3(void);              // 局部刷新PAGE_3数据
+static void UpdateDisplayForPage27(void);             // 局部刷新PAGE_27统计数据
+static void UpdateDisplayForPage28(void);             // 局部刷新PAGE_28统计数据
+static void DisplayTempDeci(unsigned char page, unsigned char col, short temp_deci);  // 显示带符号1位小数的温度（5个字符宽）
 static void DisplayAlarmEventsOnPage13(void);         // 在PAGE_13显示预警事件
 static void DisplayAlarmEventsOnPage10(void);         // 在PAGE_10显示报警事件
 static void DisplayRecoveryEventsOnPage14(void);      // 在PAGE_14显示恢复事件
@@ -158,17 +291,77 @@ static void HandleReturnKey(void);                  // 处理"返回"按键
 
 // 协议解析相关（解析UART接收的6字节协议帧）
 static bit Protocol_Check(unsigned char *frame);     // 协议FCS校验
-static short ADC_To_Temp(unsigned int adc_val);     // ADC值转换为温度（放大10倍）
+static short ADC_To_Temp(unsigned int adc_val, unsigned char aid);  // ADC值转换为温度（放大10倍，按从站校准）
 static void Protocol_Parse(unsigned char *frame);    // 解析协议帧数据
 static unsigned char TempShortToChar(short temp);    // 温度短整型转换为字符型（取整数部分）
 
 // 数据处理相关（数据存储、报警判断、最高温计算等）
-static DataRecord* GetFixedSlaveData(unsigned char aid);  // 根据AID获取从站数据
+static DataRecord* GetFixedSlaveData(unsigned char aid, DataRecord *out);  // 根据AID获取从站数据
+static void Live_Touch(unsigned char slave_idx);     // 收到从站数据帧：离线超时重新计时，离线则恢复
+static void Live_OnTimeout(unsigned char slave_idx); // 离线超时定时器到期：判为离线
+static void Threshold_Update(unsigned char slave_idx, short temp_deci);  // 按阈值、回差和驻留时间更新温度级别
+static void RateRise_Reset(unsigned char slave_idx);  // 清除升温速率检测状态
+static void RateRise_Update(unsigned char slave_idx, short temp_deci);  // 更新平均升温速率并判断是否超限
+static bit Live_IsOffline(unsigned char aid);        // 从站是否离线（显示用）
 static void AddToHistoryData(unsigned char pid, unsigned char aid, unsigned int temp, unsigned int volt_mv);  // 添加数据到历史记录
-static void CheckDailyMaxTemp(void);                 // 检查并更新每日最高温
-static void CheckAndRecordAlarm(void);               // 检查并记录报警/恢复事件
+static unsigned long RtcToEpochMin(const rtc_time_t *t);            // RTC时间转换为纪元分钟（从1开始）
+static void EpochMinToRtc(unsigned long epoch_min, rtc_time_t *t);  // 纪元分钟还原为RTC时间（秒为0）
+static void HistZip_Begin(HistZipReader *rd, unsigned char slave_idx);  // 从最旧记录开始解码
+static void HistZip_Load(HistZipReader *rd);         // 读入解码器当前块
+static bit HistZip_Next(HistZipReader *rd);          // 解码下一条记录（无更多记录返回0）
+static unsigned char HistZip_Step(const unsigned char *p, HistEntry *cur);  // 解码一条记录累加到cur，返回记录长度
+static void HistZip_ToRecord(HistZipReader *rd, DataRecord *out);  // 解码结果展开为DataRecord视图
+static void History_Put(unsigned char slave_idx, unsigned char pid, short temp_deci, unsigned int volt_mv);  // 写入一条历史记录（压缩环）
+static void History_PutAt(unsigned char slave_idx, unsigned char pid, short temp_deci, unsigned int volt_mv, unsigned long now);  // 按指定纪元分钟写入一条历史记录
+static void History_Seal(unsigned char slave_idx);   // 当前块写入EEPROM历史区并清空
+#if PERSIST_ENABLE
+static void History_Mount(void);                     // 挂载历史区，取各从站最新一块的末条记录为增量基准
+#endif
+static bit HistLog_Due(unsigned char slave_idx);     // 按记录策略判断是否写入历史
+static void HistLog_Saved(unsigned char slave_idx);  // 已写入历史：重新开始最小间隔计时
+static void HistLog_OnTimer(unsigned char slave_idx);  // 历史记录间隔定时器到期
+static unsigned char History_Count(unsigned char slave_idx);  // 历史记录条数（含已删除）
+static unsigned char History_FindVisible(unsigned char slave_idx, unsigned char from_slot, DataRecord *out);  // 查找未删除的记录
+static void History_Invalidate(unsigned char slave_idx, unsigned char slot);  // 删除一条历史记录
+static void History_InvalidateEpoch(unsigned char slave_idx, unsigned long epoch_min);  // 删除指定时间的历史记录
+static void History_Export(unsigned char aid);      // 串口导出一个从站的历史记录
+#if PERSIST_ENABLE
+static void Rollup_Mount(void);                      // 挂载小时/每日汇总区，清空当前小时
+static unsigned long Rollup_Newest(const IapArea *a);  // 汇总区最新一条的小时/天序号
+static void Rollup_Feed(unsigned char slave_idx, unsigned long epoch_min, short temp_deci);  // 历史样本并入当前小时（逐级汇总）
+static void Rollup_Merge(RollupAcc *acc, short min_temp, short max_temp, long sum, unsigned int count);  // 样本或下级汇总并入累加器
+static void Rollup_Write(IapArea *a, unsigned long bucket);  // 全部从站的累加器写为一条汇总记录并清空
+static void Rollup_CloseDay(unsigned long day);      // 由小时区中该天的各小时汇总写入日区
+static unsigned long Rollup_ReadBucket(const IapAreaIter *it);  // 读汇总记录的小时/天序号
+static bit Rollup_ReadRec(const IapAreaIter *it, unsigned char slave_idx, short *min_temp, short *max_temp, short *avg);  // 读一个从站的汇总（0=无样本）
+static void Rollup_Export(unsigned char aid, bit daily);  // 串口输出一个从站的小时/每日汇总
+static void Rollup_SendLine(unsigned char aid, unsigned long bucket, bit daily, short min_temp, short max_temp, short avg, bit open);  // 输出一条汇总
+static void Rollup_SendTemp(unsigned char *label, short temp_deci);  // 输出"标签±温度"
+#endif
+static void Persist_SaveEvents(void);                // 事件日志和报警/跨天状态写入EEPROM日志
+static void Persist_SaveDayMax(void);                // 每日最高温记录写入EEPROM日志
+static void Persist_HistSample(unsigned char slave_idx, const HistEntry *e);  // 历史样本写入EEPROM日志
+static void Persist_HistDelete(unsigned char slave_idx, unsigned long epoch_min);  // 历史删除写入EEPROM日志
+static void DayStat_Sample(unsigned char slave_idx, short temp_deci);  // 有效样本更新当天最高/最低温
+static void DayStat_Reset(void);                     // 清除当天最高温候选和最低温
+static void DayStat_CheckDay(void);                  // 跨天检查并安排下一次零点检查
+static void DayMax_Write(bit is_max);                // 当天最高/最低温写入每日最高温记录
+static void SlaveDay_Sample(unsigned char slave_idx, short temp_deci);  // 有效样本累加到该从站当天统计
+static void SlaveDay_Clear(void);                    // 清空全部从站每日统计
+static void SlaveDay_SyncDate(void);                 // 当天行与current_system_date对齐（日期变化时换到下一行）
+static unsigned char SlaveDay_Find(const rtc_time_t *date);  // 按日期查找统计行（SLAVE_DAY_NONE=不在保留范围内）
+static void CheckAndRecordAlarm(unsigned char aid);  // 检查并记录报警/恢复事件（只检查本帧从站）
+static void Alarm_Evaluate(unsigned char slave_idx); // 按单个从站的实时数据判断报警/恢复
+static void Alarm_RebuildIndex(void);                // 按事件日志重建各从站的最新报警事件引用
+static void DayMax_Reopen(void);                     // 按每日最高温记录找回当天最高温
+static bit Event_LoadAlarm(unsigned char type, unsigned char nth, AlarmRecord *rec);  // 读取报警/预警事件视图
+static bit Event_LoadRecovery(unsigned char nth, RecoveryRecord *rec);  // 读取恢复事件视图
+static bit Event_LoadDayMax(unsigned char nth, DailyMaxTemp *rec);      // 读取每日最高温视图
 static void RecordAlarmEvent(unsigned char pid, unsigned char aid, unsigned char temp, unsigned int volt_mv);  // 记录报警事件
 static void RecordRecoveryEvent(unsigned char pid, unsigned char aid, unsigned char abnormal_temp, unsigned char recovery_temp, unsigned int recovery_volt_mv, rtc_time_t abnormal_time);  // 记录恢复事件
+static void RecordWarningEvent(unsigned char slave_idx, short temp_deci);  // 记录预警事件
+static void RecordRateRiseEvent(unsigned char slave_idx, short temp_deci, short rate);  // 记录升温速率事件
+static void DeleteWarningEvent(unsigned char display_index);  // 删除指定预警事件
 static void DeleteRecoveryEvent(unsigned char display_index);  // 删除指定恢复事件
 static void GetMaxTempRecords(short max_temps[], rtc_time_t max_temp_times[]);  // 获取前3高温度记录
 static void GetMaxTempRecords_Ext(short max_temps[], rtc_time_t max_temp_times[], unsigned char *pid, unsigned char *aid, unsigned short *volt_mv, DataRecord **target_record);  // 扩展：获取最高温及关联信息
@@ -176,6 +369,8 @@ static void GetMaxTempRecords_Ext(short max_temps[], rtc_time_t max_temp_times[]
 // RTC相关（RTC读取、编辑、保存）
 static void GetCurrentRTC(void);                   // 获取当前RTC时间
 static void UpdateRTCRefresh(void);                // 更新RTC刷新状态
+static void Blink_Restart(void);                    // 编辑位闪烁从"显示"重新开始
+static void Blink_OnTimer(void);                    // 闪烁定时器到期：翻转编辑位并重绘
 static void RTC_Edit_Init(void);                   // 初始化RTC编辑（进入选择状态）
 static void RTC_Switch_Pos(signed char step);      // 切换RTC编辑位置（上/下一位）
 static void RTC_Adjust_Num(signed char step);      // 调整RTC选中位置的数字（加/减）
@@ -231,6 +426,8 @@ void Menu_Init(void)
     menu_state.page24_selected = 0;
     menu_state.page25_selected = 0;
     menu_state.page26_selected = 0;
+    menu_state.page27_selected = 0;
+    menu_state.page28_selected = 0;
     
     // 报警状态跟踪数组初始化（默认所有从站正常）
     for (i = 0; i < TOTAL_SLAVES; i++)
@@ -267,24 +464,81 @@ void UART4_Init(unsigned long baudrate)
     T4T3M |= 0x20;  // 设置定时器4为UART4波特率发生器
     T4T3M &= ~0x10; // 定时器4设为1T模式
     
-    // 中断配置：开启UART4接收中断
+    // 中断配置：开启UART4中断（接收+发送，发送由环形缓冲区中断续发）
+    uart_tx_head = 0;
+    uart_tx_tail = 0;
+    uart_tx_busy = 0;
     IE2 |= 0x10;    // 开启UART4中断
     AUXR |= 0x80;   // STC32G专用：打开总中断开关
     
-    // 系统初始化：菜单、RTC、数据存储
+    // 系统初始化：软件定时器、菜单、RTC、数据存储
+    TimerWheel_Init();    // 须在InitDataStorage之前
     Menu_Init();
     rtc_init();
     rtc_check_and_init();  // 检查并初始化RTC时间
     InitDataStorage();    // 初始化数据存储缓冲区
+    NTC_CalibInit();      // 所有从站使用名义NTC参数
+    Threshold_Init();     // 所有从站使用默认预警/报警阈值
+    TimerWheel_Start(TMR_ID_RTC, TW_MS(RTC_REFRESH_MS));  // RTC每秒重新读取
+#if PERSIST_ENABLE
+#if NTC_CAL_ENABLE
+    NTC_CalibMount();     // 校准区有记录时恢复各从站校准参数
+#endif
+    Threshold_Mount();    // 阈值区有记录时恢复修改过的阈值
+    Rollup_Mount();       // 须在IapLog_Mount之前：回放的历史样本据此跳过已汇总的小时
+    History_Mount();      // 须在IapLog_Mount之前：回放的历史样本据此跳过已在历史区中的部分
+    IapLog_Mount();       // 回放EEPROM日志，恢复事件日志和历史数据
+    DayMax_Reopen();      // 须在IapLog_Mount之后：跨天日期和每日最高温记录均由回放恢复
+    if (LOG_ON(LOG_MOD_SYS, LOG_LEVEL_INFO)) {
+        UART4_SendString("EEPROM log: replayed=");
+        UART4_SendNumber(iap_log_replayed, 5);
+        UART4_SendString(", torn=");
+        UART4_SendNumber(iap_log_torn, 3);
+        UART4_SendString("\r\n");
+    }
+#endif
+    DayStat_CheckDay();   // 掉电期间跨天则先结束前一天，并安排零点检查
 }
 
 // ------------------- UART发送函数 -------------------
-// 发送1字节数据
+// 发送1字节数据：写入发送环形缓冲区后立即返回，由UART4发送中断逐字节发出
+// 发送器空闲时直接写S4BUF启动发送，之后每个发送完成中断取下一字节
 void UART4_SendByte(unsigned char dat)
 {
-    S4BUF = dat;
-    while (!(S4CON & 0x02));  // 等待发送完成
-    S4CON &= ~0x02;           // 清除发送完成标志
+    unsigned int next;
+    
+    next = (uart_tx_head + 1) & UART_TX_BUFF_MASK;
+    
+#if UART_TX_BLOCK_ON_FULL
+    while (next == uart_tx_tail);  // 缓冲区满：等待发送中断腾出空间
+#else
+    if (next == uart_tx_tail)      // 缓冲区满：丢弃该字节
+    {
+        LINK_STAT_INC(link_stats.tx_drops);
+        return;
+    }
+#endif
+    
+    // 只屏蔽UART4中断判断发送器状态，避免与发送中断同时修改uart_tx_busy；
+    // 不改动EA，调用者处于关总中断区间时不会被重新打开
+    IE2 &= ~0x10;
+    if (!uart_tx_busy)
+    {
+        uart_tx_busy = 1;
+        S4BUF = dat;
+    }
+    else
+    {
+        uart_tx_buff[uart_tx_head] = dat;
+        uart_tx_head = next;
+    }
+    IE2 |= 0x10;
+}
+
+// 等待发送缓冲区全部发出（复位、长时间关中断操作前调用，避免调试信息丢失）
+void UART4_FlushTx(void)
+{
+    while (uart_tx_busy);
 }
 
 // 发送字符串（以'\0'结尾）
@@ -317,6 +571,52 @@ void UART4_SendNumber(unsigned long num, unsigned char digits)
     }
 }
 
+// ------------------- 二进制遥测输出 -------------------
+// 组装一条固定长度遥测记录并写入发送缓冲区（格式见uart4.h"二进制遥测配置"）
+// 非二进制模式下直接返回；TELEMETRY_ENABLE为0时函数体为空
+void Telemetry_Emit(unsigned char type, unsigned char aid, unsigned char pid,
+                    short value1, unsigned int value2)
+{
+#if TELEMETRY_ENABLE
+    unsigned char rec[TELEMETRY_REC_LEN];
+    unsigned long tick;
+    unsigned char sum;
+    unsigned char i;
+    
+    if (telemetry_mode != TELEMETRY_MODE_BINARY)
+    {
+        return;
+    }
+    
+    tick = GetSystemTick();
+    
+    rec[0] = TELEMETRY_SYNC;
+    rec[1] = type;
+    rec[2] = aid;
+    rec[3] = pid;
+    rec[4] = (unsigned char)((unsigned int)value1 & 0xFF);
+    rec[5] = (unsigned char)((unsigned int)value1 >> 8);
+    rec[6] = (unsigned char)(value2 & 0xFF);
+    rec[7] = (unsigned char)(value2 >> 8);
+    rec[8] = (unsigned char)(tick & 0xFF);
+    rec[9] = (unsigned char)(tick >> 8);
+    rec[10] = (unsigned char)(tick >> 16);
+    rec[11] = (unsigned char)(tick >> 24);
+    
+    sum = 0;
+    for (i = 1; i < TELEMETRY_REC_LEN - 1; i++)
+    {
+        sum += rec[i];
+    }
+    rec[TELEMETRY_REC_LEN - 1] = sum;
+    
+    for (i = 0; i < TELEMETRY_REC_LEN; i++)
+    {
+        UART4_SendByte(rec[i]);
+    }
+#endif
+}
+
 // ------------------- 定时器0初始化(用于延时和系统滴答) -------------------
 void Timer0_Init(void)
 {
@@ -346,6 +646,25 @@ void Timer0_ISR(void) interrupt 1 {
     }
     
     SystemTick_Increment();
+    TimerWheel_IsrTick();  // 软件定时器节拍（回调在主循环中执行）
+    
+    // 字节间静默超时：总线静默超过3.5字符时间即视为帧边界，丢弃窗口中残留的不完整帧，
+    // 避免下一帧字节拼接到旧前缀上（关UART4中断，防止与接收中断同时修改窗口；
+    // 结束后恢复原来的ES4，被打断的UART4_SendByte正处于屏蔽区间时不能在这里打开）
+    if (uart_rx_idle_ms < 0xFF) {
+        uart_rx_idle_ms++;
+    }
+    if (uart_rx_len > 0 && uart_rx_idle_ms >= UART_FRAME_GAP_MS) {
+        unsigned char es4 = IE2 & 0x10;
+
+        IE2 &= ~0x10;
+        if (uart_rx_idle_ms >= UART_FRAME_GAP_MS) {
+            uart_rx_len = 0;
+            uart_rx_hunting = 0;  // 帧边界已由静默确定，下一帧重新开始同步
+            link_stats.gap_discards++;
+        }
+        IE2 |= es4;
+    }
     
     // 新增：每500ms触发一次PAGE_1全局刷新（1ms中断→500次计数）
    refresh_timer = 0;
@@ -357,6 +676,35 @@ void Timer0_ISR(void) interrupt 1 {
         }
     }
 }
+
+// ------------------- 软件定时器回调 -------------------
+// 主循环中由TimerWheel_Run调用，按ID分配（uart4.h"软件定时器分配"）分发
+void TimerWheel_OnExpire(unsigned char id)
+{
+    if (id < TOTAL_SLAVES)
+    {
+        HistLog_OnTimer(id);
+    }
+    else if (id < 2 * TOTAL_SLAVES)
+    {
+        Live_OnTimeout(id - TOTAL_SLAVES);
+    }
+    else if (id == TMR_ID_BLINK)
+    {
+        Blink_OnTimer();
+    }
+    else if (id == TMR_ID_RTC)
+    {
+        GetCurrentRTC();      // 缓存时钟：样本和事件的时间直接取current_rtc_time
+        need_rtc_refresh = 1;
+        TimerWheel_Start(TMR_ID_RTC, TW_MS(RTC_REFRESH_MS));
+    }
+    else if (id == TMR_ID_MIDNIGHT)
+    {
+        DayStat_CheckDay();
+    }
+}
+
 // ------------------- 清空缓冲区 -------------------
 static void UART4_ClearBuffer(unsigned char *ptr, unsigned int len)
 {
@@ -376,12 +724,95 @@ static bit Protocol_Check(unsigned char *frame)
     return (fcs == frame[5]) ? 1 : 0;  // 校验通过返回1，否则返回0
 }
 
+#if NTC_USE_LUT
+// NTC温度查表（由tools/ntc_lut_gen.c按B值公式生成，单位0.01℃，节点k对应ADC码k*16）
+// 全部4096个ADC码插值结果与B值公式误差不超过0.1℃，有效区间与公式完全一致
+#define NTC_LUT_FIRST       6     // 首节点序号（ADC码 >> NTC_LUT_SHIFT）
+#define NTC_LUT_SIZE        243   // 节点数
+#define NTC_ADC_VALID_MIN   100   // 最小有效ADC码（对应-40℃）
+#define NTC_ADC_VALID_MAX   3954  // 最大有效ADC码（对应125℃）
+static short code ntc_temp_lut[NTC_LUT_SIZE] = {
+     -4050,  -3831,  -3637,  -3463,  -3304,  -3159,  -3023,  -2897,  -2778,  -2666,
+     -2560,  -2459,  -2363,  -2271,  -2182,  -2097,  -2015,  -1936,  -1859,  -1785,
+     -1713,  -1643,  -1575,  -1508,  -1443,  -1380,  -1318,  -1258,  -1199,  -1141,
+     -1084,  -1028,   -973,   -920,   -867,   -815,   -763,   -713,   -663,   -614,
+      -566,   -518,   -471,   -425,   -379,   -333,   -288,   -244,   -200,   -157,
+      -114,    -71,    -29,     13,     54,     96,    136,    177,    217,    257,
+       296,    336,    375,    413,    452,    490,    528,    566,    604,    641,
+       678,    715,    752,    789,    825,    862,    898,    934,    970,   1006,
+      1041,   1077,   1113,   1148,   1183,   1218,   1253,   1288,   1323,   1358,
+      1393,   1428,   1463,   1497,   1532,   1566,   1601,   1635,   1670,   1704,
+      1739,   1773,   1807,   1842,   1876,   1911,   1945,   1979,   2014,   2048,
+      2083,   2117,   2152,   2186,   2221,   2256,   2290,   2325,   2360,   2395,
+      2430,   2465,   2500,   2535,   2570,   2606,   2641,   2677,   2713,   2748,
+      2784,   2820,   2857,   2893,   2929,   2966,   3003,   3039,   3077,   3114,
+      3151,   3189,   3226,   3264,   3302,   3341,   3379,   3418,   3457,   3496,
+      3536,   3575,   3615,   3655,   3696,   3736,   3777,   3819,   3860,   3902,
+      3944,   3987,   4030,   4073,   4117,   4161,   4205,   4250,   4295,   4341,
+      4387,   4433,   4480,   4528,   4575,   4624,   4673,   4722,   4772,   4823,
+      4874,   4926,   4979,   5032,   5086,   5141,   5196,   5252,   5309,   5367,
+      5425,   5485,   5545,   5607,   5669,   5733,   5797,   5863,   5930,   5998,
+      6068,   6138,   6211,   6284,   6360,   6437,   6515,   6596,   6678,   6762,
+      6849,   6937,   7028,   7122,   7218,   7317,   7419,   7525,   7633,   7745,
+      7862,   7982,   8107,   8237,   8372,   8513,   8661,   8815,   8977,   9147,
+      9326,   9516,   9717,   9931,  10160,  10406,  10671,  10959,  11274,  11620,
+     12006,  12439,  12932,
+};
+
+// ADC值转换为温度（查表+定点线性插值，结果放大10倍保留1位小数）
+// aid在1~TOTAL_SLAVES且已校准时，再按该从站修正表插值修正（整数运算）
+static short ADC_To_Temp(unsigned int adc_val, unsigned char aid)
+{
+    unsigned char idx;      // 节点下标
+    unsigned char frac;     // 节点间偏移（0~15）
+    short t0;               // 左节点温度（0.01℃）
+    short temp_centi;       // 插值温度（0.01℃）
+    unsigned int cal_pos;   // 在修正表中的位置（0.01℃，相对NTC_CAL_BASE）
+    short *corr;            // 该从站修正表
+    
+    // 无效ADC值及超出-40℃~125℃的ADC码（由生成器按公式确定）
+    if (adc_val < NTC_ADC_VALID_MIN || adc_val > NTC_ADC_VALID_MAX)
+    {
+        return -990;
+    }
+    
+    idx = (unsigned char)((adc_val >> NTC_LUT_SHIFT) - NTC_LUT_FIRST);
+    frac = (unsigned char)(adc_val & ((1 << NTC_LUT_SHIFT) - 1));
+    t0 = ntc_temp_lut[idx];
+    
+    // 节点温度单调递增，差值×偏移不超过16位无符号范围
+    temp_centi = t0 + (short)(((unsigned int)(ntc_temp_lut[idx + 1] - t0) * frac) >> NTC_LUT_SHIFT);
+    
+    // 单传感器校准修正（插值结果可能略低于-40.00℃，按首节点处理）
+    if (aid >= 1 && aid <= TOTAL_SLAVES && ntc_cal_active[aid - 1])
+    {
+        corr = ntc_cal_corr[aid - 1];
+        cal_pos = (temp_centi > NTC_CAL_BASE) ? (unsigned int)(temp_centi - NTC_CAL_BASE) : 0;
+        idx = (unsigned char)(cal_pos >> NTC_CAL_SHIFT);
+        cal_pos &= (1 << NTC_CAL_SHIFT) - 1;
+        temp_centi += corr[idx] + (short)(((long)(corr[idx + 1] - corr[idx]) * cal_pos) >> NTC_CAL_SHIFT);
+    }
+    
+    return (short)((temp_centi + 5) / 10);  // 0.01℃→0.1℃，四舍五入（与公式版取整方式一致）
+}
+#else
 // ADC值转换为温度（NTC传感器，B值法，结果放大10倍保留1位小数）
-static short ADC_To_Temp(unsigned int adc_val)
+// aid在1~TOTAL_SLAVES时使用该从站的B值、25℃阻值和偏移
+static short ADC_To_Temp(unsigned int adc_val, unsigned char aid)
 {
     double Rntc;    // NTC电阻值
     double temp_k;  // 开尔文温度
     double temp_c;  // 摄氏度温度
+    double r0 = (double)NTC_R0;
+    double b_value = NTC_B_VALUE;
+    short offset_centi = 0;
+    
+    if (aid >= 1 && aid <= TOTAL_SLAVES)
+    {
+        r0 = (double)ntc_calib[aid - 1].r0_10ohm * 10.0;
+        b_value = (double)ntc_calib[aid - 1].b_value;
+        offset_centi = ntc_calib[aid - 1].offset_centi;
+    }
     
     // 无效ADC值判断（0或≥4096为无效）
     if (adc_val == 0 || adc_val >= 4096)
@@ -393,7 +824,7 @@ static short ADC_To_Temp(unsigned int adc_val)
     Rntc = (4096.0 * (double)NTC_R_REF) / (double)adc_val - (double)NTC_R_REF;
     
     // 计算温度：开尔文→摄氏度（B值公式：1/T = 1/T0 + (ln(Rntc/R0))/B）
-    temp_k = 1.0 / (log(Rntc / (double)NTC_R0) / NTC_B_VALUE + 1.0 / NTC_T0);
+    temp_k = 1.0 / (log(Rntc / r0) / b_value + 1.0 / NTC_T0);
     temp_c = temp_k - 273.15;
     
     // 温度范围校验（-40℃~125℃）
@@ -402,300 +833,1814 @@ static short ADC_To_Temp(unsigned int adc_val)
         return -990;  // 超出范围返回无效值
     }
     
+    temp_c += (double)offset_centi / 100.0;
+    
     return (short)(temp_c * 10.0 + 0.5);  // 保留1位小数，四舍五入
 }
+#endif
 
-// 解析6字节协议帧数据
-static void Protocol_Parse(unsigned char *frame)
+// ------------------- NTC单传感器校准 -------------------
+// 所有从站恢复名义参数（NTC_B_VALUE/NTC_R0，无偏移）
+void NTC_CalibInit(void)
 {
-    unsigned int adc_val;  // 解析后的ADC值
+    unsigned char i;
     
-    // 提取协议帧字段
-    parsed_data.PID = frame[0];          // 从站ID
-    parsed_data.AID = frame[1];          // 区域ID
-    adc_val = ((frame[3] & 0x0F) << 8) | frame[2];  // ADC值（12位：frame3低4位+frame2）
-    parsed_data.ADC_Value = adc_val;     // 存储ADC原始值
-    parsed_data.Bat_Voltage = (float)frame[4] / 10.0f;  // 电池电压（frame4为0.1V单位）
-    parsed_data.Check_OK = Protocol_Check(frame) ? 1 : 0;  // FCS校验结果
-    parsed_data.temperature = ADC_To_Temp(adc_val);     // ADC值转换为温度
-}
-
-// 温度短整型转换为字符型（取整数部分，无效值返回0）
-static unsigned char TempShortToChar(short temp)
-{
-    if (temp == -990)
+    for (i = 0; i < TOTAL_SLAVES; i++)
     {
-        return 0;  // 无效温度返回0
+        ntc_calib[i].b_value = (unsigned int)NTC_B_VALUE;
+        ntc_calib[i].r0_10ohm = (unsigned int)(NTC_R0 / 10);
+        ntc_calib[i].offset_centi = 0;
+        NTC_CalibApply(i + 1);
     }
-    return (unsigned char)(abs(temp) / 10);  // 取绝对值后除以10，得到整数部分
+    ntc_cal_stage_aid = 0;
 }
 
-// ------------------- 数据存储相关函数 -------------------
-// 根据AID获取从站数据（仅返回有效数据）
-static DataRecord* GetFixedSlaveData(unsigned char aid)
+// 按ntc_calib重新计算指定从站修正表（仅在校准变化时调用，浮点运算不在逐帧路径上）
+// 修正量 = 该从站参数下的温度 - 名义参数下的温度，在名义曲线的各节点温度处计算：
+//   ln(R/R0名义) = B名义 × (1/T名义 - 1/T0)
+//   1/T校准 = 1/T0 + (ln(R/R0名义) + ln(R0名义/R0校准)) / B校准
+void NTC_CalibApply(unsigned char aid)
 {
-    unsigned char idx;  // 从站索引（AID-1）
+    NTC_Calib *cal;
+#if NTC_CAL_ENABLE
+    unsigned char i;
+    float t_nom;       // 节点名义温度（℃）
+    float ln_r;        // ln(R/R0名义)
+    float t_cal;       // 校准后温度（℃）
+    float ln_r0;       // ln(R0名义/R0校准)
+#endif
     
-    // AID有效性校验（1~TOTAL_SLAVES）
     if (aid < 1 || aid > TOTAL_SLAVES)
     {
-        return NULL;
+        return;
     }
+    cal = &ntc_calib[aid - 1];
     
-    idx = aid - 1;
-    // 数据有效则返回指针，否则返回NULL
-    if (data_summary[idx].is_valid)
+    // 名义参数：关闭修正，逐帧路径直接返回查表结果
+    if (cal->b_value == (unsigned int)NTC_B_VALUE && 
+        cal->r0_10ohm == (unsigned int)(NTC_R0 / 10) && 
+        cal->offset_centi == 0)
     {
-        return &data_summary[idx];
+        ntc_cal_active[aid - 1] = 0;
+        return;
     }
     
-    return NULL;
+#if NTC_CAL_ENABLE
+    ln_r0 = log((float)NTC_R0 / ((float)cal->r0_10ohm * 10.0f));
+    for (i = 0; i < NTC_CAL_KNOTS; i++)
+    {
+        t_nom = (float)(NTC_CAL_BASE + ((long)i << NTC_CAL_SHIFT)) / 100.0f;
+        ln_r = NTC_B_VALUE * (1.0f / (t_nom + 273.15f) - 1.0f / NTC_T0);
+        t_cal = 1.0f / (1.0f / NTC_T0 + (ln_r + ln_r0) / (float)cal->b_value) - 273.15f;
+        ntc_cal_corr[aid - 1][i] = (short)((t_cal - t_nom) * 100.0f + ((t_cal >= t_nom) ? 0.5f : -0.5f))
+                                   + cal->offset_centi;
+    }
+    ntc_cal_active[aid - 1] = 1;
+#else
+    ntc_cal_active[aid - 1] = 0;  // 未编译校准功能：始终使用名义曲线
+#endif
 }
 
-// 初始化数据存储缓冲区（清0所有记录和索引）
-void InitDataStorage(void)
+#if NTC_CAL_ENABLE
+// 全部从站校准参数写为校准区一条记录（只在串口应用/恢复校准时调用）
+static void NTC_CalibSave(void)
 {
-    unsigned char i, j;
-    unsigned char aid;
-    unsigned short start_pos;
-    
-    // 初始化数据摘要存储（所有记录清0）
-    for (i = 0; i < TOTAL_RECORDS; i++)
-    {
-        data_summary[i].is_valid = 0;
-        data_summary[i].timestamp = 0;
-        data_summary[i].save_time.year = 0;    // 初始化RTC保存时间
-        data_summary[i].save_time.mon = 0;
-        data_summary[i].save_time.day = 0;
-        data_summary[i].save_time.hour = 0;
-        data_summary[i].save_time.min = 0;
-        data_summary[i].save_time.sec = 0;
-        data_summary[i].aid = 0;
-        data_summary[i].pid = 0;
-        data_summary[i].temp = 0;
-        data_summary[i].volt1 = 0;
-        data_summary[i].volt2 = 0;
-        data_summary[i].fosc = 0;
-    }
-    
-    // 初始化从站AID（实时数据区）
-    for (i = 0; i < TOTAL_SLAVES; i++)
+#if PERSIST_ENABLE
+    IapArea_Begin(&ntc_cal_area);
+    IapArea_Put(&ntc_cal_area, (unsigned char *)ntc_calib, NTC_CAL_AREA_REC_LEN);
+    IapArea_Commit(&ntc_cal_area);
+#endif
+}
+
+#if PERSIST_ENABLE
+// 挂载校准区，最新一条记录覆盖NTC_CalibInit设置的名义参数并重新计算修正表（无记录时保持名义参数）
+static void NTC_CalibMount(void)
+{
+    IapAreaIter it;
+    unsigned char found = 0;
+    unsigned char i;
+    
+    ntc_cal_area.first = NTC_CAL_AREA_FIRST;
+    ntc_cal_area.sectors = NTC_CAL_AREA_SECTORS;
+    ntc_cal_area.rec_len = NTC_CAL_AREA_REC_LEN;
+    ntc_cal_area.aux_len = 0;
+    IapArea_Mount(&ntc_cal_area);
+    
+    IapArea_IterBegin(&ntc_cal_area, &it);
+    while (IapArea_Next(&ntc_cal_area, &it))
     {
-        data_summary[i].aid = i + 1;
+        found = 1;
     }
-    
-    // 初始化历史数据存储区AID
-    for (i = 0; i < TOTAL_SLAVES; i++)
+    if (found)
     {
-        aid = i + 1;
-        start_pos = HISTORY_DATA_START + (i * RECORDS_PER_SLAVE);
-        
-        for (j = 0; j < RECORDS_PER_SLAVE; j++)
+        IapArea_Read(&it, 0, (unsigned char *)ntc_calib, NTC_CAL_AREA_REC_LEN);
+        for (i = 1; i <= TOTAL_SLAVES; i++)
         {
-            data_summary[start_pos + j].aid = aid;
+            NTC_CalibApply(i);
         }
     }
-    
-    // 初始化历史索引（所有从站从0开始）
-    for (i = 0; i < TOTAL_SLAVES; i++)
+}
+#endif
+
+// 输出指定从站校准参数：TXnn B=xxxx R0=xxxxx0 OFS=±xxxx
+static void NTC_CalibDump(unsigned char aid)
+{
+    NTC_Calib *cal = &ntc_calib[aid - 1];
+    
+    UART4_SendString("TX");
+    UART4_SendNumber(aid, 2);
+    UART4_SendString(" B=");
+    UART4_SendNumber(cal->b_value, 5);
+    UART4_SendString(" R0=");
+    UART4_SendNumber((unsigned long)cal->r0_10ohm * 10, 6);
+    UART4_SendString(" OFS=");
+    if (cal->offset_centi < 0)
     {
-        history_index[i] = 0;
+        UART4_SendString("-");
+        UART4_SendNumber((unsigned long)(-cal->offset_centi), 4);
     }
-    
-    // 初始化报警事件数组（所有事件标记为无效）
-    for (i = 0; i < MAX_ALARM_EVENTS; i++)
+    else
     {
-        alarm_events[i].is_valid = 0;
-        alarm_events[i].pid = 0;
-        alarm_events[i].aid = 0;
-        alarm_events[i].temp = 0;
-        alarm_events[i].volt_mv = 0;
+        UART4_SendString("+");
+        UART4_SendNumber((unsigned long)cal->offset_centi, 4);
     }
-    alarm_event_count = 0;
-    alarm_event_next_index = 0;
+    UART4_SendString("\r\n");
+}
+
+// 处理NTC校准命令（frame[2]=命令字，frame[3]/frame[4]=参数低/高字节）
+static void NTC_CalibCommand(unsigned char *frame)
+{
+    unsigned int value = frame[3] | ((unsigned int)frame[4] << 8);
+    unsigned char i;
     
-    // 初始化报警状态跟踪数组（所有从站正常）
-    for (i = 0; i < TOTAL_SLAVES; i++)
+    switch (frame[2])
     {
-        last_abnormal_status[i] = 0;
+        case UART_CMD_CAL_SELECT:
+            if (frame[3] < 1 || frame[3] > TOTAL_SLAVES)
+            {
+                UART4_SendString("CAL: invalid AID\r\n");
+                return;
+            }
+            ntc_cal_stage_aid = frame[3];
+            ntc_cal_stage = ntc_calib[frame[3] - 1];
+            break;
+            
+        case UART_CMD_CAL_SET_B:
+        case UART_CMD_CAL_SET_R0:
+        case UART_CMD_CAL_SET_OFFSET:
+        case UART_CMD_CAL_APPLY:
+            if (ntc_cal_stage_aid == 0)
+            {
+                UART4_SendString("CAL: no AID selected\r\n");
+                return;
+            }
+            if (frame[2] == UART_CMD_CAL_SET_B)
+            {
+                ntc_cal_stage.b_value = value;
+            }
+            else if (frame[2] == UART_CMD_CAL_SET_R0)
+            {
+                ntc_cal_stage.r0_10ohm = value;
+            }
+            else if (frame[2] == UART_CMD_CAL_SET_OFFSET)
+            {
+                ntc_cal_stage.offset_centi = (short)value;
+            }
+            else
+            {
+                // B值或阻值为0时公式无意义，拒绝应用
+                if (ntc_cal_stage.b_value == 0 || ntc_cal_stage.r0_10ohm == 0)
+                {
+                    UART4_SendString("CAL: invalid B/R0\r\n");
+                    return;
+                }
+                ntc_calib[ntc_cal_stage_aid - 1] = ntc_cal_stage;
+                NTC_CalibApply(ntc_cal_stage_aid);
+                NTC_CalibSave();
+                UART4_SendString("CAL applied: ");
+                NTC_CalibDump(ntc_cal_stage_aid);
+                return;
+            }
+            break;
+            
+        case UART_CMD_CAL_RESET:
+            for (i = 1; i <= TOTAL_SLAVES; i++)
+            {
+                if (frame[3] == 0 || frame[3] == i)
+                {
+                    ntc_calib[i - 1].b_value = (unsigned int)NTC_B_VALUE;
+                    ntc_calib[i - 1].r0_10ohm = (unsigned int)(NTC_R0 / 10);
+                    ntc_calib[i - 1].offset_centi = 0;
+                    NTC_CalibApply(i);
+                }
+            }
+            NTC_CalibSave();
+            ntc_cal_stage_aid = 0;
+            UART4_SendString("CAL reset.\r\n");
+            return;
+            
+        case UART_CMD_CAL_DUMP:
+            for (i = 1; i <= TOTAL_SLAVES; i++)
+            {
+                if (frame[3] == i || (frame[3] == 0 && ntc_cal_active[i - 1]))
+                {
+                    NTC_CalibDump(i);
+                }
+            }
+            return;
+            
+        default:
+            return;
     }
     
-    // 初始化恢复事件数组（所有事件标记为无效）
-    for (i = 0; i < MAX_RECOVERY_EVENTS; i++)
+    UART4_SendString("CAL ok.\r\n");
+}
+#endif
+
+// ------------------- 预警/报警阈值 -------------------
+// 所有从站恢复默认阈值
+void Threshold_Init(void)
+{
+    unsigned char i;
+    
+    for (i = 0; i < TOTAL_SLAVES; i++)
     {
-        recovery_events[i].is_valid = 0;
-        recovery_events[i].pid = 0;
-        recovery_events[i].aid = 0;
-        recovery_events[i].abnormal_temp = 0;
-        recovery_events[i].recovery_temp = 0;
-        recovery_events[i].recovery_volt_mv = 0;
-    }
-    recovery_event_count = 0;
-    recovery_event_next_index = 0;
+        slave_thr[i].warn_c = THR_WARN_C_DEFAULT;
+        slave_thr[i].alarm_c = THR_ALARM_C_DEFAULT;
+        slave_thr[i].hyst_deci = THR_HYST_DECI_DEFAULT;
+        slave_thr[i].dwell_set_s = THR_DWELL_SET_S_DEFAULT;
+        slave_thr[i].dwell_clr_s = THR_DWELL_CLR_S_DEFAULT;
+        slave_thr[i].ror_limit = THR_ROR_LIMIT_DEFAULT;
+    }
+    thr_sel_aid = 0;
+}
+
+// 全部从站阈值写为阈值区一条记录（只在串口修改阈值时调用）
+static void Threshold_Save(void)
+{
+#if PERSIST_ENABLE
+    IapArea_Begin(&thr_area);
+    IapArea_Put(&thr_area, (unsigned char *)slave_thr, THR_AREA_REC_LEN);
+    IapArea_Commit(&thr_area);
+#endif
+}
+
+#if PERSIST_ENABLE
+// 挂载阈值区，最新一条记录覆盖Threshold_Init设置的默认值（无记录时保持默认值）
+static void Threshold_Mount(void)
+{
+    IapAreaIter it;
+    unsigned char found = 0;
     
-    // 初始化PAGE_19自动记录数组（所有记录标记为无效）
-    for (i = 0; i < 3; i++)
+    thr_area.first = THR_AREA_FIRST;
+    thr_area.sectors = THR_AREA_SECTORS;
+    thr_area.rec_len = THR_AREA_REC_LEN;
+    thr_area.aux_len = 0;
+    IapArea_Mount(&thr_area);
+    
+    IapArea_IterBegin(&thr_area, &it);
+    while (IapArea_Next(&thr_area, &it))
     {
-        for (j = 0; j < 4; j++)
-        {
-            page19_auto_records[i][j].is_valid = 0;
-        }
-        page19_record_index[i] = 0;
-        page19_last_read_time[i] = 0;
+        found = 1;
     }
-    
-    // 初始化从站上次保存时间（10分钟间隔计时）
-    for (i = 0; i < TOTAL_SLAVES; i++)
+    if (found)
     {
-        last_save_time[i] = 0;
+        IapArea_Read(&it, 0, (unsigned char *)slave_thr, THR_AREA_REC_LEN);
     }
-    
-    // 清空UART接收缓冲区
-    UART4_ClearBuffer(uart_rx_buff, UART_BUFF_SIZE);
-    uart_rx_len = 0;
-    uart_rx_complete = 0;
 }
+#endif
 
-// 添加数据到摘要存储（实时数据+历史数据）
-void AddDataToSummary(unsigned char pid, unsigned char aid, 
-                     unsigned char temp, unsigned char volt1,
-                     unsigned char volt2, unsigned char fosc)
+// 按从站阈值更新温度级别（新样本已写入rt_xxx）：当前级别决定退出点（阈值-回差），
+// 判断结果与当前级别不同时须持续驻留时间才生效，期间回到当前级别或变为另一级别则重新计时
+static void Threshold_Update(unsigned char slave_idx, short temp_deci)
 {
-    unsigned char slave_idx;    // 从站索引（AID-1）
-    unsigned long current_time; // 当前系统时间（毫秒）
-    DataRecord *recent_rec;     // 实时数据指针
-    unsigned short hist_start;  // 历史数据存储起始位置
-    unsigned char hist_idx;     // 历史数据索引
-    unsigned short hist_pos;    // 历史数据存储位置
-    unsigned char dev_id_buf[8]; // 设备ID字符串缓冲区
-    unsigned char i;            // 循环变量
-    DataRecord *hist_rec;       // 历史数据指针
+    SlaveThreshold *thr = &slave_thr[slave_idx];
+    unsigned char level = rt_level[slave_idx];
+    unsigned char target;
+    unsigned char dwell_s;
+    unsigned int now = (unsigned int)TimerWheel_Now();
+    short alarm_deci = (short)thr->alarm_c * 10;
+    short warn_deci = (short)thr->warn_c * 10;
+    
+    if (temp_deci > alarm_deci ||
+        (level == TEMP_LEVEL_ALARM && temp_deci > alarm_deci - thr->hyst_deci))
+    {
+        target = TEMP_LEVEL_ALARM;
+    }
+    else if (temp_deci > warn_deci ||
+             (level != TEMP_LEVEL_NORMAL && temp_deci > warn_deci - thr->hyst_deci))
+    {
+        target = TEMP_LEVEL_WARN;
+    }
+    else
+    {
+        target = TEMP_LEVEL_NORMAL;
+    }
     
-    // 无效数据过滤（所有字段为0则跳过）
-    if (pid == 0 && aid == 0 && temp == 0 && 
-        volt1 == 0 && volt2 == 0 && fosc == 0)
+    if (target == level)
     {
+        thr_pending[slave_idx] = level;
         return;
     }
-    
-    // 从站AID校验（1~TOTAL_SLAVES）
-    if (aid < 1 || aid > TOTAL_SLAVES)
+    if (target != thr_pending[slave_idx])
+    {
+        thr_pending[slave_idx] = target;
+        thr_since[slave_idx] = now;
+    }
+    dwell_s = (target > level) ? thr->dwell_set_s : thr->dwell_clr_s;
+    if ((unsigned int)(now - thr_since[slave_idx]) < TW_SEC(dwell_s))
     {
         return;
     }
     
-    slave_idx = aid - 1;
-    current_time = GetSystemTick();
-    recent_rec = &data_summary[slave_idx];
-    
-    // 10分钟间隔判断：满足条件则写入历史数据
-    if (last_save_time[slave_idx] == 0 || 
-        (current_time - last_save_time[slave_idx]) >= 600000)  // 600000ms=10分钟
+    rt_level[slave_idx] = target;
+    if (target == TEMP_LEVEL_ALARM)
     {
-        last_save_time[slave_idx] = current_time;
-        
-        // 实时数据有效则复制到历史记录
-        if (recent_rec->is_valid)
-        {
-            hist_start = HISTORY_DATA_START + (slave_idx * RECORDS_PER_SLAVE);
-            hist_idx = history_index[slave_idx];
-            hist_pos = hist_start + hist_idx;
-            hist_rec = &data_summary[hist_pos];
-            
-            // 复制实时数据到历史记录
-            hist_rec->pid = recent_rec->pid;
-            hist_rec->aid = recent_rec->aid;
-            hist_rec->temp = recent_rec->temp;
-            hist_rec->volt1 = recent_rec->volt1;
-            hist_rec->volt2 = recent_rec->volt2;
-            hist_rec->fosc = recent_rec->fosc;
-            GetCurrentRTC();  // 更新当前RTC时间
-            hist_rec->save_time = current_rtc_time;  // 保存RTC时间戳
-            hist_rec->timestamp = current_time;
-            hist_rec->is_valid = 1;
-            
-            // 更新历史索引（循环覆盖）
-            history_index[slave_idx] = (hist_idx + 1) % RECORDS_PER_SLAVE;
-        }
+        RT_BIT_SET(rt_abnormal_map, slave_idx);
     }
-    
-    // 更新当前实时数据
-    recent_rec->pid = parsed_data.PID;
-    recent_rec->aid = parsed_data.AID;
-    recent_rec->temp = TempShortToChar(parsed_data.temperature);
-    recent_rec->volt1 = (unsigned char)(parsed_data.Bat_Voltage * 10);
-    recent_rec->volt2 = 0;
-    recent_rec->fosc = 0;
-    recent_rec->timestamp = current_time;
-    recent_rec->is_valid = parsed_data.Check_OK ? 1 : 0;
-    
-    // 仅在PAGE_1时局部刷新显示（优化性能）
-    if (menu_state.current_page == PAGE_1)
-    {
-        for (i = 0; i < 2; i++)
-        {
-            unsigned char dev_idx = page1_scroll_idx + i;  // 当前显示的从站索引
-            unsigned char row = (i == 0) ? 2 : 4;          // 显示行（第2行、第4行）
-            Page1_DevInfo* dev = &page1_devices[dev_idx];
-            
-            // 匹配当前更新数据的从站AID，仅刷新对应项
-            if (dev->aid == aid)
-            {
-                // 刷新设备ID
-                dev_id_buf[0] = '0';
-                dev_id_buf[1] = '1';
-                dev_id_buf[2] = 'T';
-                dev_id_buf[3] = 'X';
-                dev_id_buf[4] = '0' + ((dev_idx + 1) / 10);
-                dev_id_buf[5] = '0' + ((dev_idx + 1) % 10);
-                dev_id_buf[6] = '\0';
-                LCD_DisplayString(row, 8, dev_id_buf);
-                
-                // 刷新温度显示（有效则显示数值，否则显示"--"）
-                if (recent_rec->is_valid)
-                {
-                    LCD_DisplayNumber(row, 64, (unsigned long)recent_rec->temp, 2);
-                }
-                else
-                {
-                    LCD_DisplayString(row, 64, (unsigned char*)"--");
-                }
-                
-                // 刷新电压显示（mV，有效则显示数值，否则显示"----"）
-                if (recent_rec->is_valid)
+    else
+    {
+        RT_BIT_CLR(rt_abnormal_map, slave_idx);
+    }
+    if (level == TEMP_LEVEL_NORMAL)
+    {
+        RecordWarningEvent(slave_idx, temp_deci);
+    }
+}
+
+// ------------------- 升温速率检测 -------------------
+static void RateRise_Reset(unsigned char slave_idx)
+{
+    ror_ref_temp[slave_idx] = -990;
+    ror_ema[slave_idx] = 0;
+    if (RT_BIT_TEST(ror_fired_map, slave_idx))
+    {
+        RT_BIT_CLR(ror_fired_map, slave_idx);
+        live_changed = 1;  // PAGE_4去掉该从站
+    }
+}
+
+// 有效样本到达时调用：间隔不足ROR_MIN_DT_S保留原参考样本，累计到足够温差后再计算，
+// 避免相邻帧0.1℃的量化跳变被放大成很大的速率
+static void RateRise_Update(unsigned char slave_idx, short temp_deci)
+{
+    unsigned int now = (unsigned int)TimerWheel_Now();
+    unsigned int dt = now - ror_ref_tick[slave_idx];
+    long rate;
+    short avg;
+    unsigned char limit = slave_thr[slave_idx].ror_limit;
+    
+    if (ror_ref_temp[slave_idx] == -990 || dt > TW_SEC(ROR_MAX_GAP_S))
+    {
+        RateRise_Reset(slave_idx);
+        ror_ref_temp[slave_idx] = temp_deci;
+        ror_ref_tick[slave_idx] = now;
+        return;
+    }
+    if (dt < TW_SEC(ROR_MIN_DT_S))
+    {
+        return;
+    }
+    
+    // 速率（0.1℃/分钟）=温差×每分钟节拍数/间隔节拍数
+    rate = (long)(temp_deci - ror_ref_temp[slave_idx]) * (long)TW_SEC(60) / (long)dt;
+    if (rate > ROR_RATE_CLAMP)
+    {
+        rate = ROR_RATE_CLAMP;
+    }
+    else if (rate < -ROR_RATE_CLAMP)
+    {
+        rate = -ROR_RATE_CLAMP;
+    }
+    ror_ema[slave_idx] += (short)(((short)rate * (1 << ROR_EMA_Q) - ror_ema[slave_idx]) / (1 << ROR_EMA_SHIFT));
+    ror_ref_temp[slave_idx] = temp_deci;
+    ror_ref_tick[slave_idx] = now;
+    
+    avg = ror_ema[slave_idx] / (1 << ROR_EMA_Q);
+    if (RT_BIT_TEST(ror_fired_map, slave_idx))
+    {
+        if (avg <= (short)(limit / 2))
+        {
+            RT_BIT_CLR(ror_fired_map, slave_idx);
+            live_changed = 1;  // PAGE_4去掉该从站
+        }
+        return;
+    }
+    if (limit == 0 || avg <= (short)limit)
+    {
+        return;
+    }
+    
+    RT_BIT_SET(ror_fired_map, slave_idx);
+    live_changed = 1;  // PAGE_4标出该从站
+    RecordRateRiseEvent(slave_idx, temp_deci, avg);
+}
+
+// 输出指定从站阈值（AID 1~TOTAL_SLAVES）
+static void Threshold_Dump(unsigned char aid)
+{
+    SlaveThreshold *thr = &slave_thr[aid - 1];
+    
+    UART4_SendString("THR AID=");
+    UART4_SendNumber(aid, 2);
+    UART4_SendString(" WARN=");
+    UART4_SendNumber(thr->warn_c, 3);
+    UART4_SendString(" ALARM=");
+    UART4_SendNumber(thr->alarm_c, 3);
+    UART4_SendString(" HYST=");
+    UART4_SendNumber(thr->hyst_deci, 3);
+    UART4_SendString(" DWELL=");
+    UART4_SendNumber(thr->dwell_set_s, 3);
+    UART4_SendString("/");
+    UART4_SendNumber(thr->dwell_clr_s, 3);
+    UART4_SendString(" ROR=");
+    UART4_SendNumber(thr->ror_limit, 3);
+    UART4_SendString(" LEVEL=");
+    UART4_SendNumber(rt_level[aid - 1], 1);
+    UART4_SendString("\r\n");
+}
+
+// 处理阈值命令（frame[2]=命令字，frame[3]/frame[4]=参数）
+static void Threshold_Command(unsigned char *frame)
+{
+    unsigned char i;
+    
+    switch (frame[2])
+    {
+        case UART_CMD_THR_SELECT:
+            if (frame[3] > TOTAL_SLAVES)
+            {
+                UART4_SendString("THR: invalid AID\r\n");
+                return;
+            }
+            thr_sel_aid = frame[3];
+            break;
+            
+        case UART_CMD_THR_SET:
+            if (frame[3] >= THR_FIELD_COUNT)
+            {
+                UART4_SendString("THR: invalid field\r\n");
+                return;
+            }
+            for (i = 1; i <= TOTAL_SLAVES; i++)
+            {
+                if (thr_sel_aid == 0 || thr_sel_aid == i)
                 {
-                    unsigned int volt_mv = recent_rec->volt1 * 100;
-                    LCD_DisplayNumber(row, 88, (unsigned long)volt_mv, 4);
+                    ((unsigned char *)&slave_thr[i - 1])[frame[3]] = frame[4];
                 }
-                else
+            }
+            Threshold_Save();
+            if (thr_sel_aid != 0)
+            {
+                Threshold_Dump(thr_sel_aid);
+                return;
+            }
+            break;
+            
+        case UART_CMD_THR_DUMP:
+            for (i = 1; i <= TOTAL_SLAVES; i++)
+            {
+                if (frame[3] == 0 || frame[3] == i)
                 {
-                    LCD_DisplayString(row, 88, (unsigned char*)"----");
+                    Threshold_Dump(i);
                 }
             }
+            return;
+            
+        default:
+            return;
+    }
+    
+    UART4_SendString("THR ok.\r\n");
+}
+
+// 解析6字节协议帧数据
+static void Protocol_Parse(unsigned char *frame)
+{
+    unsigned int adc_val;  // 解析后的ADC值
+    
+    // 提取协议帧字段
+    parsed_data.PID = frame[0];          // 从站ID
+    parsed_data.AID = frame[1];          // 区域ID
+    adc_val = ((frame[3] & 0x0F) << 8) | frame[2];  // ADC值（12位：frame3低4位+frame2）
+    parsed_data.ADC_Value = adc_val;     // 存储ADC原始值
+    parsed_data.Bat_mV = (unsigned int)frame[4] * 100;  // 电池电压（frame4为0.1V单位）
+    parsed_data.Check_OK = Protocol_Check(frame) ? 1 : 0;  // FCS校验结果
+    parsed_data.temperature = ADC_To_Temp(adc_val, frame[1]);  // ADC值转换为温度（按该从站校准参数）
+}
+
+// 温度短整型转换为字符型（取整数部分，无效值返回0）
+static unsigned char TempShortToChar(short temp)
+{
+    if (temp == -990)
+    {
+        return 0;  // 无效温度返回0
+    }
+    return (unsigned char)(abs(temp) / 10);  // 取绝对值后除以10，得到整数部分
+}
+
+// ------------------- 数据存储相关函数 -------------------
+// 根据AID获取从站数据（仅返回有效数据，结果复制到调用者的out）
+static DataRecord* GetFixedSlaveData(unsigned char aid, DataRecord *out)
+{
+    return GetRecentDataByAID(aid, out);
+}
+
+// 初始化数据存储缓冲区（清0所有记录和索引）
+void InitDataStorage(void)
+{
+    unsigned char i, j;
+    
+    // 初始化历史当前块（置空，历史区中的块由History_Mount读取）
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        hist_zip_len[i] = 0;
+        hist_zip_last[i].epoch_min = HIST_EPOCH_EMPTY;
+        hist_zip_last[i].temp_deci = -990;
+        hist_zip_last[i].volt_dv = 0;
+        hist_zip_last[i].pid = 0;
+    }
+    
+    // 初始化实时数据表（所有从站无效）
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        rt_temp_deci[i] = -990;
+        rt_volt_mv[i] = 0;
+        rt_pid[i] = 0;
+        rt_last_tick[i] = 0;
+        rt_level[i] = TEMP_LEVEL_NORMAL;
+        thr_pending[i] = TEMP_LEVEL_NORMAL;
+        RateRise_Reset(i);
+    }
+    for (i = 0; i < RT_BITMAP_BYTES; i++)
+    {
+        rt_valid_map[i] = 0;
+        rt_abnormal_map[i] = 0;
+        rt_offline_map[i] = 0;
+        hist_open_map[i] = 0xFF;  // 上电后第一个有效样本直接记录
+        hist_beat_map[i] = 0xFF;
+    }
+    
+    // 停止各从站的历史记录间隔和离线超时定时器（收到第一帧时启动）
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        TimerWheel_Cancel(TMR_ID_HIST(i));
+        TimerWheel_Cancel(TMR_ID_LIVE(i));
+    }
+    
+    // 清空事件日志（报警/恢复/预警/升温速率）和每日最高温记录
+    Journal_Init();
+    DayMaxLog_Init();
+    DayStat_Reset();
+    SlaveDay_Clear();
+    
+    // 初始化报警状态跟踪数组（所有从站正常、无报警事件）
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        last_abnormal_status[i] = 0;
+        alarm_open[i].pos = JOURNAL_POS_NONE;
+    }
+    
+    // 初始化PAGE_19自动记录数组（所有记录标记为无效）
+    for (i = 0; i < 3; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            page19_auto_records[i][j].is_valid = 0;
+        }
+        page19_record_index[i] = 0;
+        page19_last_read_time[i] = 0;
+    }
+    
+    // 清空UART接收缓冲区
+    UART4_ClearBuffer(uart_rx_buff, UART_BUFF_SIZE);
+    uart_rx_len = 0;
+    uart_rx_complete = 0;
+    uart_frame_tail = uart_frame_head;  // 丢弃帧队列中未处理的帧
+}
+
+// 添加数据到摘要存储（实时数据+历史数据）
+// temp_deci：温度（0.1℃，-990=无效）；volt_mv：电池电压（mV）；全程整数运算
+void AddDataToSummary(unsigned char pid, unsigned char aid, 
+                     short temp_deci, unsigned int volt_mv)
+{
+    unsigned char slave_idx;    // 从站索引（AID-1）
+    unsigned long current_time; // 当前系统时间（毫秒）
+    
+    // 无效数据过滤（所有字段为0则跳过）
+    if (pid == 0 && aid == 0 && temp_deci == 0 && volt_mv == 0)
+    {
+        return;
+    }
+    
+    // 从站AID校验（1~TOTAL_SLAVES）
+    if (aid < 1 || aid > TOTAL_SLAVES)
+    {
+        LINK_STAT_INC(link_stats.aid_rejects);
+        return;
+    }
+    
+    slave_idx = aid - 1;
+    current_time = GetSystemTick();
+    
+    // 通信统计：该从站有效帧计数，温度无效（ADC异常）计为失败
+    LINK_STAT_INC(link_aid_rx[slave_idx]);
+    if (temp_deci == -990)
+    {
+        LINK_STAT_INC(link_aid_fail[slave_idx]);
+    }
+    
+    // 更新当前实时数据
+    rt_pid[slave_idx] = pid;
+    rt_temp_deci[slave_idx] = temp_deci;
+    rt_volt_mv[slave_idx] = volt_mv;
+    rt_last_tick[slave_idx] = current_time;
+    Live_Touch(slave_idx);
+    if (parsed_data.Check_OK)
+    {
+        RT_BIT_SET(rt_valid_map, slave_idx);
+    }
+    else
+    {
+        RT_BIT_CLR(rt_valid_map, slave_idx);
+    }
+    
+    // 温度级别在写入时按该从站阈值判断（含回差和驻留时间），异常位即报警级别，扫描时无需再比较温度
+    // 升温速率只用有效样本计算，无效样本打断参考
+    if (RT_BIT_TEST(rt_valid_map, slave_idx))
+    {
+        Threshold_Update(slave_idx, temp_deci);
+        RateRise_Update(slave_idx, temp_deci);
+        DayStat_Sample(slave_idx, temp_deci);
+        SlaveDay_Sample(slave_idx, temp_deci);
+    }
+    else
+    {
+        RateRise_Reset(slave_idx);
+    }
+    
+    // 按记录策略写入历史数据（仅有效样本）
+    if (RT_BIT_TEST(rt_valid_map, slave_idx) && HistLog_Due(slave_idx))
+    {
+        HistLog_Saved(slave_idx);
+        History_Put(slave_idx, pid, temp_deci, volt_mv);
+    }
+    
+    // 显示刷新由UART4_ReceiveString按批统一处理，此处不再逐帧刷新LCD
+}
+
+// ------------------- 从站在线检测 -------------------
+// 收到从站数据帧：离线超时定时器重新计时（取消+启动均为O(1)）；离线从站恢复在线
+static void Live_Touch(unsigned char slave_idx)
+{
+    if (RT_BIT_TEST(rt_offline_map, slave_idx))
+    {
+        RT_BIT_CLR(rt_offline_map, slave_idx);
+        Telemetry_Emit(TELEMETRY_TYPE_COMM_RESTORE, slave_idx + 1, rt_pid[slave_idx],
+                       0, link_aid_offline[slave_idx]);
+        if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_INFO))
+        {
+            UART4_SendString("Comm restored: AID=");
+            UART4_SendNumber(slave_idx + 1, 2);
+            UART4_SendString("\r\n");
+        }
+    }
+    
+    TimerWheel_Start(TMR_ID_LIVE(slave_idx), TW_SEC(live_timeout_s));
+}
+
+// 离线超时定时器到期：超时未上报，清除实时有效位和异常位，置离线位并原位记下中断时间（不写事件日志）
+static void Live_OnTimeout(unsigned char slave_idx)
+{
+    unsigned int silent_s = (unsigned int)((GetSystemTick() - rt_last_tick[slave_idx]) / 1000);
+    unsigned char *t = live_loss_time[slave_idx];
+    
+    RT_BIT_SET(rt_offline_map, slave_idx);
+    RT_BIT_CLR(rt_valid_map, slave_idx);
+    RT_BIT_CLR(rt_abnormal_map, slave_idx);
+    rt_level[slave_idx] = TEMP_LEVEL_NORMAL;  // 恢复上报后重新判断级别
+    thr_pending[slave_idx] = TEMP_LEVEL_NORMAL;
+    RateRise_Reset(slave_idx);
+    LINK_STAT_INC(link_aid_offline[slave_idx]);
+    live_changed = 1;
+    t[0] = current_rtc_time.mon;
+    t[1] = current_rtc_time.day;
+    t[2] = current_rtc_time.hour;
+    t[3] = current_rtc_time.min;
+    
+    Telemetry_Emit(TELEMETRY_TYPE_COMM_LOSS, slave_idx + 1, rt_pid[slave_idx],
+                   (short)silent_s, link_aid_offline[slave_idx]);
+    if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_WARN))
+    {
+        UART4_SendString("Comm lost: AID=");
+        UART4_SendNumber(slave_idx + 1, 2);
+        UART4_SendString(", silent ");
+        UART4_SendNumber(silent_s, 5);
+        UART4_SendString("s\r\n");
+    }
+}
+
+// 从站是否离线（AID越界视为非离线）
+static bit Live_IsOffline(unsigned char aid)
+{
+    if (aid < 1 || aid > TOTAL_SLAVES)
+    {
+        return 0;
+    }
+    return RT_BIT_TEST(rt_offline_map, aid - 1) ? 1 : 0;
+}
+
+// 根据AID获取从站最新数据（由实时数据表组装为DataRecord，复制到调用者提供的out）
+// 成功返回out，AID无效或数据无效返回NULL且不改动out；全部从站扫描请直接访问rt_xxx和位图
+DataRecord* GetRecentDataByAID(unsigned char aid, DataRecord *out)
+{
+    unsigned char idx;  // 从站索引（AID-1）
+    
+    // AID有效性校验（1~TOTAL_SLAVES）
+    if (out == NULL || aid < 1 || aid > TOTAL_SLAVES)
+    {
+        return NULL;
+    }
+    
+    idx = aid - 1;
+    // 数据无效返回NULL
+    if (!RT_BIT_TEST(rt_valid_map, idx))
+    {
+        return NULL;
+    }
+    
+    out->pid = rt_pid[idx];
+    out->aid = aid;
+    out->temp = TempShortToChar(rt_temp_deci[idx]);
+    out->temp_deci = rt_temp_deci[idx];
+    out->volt1 = (unsigned char)(rt_volt_mv[idx] / 100);
+    out->volt2 = 0;
+    out->fosc = 0;
+    out->timestamp = rt_last_tick[idx];
+    out->is_valid = 1;
+    return out;
+}
+
+// ------------------- 历史数据池访问 -------------------
+// 各月1日之前的累计天数（平年）
+static unsigned int code hist_month_days[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+// RTC时间转换为纪元分钟（2000-01-01 00:00记为1，0保留给空条目）
+static unsigned long RtcToEpochMin(const rtc_time_t *t)
+{
+    unsigned int days;
+    unsigned char mon;
+    unsigned char day;
+    
+    mon = (t->mon >= 1 && t->mon <= 12) ? t->mon : 1;
+    day = (t->day >= 1) ? t->day : 1;
+    
+    // year为0~99（2000~2099），其中能被4整除的年份为闰年
+    days = (unsigned int)t->year * 365 + ((unsigned int)t->year + 3) / 4 + hist_month_days[mon - 1] + day - 1;
+    if ((t->year & 3) == 0 && mon > 2)
+    {
+        days++;
+    }
+    
+    return ((unsigned long)days * 24 + t->hour) * 60 + t->min + 1;
+}
+
+// 纪元分钟还原为RTC时间（秒固定为0）
+static void EpochMinToRtc(unsigned long epoch_min, rtc_time_t *t)
+{
+    unsigned long m;
+    unsigned int days;
+    unsigned int year_days;
+    unsigned int month_start;
+    unsigned char leap;
+    unsigned char mon;
+    
+    m = epoch_min - 1;
+    t->sec = 0;
+    t->min = (unsigned char)(m % 60);
+    m /= 60;
+    t->hour = (unsigned char)(m % 24);
+    days = (unsigned int)(m / 24);
+    
+    t->year = 0;
+    while (1)
+    {
+        year_days = (t->year & 3) ? 365 : 366;
+        if (days < year_days)
+        {
+            break;
+        }
+        days -= year_days;
+        t->year++;
+    }
+    
+    leap = ((t->year & 3) == 0) ? 1 : 0;
+    for (mon = 12; mon > 1; mon--)
+    {
+        month_start = hist_month_days[mon - 1] + ((leap && mon > 2) ? 1 : 0);
+        if (days >= month_start)
+        {
+            break;
+        }
+    }
+    month_start = hist_month_days[mon - 1] + ((leap && mon > 2) ? 1 : 0);
+    t->mon = mon;
+    t->day = (unsigned char)(days - month_start + 1);
+}
+
+// 记录类型头（格式见uart4.h"历史数据压缩环配置"）
+#define HZ_IS_SHORT(h)      (((h) & 0x80) == 0x00)
+#define HZ_IS_MID(h)        (((h) & 0xC0) == 0x80)
+#define HZ_IS_TIMED(h)      (((h) & 0xE0) == 0xC0)
+#define HZ_TAG_MID          0x80
+#define HZ_TAG_TIMED        0xC0
+#define HZ_TAG_KEY          0xE0
+#define HZ_HIDE_BIT(h)      (HZ_IS_SHORT(h) ? 0x40 : (HZ_IS_MID(h) ? 0x20 : 0x10))
+
+// 从最旧块开始解码：历史区中该从站最新的HIST_ZIP_BLOCKS-1块（遍历一次历史区记下位置），之后为RAM当前块
+static void HistZip_Begin(HistZipReader *rd, unsigned char slave_idx)
+{
+#if PERSIST_ENABLE
+    IapAreaIter it;
+    unsigned char owner;
+    unsigned char i;
+#endif
+    
+    rd->slave_idx = slave_idx;
+    rd->blk_count = 0;
+#if PERSIST_ENABLE
+    IapArea_IterBegin(&hist_area, &it);
+    while (IapArea_Next(&hist_area, &it))
+    {
+        IapArea_Read(&it, 0, &owner, 1);
+        if (owner != slave_idx)
+        {
+            continue;
+        }
+        if (rd->blk_count == HIST_ZIP_BLOCKS - 1)
+        {
+            // 只保留最新的块：丢弃最旧的位置
+            for (i = 1; i < HIST_ZIP_BLOCKS - 1; i++)
+            {
+                rd->blk_it[i - 1] = rd->blk_it[i];
+            }
+            rd->blk_count--;
+        }
+        rd->blk_it[rd->blk_count++] = it;
+    }
+#endif
+    rd->blk = 0;
+    HistZip_Load(rd);
+    rd->hidden = 0;
+    rd->cur.epoch_min = HIST_EPOCH_EMPTY;
+    rd->cur.temp_deci = -990;
+    rd->cur.volt_dv = 0;
+    rd->cur.pid = 0;
+}
+
+// 读入rd->blk：历史区中的块复制数据和删除位，RAM当前块直接读取
+static void HistZip_Load(HistZipReader *rd)
+{
+    rd->pos = 0;
+    rd->rec = 0;
+#if PERSIST_ENABLE
+    if (rd->blk < rd->blk_count)
+    {
+        IapArea_Read(&rd->blk_it[rd->blk], 1, &rd->len, 1);
+        if (rd->len > HIST_ZIP_BLOCK_SIZE)
+        {
+            rd->len = 0;
         }
+        IapArea_Read(&rd->blk_it[rd->blk], 2, rd->buf, rd->len);
+        IapArea_Read(&rd->blk_it[rd->blk], IAP_AREA_AUX(HIST_AREA_REC_LEN), rd->aux, HIST_AREA_AUX_LEN);
+        return;
+    }
+#endif
+    rd->len = hist_zip_len[rd->slave_idx];
+}
+
+// 解码下一条记录，结果累加到rd->cur；无更多记录返回0
+static bit HistZip_Next(HistZipReader *rd)
+{
+    unsigned char *p;
+    
+    // 当前块读完则切换到下一块（RAM当前块之后结束）
+    while (rd->pos >= rd->len)
+    {
+        if (rd->blk >= rd->blk_count)
+        {
+            return 0;
+        }
+        rd->blk++;
+        HistZip_Load(rd);
+    }
+    
+    p = (rd->blk < rd->blk_count) ? &rd->buf[rd->pos] : &hist_zip[rd->slave_idx][rd->pos];
+    rd->hdr_pos = rd->pos;
+    rd->hidden = (p[0] & HZ_HIDE_BIT(p[0])) ? 1 : 0;
+    if (rd->blk < rd->blk_count && !(rd->aux[rd->rec >> 3] & (1 << (rd->rec & 7))))
+    {
+        rd->hidden = 1;
+    }
+    rd->pos += HistZip_Step(p, &rd->cur);
+    rd->rec++;
+    return 1;
+}
+
+// 解码p处的一条记录：增量累加到cur，关键帧直接取绝对值；返回记录长度
+static unsigned char HistZip_Step(const unsigned char *p, HistEntry *cur)
+{
+    unsigned char hdr = p[0];
+    signed char d;
+    
+    if (HZ_IS_SHORT(hdr))
+    {
+        // 6位有符号温度增量
+        d = (signed char)(hdr & 0x3F);
+        if (d & 0x20)
+        {
+            d -= 64;
+        }
+        cur->epoch_min += HIST_ZIP_STEP_MIN;
+        cur->temp_deci += d;
+        return 1;
+    }
+    if (HZ_IS_MID(hdr))
+    {
+        // 5位有符号电压增量 + 8位有符号温度增量
+        d = (signed char)(hdr & 0x1F);
+        if (d & 0x10)
+        {
+            d -= 32;
+        }
+        cur->epoch_min += HIST_ZIP_STEP_MIN;
+        cur->volt_dv += d;
+        cur->temp_deci += (signed char)p[1];
+        return 2;
+    }
+    if (HZ_IS_TIMED(hdr))
+    {
+        cur->epoch_min += p[1];
+        cur->temp_deci += (signed char)p[2];
+        cur->volt_dv += (signed char)p[3];
+        return 4;
+    }
+    
+    // 关键帧：绝对值
+    cur->epoch_min = (unsigned long)p[1] | ((unsigned long)p[2] << 8) |
+                     ((unsigned long)p[3] << 16) | ((unsigned long)p[4] << 24);
+    cur->temp_deci = (short)((unsigned int)p[5] | ((unsigned int)p[6] << 8));
+    cur->volt_dv = p[7];
+    cur->pid = p[8];
+    return HIST_ZIP_KEY_LEN;
+}
+
+// 解码结果展开为DataRecord视图（供显示使用）
+static void HistZip_ToRecord(HistZipReader *rd, DataRecord *out)
+{
+    out->pid = rd->cur.pid;
+    out->aid = rd->slave_idx + 1;
+    out->temp = TempShortToChar(rd->cur.temp_deci);
+    out->temp_deci = rd->cur.temp_deci;
+    out->volt1 = rd->cur.volt_dv;
+    out->volt2 = 0;
+    out->fosc = 0;
+    out->timestamp = 0;
+    EpochMinToRtc(rd->cur.epoch_min, &out->save_time);
+    out->is_valid = 1;
+}
+
+// 写入一条历史记录（按当前RTC时间）
+static void History_Put(unsigned char slave_idx, unsigned char pid, short temp_deci, unsigned int volt_mv)
+{
+    GetCurrentRTC();
+    History_PutAt(slave_idx, pid, temp_deci, volt_mv, RtcToEpochMin(&current_rtc_time));
+}
+
+// 按指定纪元分钟写入一条历史记录：能用增量表示则写增量，否则写关键帧；
+// 当前块放不下或已超过HIST_ZIP_SEAL_MIN时先写入历史区，新块以关键帧开头。EEPROM日志回放时直接调用
+static void History_PutAt(unsigned char slave_idx, unsigned char pid, short temp_deci, unsigned int volt_mv, unsigned long now)
+{
+    HistEntry *last;
+    unsigned char *blk;
+    unsigned char rec[HIST_ZIP_KEY_LEN];
+    unsigned char len;
+    unsigned char volt_dv;
+    unsigned long dt;
+    unsigned long key_epoch;
+    short d_temp;
+    short d_volt;
+    unsigned char i;
+    
+    if (slave_idx >= TOTAL_SLAVES)
+    {
+        return;
+    }
+    
+    volt_dv = (volt_mv >= 25500) ? 255 : (unsigned char)(volt_mv / 100);
+    last = &hist_zip_last[slave_idx];
+    blk = hist_zip[slave_idx];
+    len = 0;
+    
+    // 0. 当前块的关键帧（块首）已超过HIST_ZIP_SEAL_MIN：先写入历史区
+    if (hist_zip_len[slave_idx] > 0)
+    {
+        key_epoch = (unsigned long)blk[1] | ((unsigned long)blk[2] << 8) |
+                    ((unsigned long)blk[3] << 16) | ((unsigned long)blk[4] << 24);
+        if (now >= key_epoch + HIST_ZIP_SEAL_MIN)
+        {
+            History_Seal(slave_idx);
+        }
+    }
+    
+    // 1. 尝试增量编码（PID变化、时间倒退或当前块为空时必须写关键帧）
+    if (hist_zip_len[slave_idx] > 0 && last->epoch_min != HIST_EPOCH_EMPTY &&
+        pid == last->pid && now >= last->epoch_min)
+    {
+        dt = now - last->epoch_min;
+        // 记录由系统滴答触发，RTC分钟数可能与默认间隔差1分钟：按默认间隔编码，
+        // 基准时间随之取编码值，保存时间误差始终不超过1分钟
+        if (dt + 1 >= HIST_ZIP_STEP_MIN && dt <= HIST_ZIP_STEP_MIN + 1)
+        {
+            dt = HIST_ZIP_STEP_MIN;
+            now = last->epoch_min + dt;
+        }
+        d_temp = temp_deci - last->temp_deci;
+        d_volt = (short)volt_dv - (short)last->volt_dv;
+        
+        if (dt == HIST_ZIP_STEP_MIN && d_volt == 0 && d_temp >= -32 && d_temp <= 31)
+        {
+            rec[0] = (unsigned char)(d_temp & 0x3F);
+            len = 1;
+        }
+        else if (dt == HIST_ZIP_STEP_MIN && d_volt >= -16 && d_volt <= 15 &&
+                 d_temp >= -128 && d_temp <= 127)
+        {
+            rec[0] = HZ_TAG_MID | (unsigned char)(d_volt & 0x1F);
+            rec[1] = (unsigned char)d_temp;
+            len = 2;
+        }
+        else if (dt <= 255 && d_temp >= -128 && d_temp <= 127 && d_volt >= -128 && d_volt <= 127)
+        {
+            rec[0] = HZ_TAG_TIMED;
+            rec[1] = (unsigned char)dt;
+            rec[2] = (unsigned char)d_temp;
+            rec[3] = (unsigned char)d_volt;
+            len = 4;
+        }
+    }
+    
+    // 2. 需要关键帧，或增量在当前块放不下（关键帧更长，同样放不下）
+    if (len == 0 || hist_zip_len[slave_idx] + len > HIST_ZIP_BLOCK_SIZE)
+    {
+        if (hist_zip_len[slave_idx] + HIST_ZIP_KEY_LEN > HIST_ZIP_BLOCK_SIZE)
+        {
+            History_Seal(slave_idx);
+        }
+        rec[0] = HZ_TAG_KEY;
+        rec[1] = (unsigned char)(now & 0xFF);
+        rec[2] = (unsigned char)(now >> 8);
+        rec[3] = (unsigned char)(now >> 16);
+        rec[4] = (unsigned char)(now >> 24);
+        rec[5] = (unsigned char)((unsigned int)temp_deci & 0xFF);
+        rec[6] = (unsigned char)((unsigned int)temp_deci >> 8);
+        rec[7] = volt_dv;
+        rec[8] = pid;
+        len = HIST_ZIP_KEY_LEN;
+    }
+    
+    // 3. 追加到当前块并更新增量基准
+    for (i = 0; i < len; i++)
+    {
+        blk[hist_zip_len[slave_idx] + i] = rec[i];
+    }
+    hist_zip_len[slave_idx] += len;
+    
+    last->epoch_min = now;
+    last->temp_deci = temp_deci;
+    last->volt_dv = volt_dv;
+    last->pid = pid;
+    
+#if PERSIST_ENABLE
+    // 按编码后的时间汇总，EEPROM回放时重建尚未写入小时区的当前小时
+    Rollup_Feed(slave_idx, now, temp_deci);
+#endif
+    
+    // 记录编码后的时间，回放时按相同时间写入可得到相同的压缩数据
+    Persist_HistSample(slave_idx, last);
+}
+
+// 当前块整块写入历史区（块长度之后的字节无意义，一并写入以凑满记录长度），RAM当前块清空
+// 挂载回放时也可能调用：掉电打断了写入历史区，回放到块满时重新写入
+static void History_Seal(unsigned char slave_idx)
+{
+#if PERSIST_ENABLE
+    unsigned char head[2];
+    
+    head[0] = slave_idx;
+    head[1] = hist_zip_len[slave_idx];
+    IapArea_Begin(&hist_area);
+    IapArea_Put(&hist_area, head, 2);
+    IapArea_Put(&hist_area, hist_zip[slave_idx], HIST_ZIP_BLOCK_SIZE);
+    IapArea_Commit(&hist_area);
+#endif
+    hist_zip_len[slave_idx] = 0;
+}
+
+#if PERSIST_ENABLE
+// 挂载历史区；各从站的增量基准取历史区中该从站最新一块的最后一条记录，
+// 上电回放EEPROM日志时据此跳过已在历史区中的样本（须在IapLog_Mount之前调用）
+static void History_Mount(void)
+{
+    IapAreaIter it;
+    unsigned char head[2];
+    unsigned char buf[HIST_ZIP_BLOCK_SIZE];
+    unsigned char pos;
+    
+    hist_area.first = HIST_AREA_FIRST;
+    hist_area.sectors = HIST_AREA_SECTORS;
+    hist_area.rec_len = HIST_AREA_REC_LEN;
+    hist_area.aux_len = HIST_AREA_AUX_LEN;
+    IapArea_Mount(&hist_area);
+    
+    IapArea_IterBegin(&hist_area, &it);
+    while (IapArea_Next(&hist_area, &it))
+    {
+        IapArea_Read(&it, 0, head, 2);
+        if (head[0] >= TOTAL_SLAVES || head[1] > HIST_ZIP_BLOCK_SIZE)
+        {
+            continue;
+        }
+        IapArea_Read(&it, 2, buf, head[1]);
+        for (pos = 0; pos < head[1]; )
+        {
+            pos += HistZip_Step(&buf[pos], &hist_zip_last[head[0]]);
+        }
+    }
+}
+#endif
+
+// 按记录策略判断新样本是否写入历史（新样本已写入rt_xxx）：
+// 未达最小间隔不记录；达到心跳间隔必记录；其间温度或电压变化超过死区才记录
+// 间隔由TMR_ID_HIST定时器维护为两个位图，逐帧只做位测试
+static bit HistLog_Due(unsigned char slave_idx)
+{
+    HistEntry *last = &hist_zip_last[slave_idx];
+    short d_temp;
+    short d_volt_dv;
+    
+    if (last->epoch_min == HIST_EPOCH_EMPTY)
+    {
+        return 1;
+    }
+    if (!RT_BIT_TEST(hist_open_map, slave_idx))
+    {
+        return 0;
+    }
+    if (RT_BIT_TEST(hist_beat_map, slave_idx))
+    {
+        return 1;
+    }
+    
+    d_temp = rt_temp_deci[slave_idx] - last->temp_deci;
+    if (d_temp < 0)
+    {
+        d_temp = -d_temp;
+    }
+    d_volt_dv = (short)(rt_volt_mv[slave_idx] / 100) - (short)last->volt_dv;
+    if (d_volt_dv < 0)
+    {
+        d_volt_dv = -d_volt_dv;
+    }
+    
+    return (d_temp > hist_log_deadband_deci || d_volt_dv * 100 > HIST_LOG_DEADBAND_MV) ? 1 : 0;
+}
+
+// 已写入历史：关闭记录窗口，开始最小间隔计时
+static void HistLog_Saved(unsigned char slave_idx)
+{
+    RT_BIT_CLR(hist_open_map, slave_idx);
+    RT_BIT_CLR(hist_beat_map, slave_idx);
+    TimerWheel_Start(TMR_ID_HIST(slave_idx), TW_SEC(HIST_LOG_MIN_MIN * 60UL));
+}
+
+// 历史记录间隔定时器到期：最小间隔到期后开放死区判断并继续计到心跳间隔；心跳间隔到期后下一个样本必记录
+static void HistLog_OnTimer(unsigned char slave_idx)
+{
+    if (!RT_BIT_TEST(hist_open_map, slave_idx))
+    {
+        RT_BIT_SET(hist_open_map, slave_idx);
+        if (hist_log_max_min > HIST_LOG_MIN_MIN)
+        {
+            TimerWheel_Start(TMR_ID_HIST(slave_idx),
+                             TW_SEC((unsigned long)(hist_log_max_min - HIST_LOG_MIN_MIN) * 60UL));
+            return;
+        }
+    }
+    RT_BIT_SET(hist_beat_map, slave_idx);
+}
+
+// 历史记录条数（含已删除记录，即PAGE_19可选的记录序号范围）
+static unsigned char History_Count(unsigned char slave_idx)
+{
+    HistZipReader rd;
+    unsigned char count = 0;
+    
+    if (slave_idx >= TOTAL_SLAVES)
+    {
+        return 0;
+    }
+    
+    HistZip_Begin(&rd, slave_idx);
+    while (HistZip_Next(&rd))
+    {
+        count++;
+    }
+    return count;
+}
+
+// 从from_slot（按时间顺序的序号，含）起查找第一条未删除的记录，到末尾后回绕到最旧记录；
+// 找到时out（可为NULL）填入该记录视图并返回序号，否则返回HIST_SLOT_NONE
+static unsigned char History_FindVisible(unsigned char slave_idx, unsigned char from_slot, DataRecord *out)
+{
+    HistZipReader rd;
+    unsigned char slot = 0;
+    unsigned char first = HIST_SLOT_NONE;
+    
+    if (slave_idx >= TOTAL_SLAVES)
+    {
+        return HIST_SLOT_NONE;
+    }
+    
+    HistZip_Begin(&rd, slave_idx);
+    while (HistZip_Next(&rd))
+    {
+        if (!rd.hidden)
+        {
+            if (slot >= from_slot)
+            {
+                if (out != NULL)
+                {
+                    HistZip_ToRecord(&rd, out);
+                }
+                return slot;
+            }
+            if (first == HIST_SLOT_NONE)
+            {
+                first = slot;
+            }
+        }
+        slot++;
+    }
+    
+    // 回绕：重新解码到最旧的未删除记录
+    if (first != HIST_SLOT_NONE && out != NULL)
+    {
+        HistZip_Begin(&rd, slave_idx);
+        for (slot = 0; slot <= first; slot++)
+        {
+            HistZip_Next(&rd);
+        }
+        HistZip_ToRecord(&rd, out);
+    }
+    return first;
+}
+
+// 删除一条历史记录，不影响后续增量解码：RAM当前块中的记录在类型头原地置删除标志并写入EEPROM日志，
+// 历史区中的记录清除槽附加字节中的删除位（直接写入EEPROM）
+static void History_Invalidate(unsigned char slave_idx, unsigned char slot)
+{
+    HistZipReader rd;
+    unsigned char i;
+    unsigned char *hdr;
+    
+    if (slave_idx >= TOTAL_SLAVES)
+    {
+        return;
+    }
+    
+    HistZip_Begin(&rd, slave_idx);
+    for (i = 0; i <= slot; i++)
+    {
+        if (!HistZip_Next(&rd))
+        {
+            return;
+        }
+    }
+#if PERSIST_ENABLE
+    if (rd.blk < rd.blk_count)
+    {
+        i = rd.rec - 1;
+        IapArea_ClearBits(&rd.blk_it[rd.blk], (unsigned char)(IAP_AREA_AUX(HIST_AREA_REC_LEN) + (i >> 3)),
+                          (unsigned char)(1 << (i & 7)));
+        return;
+    }
+#endif
+    hdr = &hist_zip[slave_idx][rd.hdr_pos];
+    *hdr |= HZ_HIDE_BIT(*hdr);
+    
+    Persist_HistDelete(slave_idx, rd.cur.epoch_min);
+}
+
+// 删除指定时间的第一条未删除历史记录（EEPROM日志回放用，序号在回放过程中会变化；
+// 日志中的删除只针对当前块，历史区中的块已带删除标志）
+static void History_InvalidateEpoch(unsigned char slave_idx, unsigned long epoch_min)
+{
+    HistZipReader rd;
+    unsigned char *hdr;
+    
+    if (slave_idx >= TOTAL_SLAVES)
+    {
+        return;
+    }
+    
+    HistZip_Begin(&rd, slave_idx);
+    while (HistZip_Next(&rd))
+    {
+        if (rd.blk == rd.blk_count && !rd.hidden && rd.cur.epoch_min == epoch_min)
+        {
+            hdr = &hist_zip[slave_idx][rd.hdr_pos];
+            *hdr |= HZ_HIDE_BIT(*hdr);
+            return;
+        }
+    }
+}
+
+// 串口导出一个从站的历史记录（每条一行：TXnn 年-月-日 时:分 T=±温度(0.1℃) V=电压mV）
+// 每行发送后等待发送完成，避免大量输出时发送缓冲区溢出丢字节
+static void History_Export(unsigned char aid)
+{
+    HistZipReader rd;
+    rtc_time_t t;
+    short temp;
+    
+    HistZip_Begin(&rd, aid - 1);
+    while (HistZip_Next(&rd))
+    {
+        if (rd.hidden)
+        {
+            continue;
+        }
+        EpochMinToRtc(rd.cur.epoch_min, &t);
+        temp = rd.cur.temp_deci;
+        
+        UART4_SendString("TX");
+        UART4_SendNumber(aid, 2);
+        UART4_SendString(" ");
+        UART4_SendNumber(t.year, 2);
+        UART4_SendString("-");
+        UART4_SendNumber(t.mon, 2);
+        UART4_SendString("-");
+        UART4_SendNumber(t.day, 2);
+        UART4_SendString(" ");
+        UART4_SendNumber(t.hour, 2);
+        UART4_SendString(":");
+        UART4_SendNumber(t.min, 2);
+        UART4_SendString(" T=");
+        if (temp < 0)
+        {
+            UART4_SendString("-");
+            UART4_SendNumber((unsigned long)(-temp), 4);
+        }
+        else
+        {
+            UART4_SendString("+");
+            UART4_SendNumber((unsigned long)temp, 4);
+        }
+        UART4_SendString(" V=");
+        UART4_SendNumber((unsigned long)rd.cur.volt_dv * 100, 5);
+        UART4_SendString("\r\n");
+        UART4_FlushTx();
+    }
+}
+
+// ------------------- 历史汇总（小时/每日） -------------------
+// 小时区/日区每条记录含全部从站，记录按小时/天序号递增写入，遍历时从旧到新
+#if PERSIST_ENABLE
+static void Rollup_Mount(void)
+{
+    unsigned char i;
+    
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        rollup_acc[i].count = 0;
+    }
+    rollup_open = 0;
+    
+    rollup_hour_area.first = ROLLUP_HOUR_FIRST;
+    rollup_hour_area.sectors = ROLLUP_HOUR_SECTORS;
+    rollup_hour_area.rec_len = ROLLUP_REC_LEN;
+    rollup_hour_area.aux_len = 0;
+    IapArea_Mount(&rollup_hour_area);
+    rollup_day_area.first = ROLLUP_DAY_FIRST;
+    rollup_day_area.sectors = ROLLUP_DAY_SECTORS;
+    rollup_day_area.rec_len = ROLLUP_REC_LEN;
+    rollup_day_area.aux_len = 0;
+    IapArea_Mount(&rollup_day_area);
+    
+    rollup_hour_last = Rollup_Newest(&rollup_hour_area);
+    rollup_day_last = Rollup_Newest(&rollup_day_area);
+}
+
+static unsigned long Rollup_Newest(const IapArea *a)
+{
+    IapAreaIter it;
+    unsigned long bucket = ROLLUP_NONE;
+    
+    IapArea_IterBegin(a, &it);
+    while (IapArea_Next(a, &it))
+    {
+        bucket = Rollup_ReadBucket(&it);
+    }
+    return bucket;
+}
+
+// 样本所在小时晚于当前小时：当前小时写入小时区；开始新的一小时前，若其所在日晚于小时区最新一条所在日
+// 且该日尚未写入日区，先结束该日
+static void Rollup_Feed(unsigned char slave_idx, unsigned long epoch_min, short temp_deci)
+{
+    unsigned long hour = (epoch_min - 1) / 60;
+    
+    if (rollup_open && hour > rollup_hour)
+    {
+        Rollup_Write(&rollup_hour_area, rollup_hour);
+        rollup_hour_last = rollup_hour;
+        rollup_open = 0;
+    }
+    if (!rollup_open)
+    {
+        if (rollup_hour_last != ROLLUP_NONE && hour <= rollup_hour_last)
+        {
+            return;                       // 该小时已写入小时区（回放的已汇总样本或RTC倒退）
+        }
+        if (rollup_hour_last != ROLLUP_NONE && hour / 24 > rollup_hour_last / 24 &&
+            (rollup_day_last == ROLLUP_NONE || rollup_hour_last / 24 > rollup_day_last))
+        {
+            Rollup_CloseDay(rollup_hour_last / 24);
+        }
+        rollup_hour = hour;
+        rollup_open = 1;
+    }
+    Rollup_Merge(&rollup_acc[slave_idx], temp_deci, temp_deci, temp_deci, 1);
+}
+
+static void Rollup_Merge(RollupAcc *acc, short min_temp, short max_temp, long sum, unsigned int count)
+{
+    if (acc->count == 0)
+    {
+        acc->min_temp = min_temp;
+        acc->max_temp = max_temp;
+        acc->sum = sum;
+        acc->count = count;
+        return;
+    }
+    if (min_temp < acc->min_temp)
+    {
+        acc->min_temp = min_temp;
+    }
+    if (max_temp > acc->max_temp)
+    {
+        acc->max_temp = max_temp;
+    }
+    acc->sum += sum;
+    acc->count += count;
+}
+
+// 逐个从站流式写入，不需要整条记录的缓冲区
+static void Rollup_Write(IapArea *a, unsigned long bucket)
+{
+    RollupAcc *acc;
+    unsigned char rec[4];
+    unsigned char i;
+    short avg;
+    
+    IapArea_Begin(a);
+    rec[0] = (unsigned char)(bucket & 0xFF);
+    rec[1] = (unsigned char)(bucket >> 8);
+    rec[2] = (unsigned char)(bucket >> 16);
+    rec[3] = (unsigned char)(bucket >> 24);
+    IapArea_Put(a, rec, 4);
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        acc = &rollup_acc[i];
+        avg = (acc->count > 0) ? (short)(acc->sum / (long)acc->count) : ROLLUP_EMPTY;
+        rec[0] = (unsigned char)((unsigned int)avg & 0xFF);
+        rec[1] = (unsigned char)((unsigned int)avg >> 8);
+        rec[2] = 0;
+        rec[3] = 0;
+        if (acc->count > 0)
+        {
+            rec[2] = (avg - acc->min_temp > ROLLUP_SPAN_MAX) ? ROLLUP_SPAN_MAX : (unsigned char)(avg - acc->min_temp);
+            rec[3] = (acc->max_temp - avg > ROLLUP_SPAN_MAX) ? ROLLUP_SPAN_MAX : (unsigned char)(acc->max_temp - avg);
+        }
+        IapArea_Put(a, rec, 4);
+        acc->count = 0;
+    }
+    IapArea_Commit(a);
+}
+
+// 调用时当前小时尚未开始，累加器为空，借用来汇总该天；平均值为各小时平均值的平均
+static void Rollup_CloseDay(unsigned long day)
+{
+    IapAreaIter it;
+    unsigned char i;
+    short min_temp;
+    short max_temp;
+    short avg;
+    
+    IapArea_IterBegin(&rollup_hour_area, &it);
+    while (IapArea_Next(&rollup_hour_area, &it))
+    {
+        if (Rollup_ReadBucket(&it) / 24 != day)
+        {
+            continue;
+        }
+        for (i = 0; i < TOTAL_SLAVES; i++)
+        {
+            if (Rollup_ReadRec(&it, i, &min_temp, &max_temp, &avg))
+            {
+                Rollup_Merge(&rollup_acc[i], min_temp, max_temp, avg, 1);
+            }
+        }
+    }
+    Rollup_Write(&rollup_day_area, day);
+    rollup_day_last = day;
+}
+
+static unsigned long Rollup_ReadBucket(const IapAreaIter *it)
+{
+    unsigned char rec[4];
+    
+    IapArea_Read(it, 0, rec, 4);
+    return (unsigned long)rec[0] | ((unsigned long)rec[1] << 8) |
+           ((unsigned long)rec[2] << 16) | ((unsigned long)rec[3] << 24);
+}
+
+static bit Rollup_ReadRec(const IapAreaIter *it, unsigned char slave_idx, short *min_temp, short *max_temp, short *avg)
+{
+    unsigned char rec[4];
+    
+    IapArea_Read(it, (unsigned char)(4 + slave_idx * 4), rec, 4);
+    *avg = (short)((unsigned int)rec[0] | ((unsigned int)rec[1] << 8));
+    if (*avg == ROLLUP_EMPTY)
+    {
+        return 0;
+    }
+    *min_temp = *avg - rec[2];
+    *max_temp = *avg + rec[3];
+    return 1;
+}
+
+// 串口输出一个从站的汇总（每条一行：TXnn 年-月-日[ 时:00] L=最低 H=最高 A=平均，0.1℃），从旧到新，
+// 末尾为尚未结束的当前小时/当天（标记*）；每日汇总的当天由小时区中当天的各小时和当前小时算出
+static void Rollup_Export(unsigned char aid, bit daily)
+{
+    unsigned char idx = aid - 1;
+    IapArea *a = daily ? &rollup_day_area : &rollup_hour_area;
+    IapAreaIter it;
+    RollupAcc open;
+    unsigned long day;
+    short min_temp;
+    short max_temp;
+    short avg;
+    
+    IapArea_IterBegin(a, &it);
+    while (IapArea_Next(a, &it))
+    {
+        if (Rollup_ReadRec(&it, idx, &min_temp, &max_temp, &avg))
+        {
+            Rollup_SendLine(aid, Rollup_ReadBucket(&it), daily, min_temp, max_temp, avg, 0);
+        }
+    }
+    
+    open = rollup_acc[idx];
+    if (!rollup_open)
+    {
+        open.count = 0;
+    }
+    if (daily)
+    {
+        // 当天：小时区最新一条所在日（尚未写入日区时）或当前小时所在日
+        day = rollup_open ? rollup_hour / 24 : rollup_hour_last / 24;
+        if ((!rollup_open && rollup_hour_last == ROLLUP_NONE) ||
+            (rollup_day_last != ROLLUP_NONE && day <= rollup_day_last))
+        {
+            return;
+        }
+        if (open.count > 0)
+        {
+            avg = (short)(open.sum / (long)open.count);
+            open.sum = avg;
+            open.count = 1;
+        }
+        IapArea_IterBegin(&rollup_hour_area, &it);
+        while (IapArea_Next(&rollup_hour_area, &it))
+        {
+            if (Rollup_ReadBucket(&it) / 24 == day && Rollup_ReadRec(&it, idx, &min_temp, &max_temp, &avg))
+            {
+                Rollup_Merge(&open, min_temp, max_temp, avg, 1);
+            }
+        }
+        if (open.count > 0)
+        {
+            Rollup_SendLine(aid, day, 1, open.min_temp, open.max_temp, (short)(open.sum / (long)open.count), 1);
+        }
+    }
+    else if (open.count > 0)
+    {
+        Rollup_SendLine(aid, rollup_hour, 0, open.min_temp, open.max_temp, (short)(open.sum / (long)open.count), 1);
+    }
+}
+
+static void Rollup_SendLine(unsigned char aid, unsigned long bucket, bit daily, short min_temp, short max_temp, short avg, bit open)
+{
+    rtc_time_t t;
+    
+    EpochMinToRtc(bucket * (daily ? 1440UL : 60UL) + 1, &t);
+    UART4_SendString("TX");
+    UART4_SendNumber(aid, 2);
+    UART4_SendString(" ");
+    UART4_SendNumber(t.year, 2);
+    UART4_SendString("-");
+    UART4_SendNumber(t.mon, 2);
+    UART4_SendString("-");
+    UART4_SendNumber(t.day, 2);
+    if (!daily)
+    {
+        UART4_SendString(" ");
+        UART4_SendNumber(t.hour, 2);
+        UART4_SendString(":00");
+    }
+    Rollup_SendTemp(" L=", min_temp);
+    Rollup_SendTemp(" H=", max_temp);
+    Rollup_SendTemp(" A=", avg);
+    UART4_SendString(open ? " *\r\n" : "\r\n");
+    UART4_FlushTx();
+}
+
+static void Rollup_SendTemp(unsigned char *label, short temp_deci)
+{
+    UART4_SendString(label);
+    if (temp_deci < 0)
+    {
+        UART4_SendString("-");
+        UART4_SendNumber((unsigned long)(-temp_deci), 4);
+    }
+    else
+    {
+        UART4_SendString("+");
+        UART4_SendNumber((unsigned long)temp_deci, 4);
     }
 }
 
-// 根据AID获取从站最新数据（实时数据区）
-DataRecord* GetRecentDataByAID(unsigned char aid)
+#endif
+
+// ------------------- EEPROM持久化 -------------------
+// 事件日志和报警/跨天状态作为一条快照记录写入，历史样本逐条作为流水记录写入（格式见uart4.h"EEPROM持久化配置"）
+// 挂载回放期间IapLog_Append不写入，回放调用的修改函数不会重复记录
+#if PERSIST_ENABLE
+static unsigned char persist_buf[PERSIST_BUF_SIZE];      // 快照记录组装缓冲区
+#endif
+
+// 事件快照：异常状态位图和跨天判断日期，之后为事件日志中最新的未删除记录
+// （Journal_Export整条导出，从旧到新；回放时依次导入即恢复日志和显示顺序）
+static void Persist_SaveEvents(void)
 {
-    unsigned char idx;  // 从站索引（AID-1）
+#if PERSIST_ENABLE
+    unsigned char i;
+    unsigned int n;
     
-    // AID有效性校验（1~TOTAL_SLAVES）
-    if (aid < 1 || aid > TOTAL_SLAVES)
+    for (i = 0; i < RT_BITMAP_BYTES; i++)
     {
-        return NULL;
+        persist_buf[i] = 0;
     }
-    
-    idx = aid - 1;
-    // 数据有效则返回指针，否则返回NULL
-    if (data_summary[idx].is_valid)
+    for (i = 0; i < TOTAL_SLAVES; i++)
     {
-        return &data_summary[idx];
+        if (last_abnormal_status[i])
+        {
+            RT_BIT_SET(persist_buf, i);
+        }
     }
+    persist_buf[RT_BITMAP_BYTES] = current_system_date[0];
+    persist_buf[RT_BITMAP_BYTES + 1] = current_system_date[1];
+    persist_buf[RT_BITMAP_BYTES + 2] = current_system_date[2];
+    n = Journal_Export(persist_buf + PERSIST_EVENT_HDR, PERSIST_EVENT_BYTES);
+    IapLog_Append(PERSIST_REC_EVENTS, persist_buf, (unsigned char)(PERSIST_EVENT_HDR + n));
+#endif
+}
+
+static void Persist_SaveDayMax(void)
+{
+#if PERSIST_ENABLE
+    unsigned char n;
+    
+    n = DayMaxLog_Export(persist_buf);
+    IapLog_Append(PERSIST_REC_DAY_MAX, persist_buf, n);
+#endif
+}
+
+static void Persist_HistSample(unsigned char slave_idx, const HistEntry *e)
+{
+#if PERSIST_ENABLE
+    unsigned char rec[9];
+    
+    rec[0] = slave_idx;
+    rec[1] = (unsigned char)(e->epoch_min & 0xFF);
+    rec[2] = (unsigned char)(e->epoch_min >> 8);
+    rec[3] = (unsigned char)(e->epoch_min >> 16);
+    rec[4] = (unsigned char)(e->epoch_min >> 24);
+    rec[5] = (unsigned char)((unsigned int)e->temp_deci & 0xFF);
+    rec[6] = (unsigned char)((unsigned int)e->temp_deci >> 8);
+    rec[7] = e->volt_dv;
+    rec[8] = e->pid;
+    IapLog_Append(PERSIST_REC_HIST_SAMPLE, rec, 9);
+#endif
+}
+
+static void Persist_HistDelete(unsigned char slave_idx, unsigned long epoch_min)
+{
+#if PERSIST_ENABLE
+    unsigned char rec[5];
+    
+    rec[0] = slave_idx;
+    rec[1] = (unsigned char)(epoch_min & 0xFF);
+    rec[2] = (unsigned char)(epoch_min >> 8);
+    rec[3] = (unsigned char)(epoch_min >> 16);
+    rec[4] = (unsigned char)(epoch_min >> 24);
+    IapLog_Append(PERSIST_REC_HIST_DELETE, rec, 5);
+#endif
+}
+
+#if PERSIST_ENABLE
+// 挂载时按写入顺序逐条回放；长度与当前结构不符的快照（固件升级改变了结构）忽略
+void IapLog_OnReplay(unsigned char type, const unsigned char *payload, unsigned char len)
+{
+    unsigned char i;
+    unsigned char n;
+    unsigned long epoch;
     
-    return NULL;
+    switch (type)
+    {
+        case PERSIST_REC_EVENTS:
+            if (len < PERSIST_EVENT_HDR)
+            {
+                break;
+            }
+            for (i = 0; i < TOTAL_SLAVES; i++)
+            {
+                last_abnormal_status[i] = RT_BIT_TEST(payload, i) ? 1 : 0;
+            }
+            current_system_date[0] = payload[RT_BITMAP_BYTES];
+            current_system_date[1] = payload[RT_BITMAP_BYTES + 1];
+            current_system_date[2] = payload[RT_BITMAP_BYTES + 2];
+            Journal_Init();
+            for (i = PERSIST_EVENT_HDR; i < len; i += n)
+            {
+                n = payload[i];
+                if (n == 0 || n > len - i || !Journal_Import(payload + i, n))
+                {
+                    break;      // 记录长度不符：其后的记录无法定位，忽略
+                }
+            }
+            Alarm_RebuildIndex();
+            break;
+            
+        case PERSIST_REC_DAY_MAX:
+            DayMaxLog_Import(payload, len);
+            break;
+            
+        case PERSIST_REC_HIST_SAMPLE:
+            if (len != 9 || payload[0] >= TOTAL_SLAVES)
+            {
+                break;
+            }
+            epoch = (unsigned long)payload[1] | ((unsigned long)payload[2] << 8) |
+                    ((unsigned long)payload[3] << 16) | ((unsigned long)payload[4] << 24);
+            if (hist_zip_len[payload[0]] == 0 && epoch <= hist_zip_last[payload[0]].epoch_min)
+            {
+                // 已在历史区中：只重建当前小时汇总
+                Rollup_Feed(payload[0], epoch, (short)((unsigned int)payload[5] | ((unsigned int)payload[6] << 8)));
+                break;
+            }
+            History_PutAt(payload[0], payload[8], (short)((unsigned int)payload[5] | ((unsigned int)payload[6] << 8)),
+                          (unsigned int)payload[7] * 100, epoch);
+            break;
+            
+        case PERSIST_REC_HIST_DELETE:
+            if (len != 5 || payload[0] >= TOTAL_SLAVES)
+            {
+                break;
+            }
+            epoch = (unsigned long)payload[1] | ((unsigned long)payload[2] << 8) |
+                    ((unsigned long)payload[3] << 16) | ((unsigned long)payload[4] << 24);
+            History_InvalidateEpoch(payload[0], epoch);
+            break;
+            
+        default:
+            break;
+    }
 }
+#endif
 
 // ------------------- 显示固定标签 -------------------
 static void DisplayFixedLabels(void)
@@ -799,6 +2744,14 @@ static void DisplayFixedLabels(void)
                 DisplayPage26();
                 break;
                 
+            case PAGE_27:
+                DisplayPage27();
+                break;
+                
+            case PAGE_28:
+                DisplayPage28();
+                break;
+                
             case PAGE_5:
             case PAGE_9:
                 DisplayDetailPage(menu_state.current_page);
@@ -816,7 +2769,8 @@ static void DisplayFixedLabels(void)
 static void DisplayPage1(void)
 {
     unsigned char i;            // 循环变量
-    DataRecord* dev_data = NULL; // 从站数据指针
+    DataRecord* dev_data = NULL; // 从站数据指针（指向dev_rec或NULL）
+    DataRecord dev_rec;          // 从站数据副本
     unsigned char dev_id_buf[8]; // 设备ID字符串缓冲区
     
     // 第0行：标题栏（从站、温度(℃)、电压(mv)）
@@ -861,7 +2815,7 @@ static void DisplayPage1(void)
         LCD_DisplayString(row, 8, dev_id_buf);
         
         // 显示温度（有效则显示数值，否则显示"--"）
-        dev_data = GetFixedSlaveData(dev->aid);
+        dev_data = GetFixedSlaveData(dev->aid, &dev_rec);
         if (dev_data != NULL && dev_data->is_valid)
         {
             LCD_DisplayNumber(row, 64, (unsigned long)dev_data->temp, 2);
@@ -877,6 +2831,10 @@ static void DisplayPage1(void)
             unsigned int volt_mv = dev_data->volt1 * 100;
             LCD_DisplayNumber(row, 88, (unsigned long)volt_mv, 4);
         }
+        else if (Live_IsOffline(dev->aid))
+        {
+            LCD_DisplayString(row, 88, (unsigned char*)"OFF ");  // 离线
+        }
         else
         {
             LCD_DisplayString(row, 88, (unsigned char*)"----");
@@ -1043,7 +3001,8 @@ static void DisplayPage3(void)
     unsigned char module_index = menu_state.page3_selected;  // 选中模块索引（0-29对应TX01-TX30）
     unsigned char tx_number = module_index + 1;             // TX编号（1-30）
     unsigned char aid = tx_number;                          // AID与TX编号一一对应
-    DataRecord* dev_data = GetRecentDataByAID(aid);         // 根据AID获取从站数据
+    DataRecord dev_rec;                                     // 从站数据副本
+    DataRecord* dev_data = GetRecentDataByAID(aid, &dev_rec); // 根据AID获取从站数据
     
     if (display_labels_initialized == 0)
     {
@@ -1104,18 +3063,21 @@ static void DisplayPage3(void)
         LCD_DisplayNumber(2, 24, dev_data->temp, 2);
     }
     
-    // 显示电压（mV）：有数据时更新，无数据显示占位符
+    // 显示电压（mV）：有数据时更新，离线显示OFF，无数据显示占位符
     if (dev_data != NULL && dev_data->is_valid)
     {
         unsigned int volt_mv = dev_data->volt1 * 100;
         LCD_DisplayNumber(4, 24, volt_mv, 4);
     }
+    else if (Live_IsOffline(aid))
+    {
+        LCD_DisplayString(4, 24, (unsigned char*)"OFF ");
+    }
 }
 
 // ------------------- PAGE_4 显示函数（传感器异常状态） -------------------
 static void DisplayPage4(void)
 {
-    DataRecord* dev_data = NULL;
     unsigned char abnormal_count = 0;  // 异常模块计数（最多显示3个）
     unsigned char i;                  // 循环变量
     
@@ -1141,14 +3103,20 @@ static void DisplayPage4(void)
     LCD_DISPLAYCHAR_NEW(6, 112, 0, 11); // "返"
     LCD_DISPLAYCHAR_NEW(6, 120, 1, 11); // "回"
     
-    // 检查所有模块，显示温度>25℃的异常模块（最多3个）
+    // 检查所有模块，显示温度>25℃的异常模块、升温速率超限未回落的模块和离线模块（最多3个）
     for (i = 0; i < TOTAL_SLAVES; i++)
     {
-        // 获取模块数据（AID从1开始）
-        dev_data = GetRecentDataByAID((unsigned char)(i + 1));
+        // 8个从站内无"有效且异常"、无升温速率超限也无离线时整字节跳过
+        if ((i & 7) == 0 &&
+            ((rt_valid_map[i >> 3] & rt_abnormal_map[i >> 3]) | ror_fired_map[i >> 3] | rt_offline_map[i >> 3]) == 0)
+        {
+            i |= 7;
+            continue;
+        }
         
-        // 检查数据是否有效且温度>25℃
-        if (dev_data != NULL && dev_data->is_valid && dev_data->temp > 25)
+        // 检查数据是否有效且温度>25℃，升温速率超限，或已离线
+        if ((RT_BIT_TEST(rt_valid_map, i) && RT_BIT_TEST(rt_abnormal_map, i)) ||
+            RT_BIT_TEST(ror_fired_map, i) || RT_BIT_TEST(rt_offline_map, i))
         {
             unsigned char row;
             // 根据异常模块数量确定显示行（0→第0行，1→第2行，2→第4行）
@@ -1161,11 +3129,22 @@ static void DisplayPage4(void)
             }
             
             // 显示PID值
-            LCD_DisplayNumber(row, 32, dev_data->pid, 2);
+            LCD_DisplayNumber(row, 32, rt_pid[i], 2);
             
-            // 显示"异常"字样
-            LCD_DISPLAYCHAR_NEW(row, 56, 1, 31);  // "异"
-            LCD_DISPLAYCHAR_NEW(row, 64, 2, 31);  // "常"
+            // 显示"异常"字样，离线显示OFF，仅升温速率超限显示ROR
+            if (RT_BIT_TEST(rt_offline_map, i))
+            {
+                LCD_DisplayString(row, 56, "OFF");
+            }
+            else if (!(RT_BIT_TEST(rt_valid_map, i) && RT_BIT_TEST(rt_abnormal_map, i)))
+            {
+                LCD_DisplayString(row, 56, "ROR");
+            }
+            else
+            {
+                LCD_DISPLAYCHAR_NEW(row, 56, 1, 31);  // "异"
+                LCD_DISPLAYCHAR_NEW(row, 64, 2, 31);  // "常"
+            }
             
             // 显示TX编号
             LCD_DisplayString(row, 88, "TX");
@@ -1501,7 +3480,7 @@ LCD_DisplayChar(row, 24, (unsigned char)('0' + event_num));
 }
 // ------------------- 显示PAGE_11(报警事件详细数据) -------------------
 static void DisplayPage11(void) {
-    unsigned char display_index;
+    AlarmRecord rec;              // 事件日志中读出的事件（局部副本）
     AlarmRecord* event = NULL;
     
     // 只在需要初始化时显示固定内容
@@ -1539,12 +3518,11 @@ static void DisplayPage11(void) {
         display_labels_initialized = 1;
     }
     
-   // 替换原有索引计算逻辑
-if (menu_state.page11_global_event_idx < alarm_event_count) {
-    // 基于全局索引计算数组实际位置
-    display_index = (alarm_event_next_index - menu_state.page11_global_event_idx - 1 + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS;
-    event = &alarm_events[display_index];
-}
+    // 按全局索引从事件日志读取（来源为PAGE_13时显示预警事件）
+    if (Event_LoadAlarm((page11_source == PAGE_13) ? EVENT_TYPE_WARNING : EVENT_TYPE_ALARM,
+                        menu_state.page11_global_event_idx, &rec)) {
+        event = &rec;
+    }
     
     // 清空数据显示区域
     LCD_DisplayString(0, 56, (unsigned char*)"  ");   // PID显示区域
@@ -1638,30 +3616,26 @@ LCD_DisplayChar(row, 24, (unsigned char)('1' + i));    // 事件编号
         display_labels_initialized = 1;
     }
     
-    // 显示预警事件数据（复用报警的显示函数，或单独实现预警数据显示）
-    DisplayAlarmEventsOnPage13(); // 新增：预警事件数据显示函数
+    // 显示预警事件数据
+    DisplayAlarmEventsOnPage13();
 }
 
 
-// 新增：PAGE_13 预警事件数据显示
-// 修复后：PAGE_13 复用报警事件数组，无需单独预警变量
+// PAGE_13 预警事件数据显示（最新在前）
 static void DisplayAlarmEventsOnPage13(void) {
     unsigned char i;
     unsigned char row;
-    unsigned char display_index;
-    AlarmRecord* event = NULL;
+    AlarmRecord rec;
+    AlarmRecord* event = &rec;
     
     for (i = 0; i < 3; i++) {
         row = i * 2;
         LCD_DisplayString(row, 64, (unsigned char*)"            "); // 清空数据区
         
-        // 复用报警事件的计数和数组（删除所有 warning_xxx 相关）
-        if (i < alarm_event_count) {
-            // 复用报警事件的索引计算逻辑（MAX_ALARM_EVENTS 已定义）
-            display_index = (alarm_event_next_index - 1 - i + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS;
-            event = &alarm_events[display_index]; // 复用报警事件数组
+        if (i < Journal_Count(EVENT_TYPE_WARNING)) {
+            Event_LoadAlarm(EVENT_TYPE_WARNING, i, &rec);
             
-            if (event != NULL && event->is_valid) {
+            if (event->is_valid) {
                 // 显示事件时间（与 PAGE_10 格式一致）
                 LCD_DisplayNumber(row, 64, event->timestamp.year, 2);
                 LCD_DisplayChar(row, 80, '-');
@@ -1737,8 +3711,8 @@ static void DisplayPage14(void) {
 static void DisplayRecoveryEventsOnPage14(void) {
     unsigned char i;
     unsigned char row;
-    unsigned char display_index;
-    RecoveryRecord* event = NULL;
+    RecoveryRecord rec;
+    RecoveryRecord* event = &rec;
 
     for (i = 0; i < 3; i++) {
         row = i * 2;
@@ -1747,11 +3721,10 @@ static void DisplayRecoveryEventsOnPage14(void) {
         LCD_DisplayString(row, 64, (unsigned char*)"            ");
         
         // 只显示有效事件（复刻报警的判断逻辑）
-        if (i < recovery_event_count) {
-            display_index = (recovery_event_next_index - 1 - i + MAX_RECOVERY_EVENTS) % MAX_RECOVERY_EVENTS;
-            event = &recovery_events[display_index];
+        if (i < Journal_Count(EVENT_TYPE_RECOVERY)) {
+            Event_LoadRecovery(i, &rec);
             
-            if (event != NULL && event->is_valid) {
+            if (event->is_valid) {
                 // 显示恢复时间（格式与报警一致）
                 LCD_DisplayNumber(row, 64, event->recovery_timestamp.year, 2);
                 LCD_DisplayChar(row, 80, '-');
@@ -1769,7 +3742,7 @@ static void DisplayRecoveryEventsOnPage14(void) {
 
 // ------------------- 显示PAGE_15(预警详细数据) -------------------
 static void DisplayPage15(void) {
-    unsigned char display_index;
+    RecoveryRecord rec;           // 事件日志中读出的事件（局部副本）
     RecoveryRecord* event = NULL;
     
     // 只在需要初始化时显示固定内容（不修改原有固定字符）
@@ -1812,9 +3785,8 @@ static void DisplayPage15(void) {
     }
     
     // 获取选中的恢复事件
-    if (menu_state.page14_selected < recovery_event_count) {
-        display_index = (recovery_event_next_index - menu_state.page14_selected - 1 + MAX_RECOVERY_EVENTS) % MAX_RECOVERY_EVENTS;
-        event = &recovery_events[display_index];
+    if (Event_LoadRecovery(menu_state.page14_selected, &rec)) {
+        event = &rec;
     }
     
     // 清空数据显示区域（原有逻辑）
@@ -1909,6 +3881,7 @@ static void DisplayPage18(void) {
     unsigned char curr_aid;      // 当前遍历的从站AID
     unsigned char dev_tx_num[8];
     DataRecord* dev_data = NULL;
+    DataRecord dev_rec;          // 从站数据副本
     static unsigned char last_start_idx = 0xFF;
     unsigned char start_idx = 0;
     
@@ -1999,7 +3972,7 @@ static void DisplayPage18(void) {
         
         // 显示PID
         if (curr_aid != 0) {
-            dev_data = GetRecentDataByAID(curr_aid);
+            dev_data = GetRecentDataByAID(curr_aid, &dev_rec);
             if (dev_data != NULL && dev_data->is_valid) {
                 LCD_DisplayNumber(row, 64, (unsigned long)dev_data->pid, 2);
             } else {
@@ -2019,13 +3992,12 @@ static void DisplayPage18(void) {
 // ------------------- 显示PAGE_19(清除历史数据确认页面) -------------------
 static void DisplayPage19(void) {
     unsigned char curr_aid = page19_selected_slave; // 接收真实AID（1-10）
-    unsigned char target_idx = page19_selected_record; // 选中的历史记录索引（0-3）
+    unsigned char target_idx = page19_selected_record; // 选中的历史记录索引（0~RECORDS_PER_SLAVE-1）
     DataRecord* hist_data = NULL;
+    DataRecord hist_view;       // 历史压缩环解码后的视图
     rtc_time_t curr_time;
-    unsigned short hist_start;
-    unsigned short hist_pos;
     unsigned char slave_idx;
-    unsigned char i;
+    unsigned char found_idx;
     
     LCD_Clear();
     GetCurrentRTC();
@@ -2037,23 +4009,11 @@ static void DisplayPage19(void) {
         slave_idx = 0; // 边界保护
     }
     
-    // 计算该从站的历史数据存储起始位置
-    hist_start = HISTORY_DATA_START + (slave_idx * RECORDS_PER_SLAVE);
-    // 自动查找当前选中索引后的第一个有效记录（避免显示无效数据）
-    for (i = 0; i < RECORDS_PER_SLAVE; i++) {
-        unsigned char check_idx = (target_idx + i) % RECORDS_PER_SLAVE;
-        hist_pos = hist_start + check_idx;
-        if (hist_pos < TOTAL_RECORDS && data_summary[hist_pos].is_valid) {
-            target_idx = check_idx;
-            page19_selected_record = check_idx; // 更新选中索引
-            break;
-        }
-    }
-    hist_pos = hist_start + target_idx;
-    
-    // 读取历史数据（判断有效性）
-    if (hist_pos < TOTAL_RECORDS && data_summary[hist_pos].is_valid) {
-        hist_data = &data_summary[hist_pos];
+    // 自动查找当前选中索引起的第一个有效记录（避免显示已删除数据）
+    found_idx = History_FindVisible(slave_idx, target_idx, &hist_view);
+    if (found_idx != HIST_SLOT_NONE) {
+        page19_selected_record = found_idx; // 更新选中索引
+        hist_data = &hist_view;
     }
     
     // 后续温度、电压、日期时间显示逻辑不变（保留原有代码）
@@ -2124,41 +4084,33 @@ static void DisplayPage19(void) {
 // uart4.c 中添加此函数
 static void DeletePage19SelectedRecord(void) {
     unsigned char curr_aid = page19_selected_slave; // 真实AID（1-10）
-    unsigned char target_idx = page19_selected_record; // 选中的记录索引（0-3）
+    unsigned char target_idx = page19_selected_record; // 选中的记录索引（0~RECORDS_PER_SLAVE-1）
     unsigned char slave_idx = curr_aid - 1; // 转换为数组索引
-    unsigned short hist_start, hist_pos;
     unsigned char i;
     unsigned char found;
+    unsigned char next_slot;
     // 边界保护
-    if (slave_idx >= TOTAL_SLAVES || target_idx < 0 || target_idx >= RECORDS_PER_SLAVE) {
+    if (slave_idx >= TOTAL_SLAVES || target_idx >= History_Count(slave_idx)) {
         return;
     }
     
-    // 1. 删除 data_summary 中对应的历史记录（关键：与PAGE_19显示数据源一致）
-    hist_start = HISTORY_DATA_START + (slave_idx * RECORDS_PER_SLAVE);
-    hist_pos = hist_start + target_idx;
-    if (hist_pos < TOTAL_RECORDS) {
-        data_summary[hist_pos].is_valid = 0; // 标记为无效
-    }
+    // 1. 删除历史压缩环中对应的记录（关键：与PAGE_19显示数据源一致）
+    History_Invalidate(slave_idx, target_idx);
     
-    // 2. 同步删除 page19_auto_records 中的记录
-    if (slave_idx < 3) {
+    // 2. 同步删除 page19_auto_records 中的记录（该数组每个从站仅4条）
+    if (slave_idx < 3 && target_idx < 4) {
         page19_auto_records[slave_idx][target_idx].is_valid = 0;
     }
     
-    // 3. 查找下一条有效记录（优先 data_summary，再 fallback 到 page19_auto_records）
+    // 3. 查找下一条有效记录（优先历史压缩环，再 fallback 到 page19_auto_records）
    found = 0;
-    // 先在 data_summary 中查找当前记录之后的有效记录
-    for (i = 1; i < RECORDS_PER_SLAVE; i++) {
-        unsigned char next_idx = (target_idx + i) % RECORDS_PER_SLAVE;
-        hist_pos = hist_start + next_idx;
-        if (hist_pos < TOTAL_RECORDS && data_summary[hist_pos].is_valid) {
-            page19_selected_record = next_idx;
-            found = 1;
-            break;
-        }
+    // 先在历史压缩环中查找当前记录之后的有效记录（当前记录已删除，从其序号起查找即可）
+    next_slot = History_FindVisible(slave_idx, target_idx, NULL);
+    if (next_slot != HIST_SLOT_NONE) {
+        page19_selected_record = next_slot;
+        found = 1;
     }
-    // 若 data_summary 中无有效记录，查找 page19_auto_records
+    // 若历史压缩环中无有效记录，查找 page19_auto_records
     if (!found && slave_idx < 3) {
         for (i = 1; i <= 4; i++) {
             unsigned char next_idx = (target_idx + i) % 4;
@@ -2171,9 +4123,11 @@ static void DeletePage19SelectedRecord(void) {
     }
     // 无任何有效记录时，保持当前索引（显示空数据）
     
-    UART4_SendString("PAGE19 record ");
-    UART4_SendNumber(target_idx, 1);
-    UART4_SendString(" deleted.\r\n");
+    if (LOG_ON(LOG_MOD_DATA, LOG_LEVEL_INFO)) {
+        UART4_SendString("PAGE19 record ");
+        UART4_SendNumber(target_idx, 1);
+        UART4_SendString(" deleted.\r\n");
+    }
 }
 
 
@@ -2361,15 +4315,8 @@ static void GetCurrentRTC(void) {
 }
 
 // 更新RTC刷新逻辑
+// need_rtc_refresh由TMR_ID_RTC定时器每RTC_REFRESH_MS置位，与主循环速度无关
 static void UpdateRTCRefresh(void) {
-    rtc_refresh_counter++;
-    
-    // 每1秒刷新一次（假设每次调用间隔约5ms，200次=1秒）
-    if (rtc_refresh_counter >= 200) {
-        rtc_refresh_counter = 0;
-        need_rtc_refresh = 1;
-    }
-    
     // 需要刷新时更新显示
     if (need_rtc_refresh && menu_state.current_page == PAGE_24) {
         GetCurrentRTC();
@@ -2527,7 +4474,10 @@ static void RTC_Save_Edit(void) {
     // 核心修复4：标记显示需要刷新
     display_labels_initialized = 0;
     
-    UART4_SendString("RTC time saved successfully! Back to select mode.\r\n");
+    if (LOG_ON(LOG_MOD_RTC, LOG_LEVEL_INFO)) {
+        UART4_SendString("RTC time saved successfully! Back to select mode.\r\n");
+    }
+    DayStat_CheckDay();   // 日期可能已改变，按新时间重新安排零点检查
     RefreshDisplay(); // 强制刷新显示，应用新状态
 }
 static void DisplayPage24(void)
@@ -2677,6 +4627,121 @@ static void DisplayPage26(void)
 
 
 
+// ------------------- PAGE_27 显示函数（通信诊断） -------------------
+// 第0~4行：链路总计数；第6行：当前选中从站的收/失败帧数（按键1/2切换从站，按键3清零）
+static void DisplayPage27(void)
+{
+    LCD_DisplayString(0, 0, (unsigned char*)"OK");     // 有效帧
+    LCD_DisplayString(0, 72, (unsigned char*)"FC");    // 校验失败
+    LCD_DisplayString(2, 0, (unsigned char*)"OV");     // 队列溢出
+    LCD_DisplayString(2, 72, (unsigned char*)"GP");    // 静默丢弃
+    LCD_DisplayString(4, 0, (unsigned char*)"ID");     // AID越界
+    LCD_DisplayString(4, 72, (unsigned char*)"SY");    // 重新同步
+    LCD_DisplayString(6, 0, (unsigned char*)"TX");
+    LCD_DisplayString(6, 40, (unsigned char*)"R");
+    LCD_DisplayString(6, 88, (unsigned char*)"F");
+    
+    UpdateDisplayForPage27();
+}
+
+// 局部刷新PAGE_27统计数值（计数超出显示位数时仅显示低位）
+static void UpdateDisplayForPage27(void)
+{
+    UART_LinkStats snap;
+    unsigned int aid_rx;
+    unsigned int aid_fail;
+    unsigned char idx = menu_state.page27_selected;
+    
+    if (idx >= TOTAL_SLAVES)
+    {
+        idx = 0;
+    }
+    
+    EA = 0;
+    snap = link_stats;
+    aid_rx = link_aid_rx[idx];
+    aid_fail = link_aid_fail[idx];
+    EA = 1;
+    
+    LCD_DisplayNumber(0, 24, snap.frames_ok, 5);
+    LCD_DisplayNumber(0, 96, snap.fcs_errors, 4);
+    LCD_DisplayNumber(2, 24, snap.queue_overruns, 4);
+    LCD_DisplayNumber(2, 96, snap.gap_discards, 4);
+    LCD_DisplayNumber(4, 24, snap.aid_rejects, 4);
+    LCD_DisplayNumber(4, 96, snap.resync_events, 4);
+    LCD_DisplayNumber(6, 16, idx + 1, 2);
+    LCD_DisplayNumber(6, 48, aid_rx, 5);
+    LCD_DisplayNumber(6, 96, aid_fail, 4);
+}
+
+
+// ------------------- PAGE_28 显示函数（从站每日统计） -------------------
+// 查看PAGE_21选中日期的单个从站统计（按键1/2切换从站）：
+// 第0行从站和日期，第2行最高温及时刻，第4行最低温和平均温度，第6行样本数
+static void DisplayPage28(void)
+{
+    LCD_DisplayString(0, 0, (unsigned char*)"TX");
+    LCD_DisplayNumber(0, 56, page28_date.mon, 2);
+    LCD_DisplayChar(0, 72, '-');
+    LCD_DisplayNumber(0, 80, page28_date.day, 2);
+    LCD_DisplayString(2, 0, (unsigned char*)"H");     // 最高温
+    LCD_DisplayString(2, 64, (unsigned char*)"T");    // 最高温时刻
+    LCD_DisplayString(4, 0, (unsigned char*)"L");     // 最低温
+    LCD_DisplayString(4, 64, (unsigned char*)"A");    // 平均温度
+    LCD_DisplayString(6, 0, (unsigned char*)"N");     // 样本数
+    
+    UpdateDisplayForPage28();
+}
+
+// 局部刷新PAGE_28统计数值（该日期不在保留范围内或该从站无样本时显示"--"）
+static void UpdateDisplayForPage28(void)
+{
+    unsigned char idx = menu_state.page28_selected;
+    unsigned char row = SlaveDay_Find(&page28_date);
+    SlaveDayStat *s = NULL;
+    
+    if (idx >= TOTAL_SLAVES)
+    {
+        idx = 0;
+    }
+    if (row != SLAVE_DAY_NONE && slave_day[row][idx].count > 0)
+    {
+        s = &slave_day[row][idx];
+    }
+    
+    LCD_DisplayNumber(0, 16, idx + 1, 2);
+    if (s != NULL)
+    {
+        DisplayTempDeci(2, 16, s->max_temp);
+        LCD_DisplayNumber(2, 80, s->max_minute / 60, 2);
+        LCD_DisplayChar(2, 96, ':');
+        LCD_DisplayNumber(2, 104, s->max_minute % 60, 2);
+        DisplayTempDeci(4, 16, s->min_temp);
+        DisplayTempDeci(4, 80, (short)(s->sum / (long)s->count));
+        LCD_DisplayNumber(6, 16, s->count, 5);
+    }
+    else
+    {
+        LCD_DisplayString(2, 16, (unsigned char*)"  -- ");
+        LCD_DisplayString(2, 80, (unsigned char*)"--:--");
+        LCD_DisplayString(4, 16, (unsigned char*)"  -- ");
+        LCD_DisplayString(4, 80, (unsigned char*)"  -- ");
+        LCD_DisplayString(6, 16, (unsigned char*)"    0");
+    }
+}
+
+// 温度显示为"±dd.d"（整数部分超过2位时只显示低2位）
+static void DisplayTempDeci(unsigned char page, unsigned char col, short temp_deci)
+{
+    unsigned int abs_deci = (temp_deci < 0) ? (unsigned int)(-temp_deci) : (unsigned int)temp_deci;
+    
+    LCD_DisplayChar(page, col, (temp_deci < 0) ? '-' : ' ');
+    LCD_DisplayNumber(page, col + 8, abs_deci / 10, 2);
+    LCD_DisplayChar(page, col + 24, '.');
+    LCD_DisplayNumber(page, col + 32, abs_deci % 10, 1);
+}
+
+
 static void DisplayDetailPage(PageType page)
 {
     LCD_Clear();
@@ -2799,68 +4864,384 @@ static void DisplayDetailPage(PageType page)
             DisplayPage25();  // 显示修改密码详情
             break;
             
-        case PAGE_26:
-            DisplayPage26();  // 显示恢复出厂设置详情
+        case PAGE_26:
+            DisplayPage26();  // 显示恢复出厂设置详情
+            break;
+            
+        default:
+            break;
+    }
+}
+
+// ------------------- UART4中断服务函数 -------------------
+void UART4_ISR(void) interrupt 18
+{
+    if (S4CON & 0x01)  // 接收中断
+    {
+        unsigned char next;
+        unsigned char i;
+        
+        S4CON &= ~0x01; // 清除接收标志
+        uart_rx_idle_ms = 0; // 总线有数据，静默计时清零
+        
+        // 滑动窗口组帧，得到有效帧后整帧写入队列，主循环批量处理
+        if (UART4_FrameFeed(S4BUF))
+        {
+            if (uart_rx_hunting)  // 失步后重新对齐
+            {
+                uart_rx_hunting = 0;
+                link_stats.resync_events++;
+            }
+            
+            next = (uart_frame_head + 1) & UART_FRAME_QUEUE_MASK;
+            if (next != uart_frame_tail)  // 队列未满：写入当前写指针槽位
+            {
+                for (i = 0; i < UART_BUFF_SIZE; i++)
+                {
+                    uart_frame_queue[uart_frame_head][i] = uart_rx_buff[i];
+                }
+                uart_frame_head = next;
+                uart_rx_complete = 1;
+                link_stats.frames_ok++;
+            }
+            else
+            {
+                link_stats.queue_overruns++;  // 队列满时丢弃该帧（窗口已由组帧清零）
+            }
+        }
+        else if (uart_rx_len == UART_BUFF_SIZE)  // 窗口已满但校验失败
+        {
+            link_stats.fcs_errors++;
+            // 首次失败时窗口仍与帧头对齐，AID字节可信，计入该从站失败数
+            if (!uart_rx_hunting)
+            {
+                uart_rx_hunting = 1;
+                if (uart_rx_buff[1] >= 1 && uart_rx_buff[1] <= TOTAL_SLAVES)
+                {
+                    link_aid_fail[uart_rx_buff[1] - 1]++;
+                }
+            }
+        }
+    }
+    
+    if (S4CON & 0x02)  // 发送中断：继续发送缓冲区中的下一字节
+    {
+        S4CON &= ~0x02; // 清除发送标志
+        
+        if (uart_tx_tail != uart_tx_head)
+        {
+            S4BUF = uart_tx_buff[uart_tx_tail];
+            uart_tx_tail = (uart_tx_tail + 1) & UART_TX_BUFF_MASK;
+        }
+        else
+        {
+            uart_tx_busy = 0;  // 缓冲区已空，发送器进入空闲
+        }
+    }
+}
+
+// 处理一帧有效数据：解析、存入摘要、报警判断（不刷新显示，由调用方按批刷新）
+static void UART4_ProcessFrame(unsigned char *frame)
+{
+    // 上位机命令帧：不参与数据存储和报警判断
+    if (frame[0] == UART_CMD_PID && frame[1] == UART_CMD_AID)
+    {
+        UART4_HandleCommand(frame);
+        return;
+    }
+    
+    Protocol_Parse(frame);
+    
+    // 调试：显示解析的数据
+    if (LOG_ON(LOG_MOD_UART, LOG_LEVEL_TRACE))
+    {
+        UART4_SendString("Parsed Data: PID=");
+        UART4_SendNumber(parsed_data.PID, 2);
+        UART4_SendString(", AID=");
+        UART4_SendNumber(parsed_data.AID, 2);
+        UART4_SendString(", Temp=");
+        UART4_SendNumber((unsigned long)parsed_data.temperature, 4);
+        UART4_SendString("\r\n");
+    }
+    
+    AddDataToSummary(parsed_data.PID, parsed_data.AID,
+                    parsed_data.temperature, parsed_data.Bat_mV);
+    
+    // 被接收的采样输出遥测记录（AID越界的帧已被AddDataToSummary拒绝）
+    if (parsed_data.AID >= 1 && parsed_data.AID <= TOTAL_SLAVES)
+    {
+        Telemetry_Emit(TELEMETRY_TYPE_SAMPLE, parsed_data.AID, parsed_data.PID,
+                       parsed_data.temperature, parsed_data.Bat_mV);
+    }
+    
+    // 检查并记录报警事件（只有本帧从站的实时数据发生变化）
+    CheckAndRecordAlarm(parsed_data.AID);
+    
+    // 调试：显示当前报警事件数量
+    if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_TRACE))
+    {
+        UART4_SendString("Alarm events count: ");
+        UART4_SendNumber(Journal_Count(EVENT_TYPE_ALARM), 2);
+        UART4_SendString("\r\n");
+    }
+}
+
+// 处理上位机命令帧（frame[2]为命令字，frame[3]/frame[4]为参数）
+static void UART4_HandleCommand(unsigned char *frame)
+{
+    unsigned char i;
+    
+    switch (frame[2])
+    {
+        case UART_CMD_DUMP_STATS:
+            UART4_DumpLinkStats();
+            break;
+            
+        case UART_CMD_CLEAR_STATS:
+            ClearLinkStats();
+            UART4_SendString("Link stats cleared.\r\n");
+            break;
+            
+        case UART_CMD_SET_TELEMETRY:
+            if (frame[3] == TELEMETRY_MODE_BINARY && telemetry_mode != TELEMETRY_MODE_BINARY)
+            {
+                UART4_SendString("Telemetry: binary\r\n");
+                // 二进制模式下关闭ASCII日志，避免文本混入记录流
+                telemetry_saved_log_level = log_level;
+                log_level = LOG_LEVEL_NONE;
+                telemetry_mode = TELEMETRY_MODE_BINARY;
+            }
+            else if (frame[3] == TELEMETRY_MODE_ASCII && telemetry_mode != TELEMETRY_MODE_ASCII)
+            {
+                telemetry_mode = TELEMETRY_MODE_ASCII;
+                log_level = telemetry_saved_log_level;
+                UART4_SendString("Telemetry: ascii\r\n");
+            }
+            break;
+            
+#if NTC_CAL_ENABLE
+        case UART_CMD_CAL_SELECT:
+        case UART_CMD_CAL_SET_B:
+        case UART_CMD_CAL_SET_R0:
+        case UART_CMD_CAL_SET_OFFSET:
+        case UART_CMD_CAL_APPLY:
+        case UART_CMD_CAL_RESET:
+        case UART_CMD_CAL_DUMP:
+            NTC_CalibCommand(frame);
+            break;
+#endif
+            
+        case UART_CMD_THR_SELECT:
+        case UART_CMD_THR_SET:
+        case UART_CMD_THR_DUMP:
+            Threshold_Command(frame);
+            break;
+            
+        case UART_CMD_HIST_EXPORT:
+            if (frame[3] >= 1 && frame[3] <= TOTAL_SLAVES)
+            {
+                History_Export(frame[3]);
+            }
+            else if (frame[3] == 0)
+            {
+                for (i = 1; i <= TOTAL_SLAVES; i++)
+                {
+                    History_Export(i);
+                }
+            }
+            UART4_SendString("History export done.\r\n");
+            break;
+            
+#if PERSIST_ENABLE
+        case UART_CMD_ROLLUP_DUMP:
+            for (i = 1; i <= TOTAL_SLAVES; i++)
+            {
+                if (frame[3] == 0 || frame[3] == i)
+                {
+                    Rollup_Export(i, frame[4] ? 1 : 0);
+                }
+            }
+            UART4_SendString("Rollup export done.\r\n");
+            break;
+#endif
+            
+        case UART_CMD_SET_HIST_LOG:
+            // 心跳间隔不小于最小记录间隔，0表示恢复默认
+            hist_log_deadband_deci = frame[3];
+            if (frame[4] == 0)
+            {
+                hist_log_max_min = HIST_LOG_MAX_MIN;
+            }
+            else
+            {
+                hist_log_max_min = (frame[4] < HIST_LOG_MIN_MIN) ? HIST_LOG_MIN_MIN : frame[4];
+            }
+            UART4_SendString("Hist log deadband=");
+            UART4_SendNumber(hist_log_deadband_deci, 3);
+            UART4_SendString(", heartbeat=");
+            UART4_SendNumber(hist_log_max_min, 3);
+            UART4_SendString("min\r\n");
+            break;
+            
+#if PERSIST_ENABLE
+        case UART_CMD_PERSIST_FORMAT:
+            // 需确认字节，防止误码触发；历史样本不再写回，只重新写入当前事件表
+            if (frame[3] != 0xA5)
+            {
+                UART4_SendString("Persist format: confirm byte 0xA5 required\r\n");
+                break;
+            }
+            IapLog_Format();
+            Persist_SaveEvents();
+            UART4_SendString("EEPROM log formatted.\r\n");
+            break;
+#endif
+            
+        case UART_CMD_SET_LIVE_TIMEOUT:
+            // 缩短超时对已挂入时间轮的从站在其原到期时刻才生效
+            live_timeout_s = (unsigned int)frame[3] | ((unsigned int)frame[4] << 8);
+            if (live_timeout_s == 0)
+            {
+                live_timeout_s = LIVE_TIMEOUT_S;
+            }
+            else if (live_timeout_s < LIVE_TIMEOUT_MIN_S)
+            {
+                live_timeout_s = LIVE_TIMEOUT_MIN_S;
+            }
+            else if (live_timeout_s > LIVE_TIMEOUT_MAX_S)
+            {
+                live_timeout_s = LIVE_TIMEOUT_MAX_S;
+            }
+            UART4_SendString("Live timeout=");
+            UART4_SendNumber(live_timeout_s, 4);
+            UART4_SendString("s\r\n");
+            break;
+            
+        case UART_CMD_SET_LOG:
+            // 级别超过编译期上限时无意义，按上限处理
+            log_level = (frame[3] > LOG_COMPILE_LEVEL) ? LOG_COMPILE_LEVEL : frame[3];
+            log_module_mask = frame[4] & LOG_MOD_ALL;
+            UART4_SendString("Log level=");
+            UART4_SendNumber(log_level, 1);
+            UART4_SendString(", mask=");
+            UART4_SendNumber(log_module_mask, 3);
+            UART4_SendString("\r\n");
             break;
             
         default:
+            UART4_SendString("Unknown command: ");
+            UART4_SendNumber(frame[2], 3);
+            UART4_SendString("\r\n");
             break;
     }
 }
 
-// ------------------- UART4中断服务函数 -------------------
-void UART4_ISR(void) interrupt 18
+// 输出通信质量统计（总计数+有数据的从站明细）
+void UART4_DumpLinkStats(void)
 {
-    if (S4CON & 0x01)  // 接收中断
+    UART_LinkStats snap;
+    unsigned int aid_rx;
+    unsigned int aid_fail;
+    unsigned int aid_offline;
+    unsigned char i;
+    
+    // 关中断复制快照，避免读到ISR修改了一半的多字节计数
+    EA = 0;
+    snap = link_stats;
+    EA = 1;
+    
+    UART4_SendString("Link stats: OK=");
+    UART4_SendNumber(snap.frames_ok, 10);
+    UART4_SendString(", FCS=");
+    UART4_SendNumber(snap.fcs_errors, 10);
+    UART4_SendString(", RESYNC=");
+    UART4_SendNumber(snap.resync_events, 10);
+    UART4_SendString(", OVR=");
+    UART4_SendNumber(snap.queue_overruns, 10);
+    UART4_SendString(", GAP=");
+    UART4_SendNumber(snap.gap_discards, 10);
+    UART4_SendString(", AID=");
+    UART4_SendNumber(snap.aid_rejects, 10);
+    UART4_SendString(", TXDROP=");
+    UART4_SendNumber(snap.tx_drops, 10);
+    UART4_SendString("\r\n");
+    
+    for (i = 0; i < TOTAL_SLAVES; i++)
     {
-        S4CON &= ~0x01; // 清除接收标志
+        EA = 0;
+        aid_rx = link_aid_rx[i];
+        aid_fail = link_aid_fail[i];
+        aid_offline = link_aid_offline[i];
+        EA = 1;
         
-        if (uart_rx_len < 6)  // 接收数据(6字节)
+        if (aid_rx == 0 && aid_fail == 0 && aid_offline == 0)
         {
-            uart_rx_buff[uart_rx_len++] = S4BUF;
-            if (uart_rx_len == 6)  // 收到6字节,设置完成标志
-            {
-                uart_rx_complete = 1;
-            }
+            continue;  // 未出现过的从站不输出
         }
-        else  // 缓冲区满,清空
+        UART4_SendString("  TX");
+        UART4_SendNumber(i + 1, 2);
+        UART4_SendString(": RX=");
+        UART4_SendNumber(aid_rx, 5);
+        UART4_SendString(", FAIL=");
+        UART4_SendNumber(aid_fail, 5);
+        UART4_SendString(", OFFLINE=");
+        UART4_SendNumber(aid_offline, 3);
+        if (live_loss_time[i][0] != 0)
         {
-            uart_rx_len = 0;
-            uart_rx_complete = 0;
+            UART4_SendString(", LAST LOSS=");
+            UART4_SendNumber(live_loss_time[i][0], 2);
+            UART4_SendString("-");
+            UART4_SendNumber(live_loss_time[i][1], 2);
+            UART4_SendString(" ");
+            UART4_SendNumber(live_loss_time[i][2], 2);
+            UART4_SendString(":");
+            UART4_SendNumber(live_loss_time[i][3], 2);
         }
+        UART4_SendString(RT_BIT_TEST(rt_offline_map, i) ? " (offline)\r\n" : "\r\n");
+    }
+}
+
+// 清零通信质量统计
+void ClearLinkStats(void)
+{
+    unsigned char i;
+    
+    EA = 0;
+    memset(&link_stats, 0, sizeof(link_stats));
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        link_aid_rx[i] = 0;
+        link_aid_fail[i] = 0;
+        link_aid_offline[i] = 0;
     }
+    EA = 1;
+    memset(live_loss_time, 0, sizeof(live_loss_time));
 }
 
 void UART4_ReceiveString(void) {
+    unsigned char batch_count = 0;  // 本次批量处理的帧数
+    bit offline_changed;            // 本次有从站离线或升温速率状态变化
+    
+    TimerWheel_Run();  // 软件定时器到期回调（RTC刷新、闪烁、历史间隔、离线超时）
     UpdateRTCRefresh(); 
     DisplayFixedLabels();
     
-	    // 新增：调用PAGE19自动读取函数
+    // 在线检测：有从站离线或升温速率状态变化时与收帧一样刷新当前页（PAGE_4需整页重绘）
+    offline_changed = live_changed;
+    live_changed = 0;
+    if (offline_changed && menu_state.current_page == PAGE_4) {
+        display_labels_initialized = 0;
+    }
     
-    if (uart_rx_complete == 1) {
-        Protocol_Parse(uart_rx_buff);
-        
-        // 调试：显示解析的数据
-        UART4_SendString("Parsed Data: PID=");
-        UART4_SendNumber(parsed_data.PID, 2);
-        UART4_SendString(", AID=");
-        UART4_SendNumber(parsed_data.AID, 2);
-        UART4_SendString(", Temp=");
-        UART4_SendNumber((unsigned long)parsed_data.temperature, 4);
-        UART4_SendString("\r\n");
-        
-        AddDataToSummary(parsed_data.PID, parsed_data.AID,
-                        TempShortToChar(parsed_data.temperature),
-                        (unsigned char)(parsed_data.Bat_Voltage * 10),
-                        0, 0);
-        
-        // 检查并记录报警事件
-        CheckAndRecordAlarm();
-        
-        // 调试：显示当前报警事件数量
-        UART4_SendString("Alarm events count: ");
-        UART4_SendNumber(alarm_event_count, 2);
-        UART4_SendString("\r\n");
+    // 批量取出队列中的全部有效帧：每帧解析/存储一次，整批只刷新一次显示
+    while (uart_frame_tail != uart_frame_head) {
+        UART4_ProcessFrame(uart_frame_queue[uart_frame_tail]);
+        uart_frame_tail = (uart_frame_tail + 1) & UART_FRAME_QUEUE_MASK;  // 处理完再释放槽位
+        batch_count++;
+    }
+    
+    if (batch_count > 0 || offline_changed) {
+        uart_rx_complete = 0;
         
         if (menu_state.current_page == PAGE_1) {
             UpdateDisplayForPage1(); 
@@ -2872,16 +5253,16 @@ void UART4_ReceiveString(void) {
         else if (menu_state.current_page == PAGE_14) {
             DisplayRecoveryEventsOnPage14(); // 新增：刷新PAGE_14恢复事件
         } 
-        else if (menu_state.current_page == PAGE_25 && pwd_flash_state) {
-            DisplayPassword(); // 仅在闪烁中时刷新，提升效率
+        else if (menu_state.current_page == PAGE_27) {
+            UpdateDisplayForPage27(); // 刷新通信诊断统计
+        }
+        else if (menu_state.current_page == PAGE_28) {
+            UpdateDisplayForPage28(); // 刷新从站每日统计
         }
 //          else if (menu_state.current_page == PAGE_21) {
 //            display_labels_initialized = 0;  // 强制重新绘制
 //            DisplayFixedLabels();
 //        }
-        UART4_ClearBuffer(uart_rx_buff, 6);
-        uart_rx_complete = 0;
-        uart_rx_len = 0;
     }
 }
 
@@ -2890,6 +5271,7 @@ void UART4_ReceiveString(void) {
 static void UpdateDisplayForPage1(void) {
     unsigned char i;
     DataRecord* dev_data = NULL;
+    DataRecord dev_rec;
     unsigned char dev_id_buf[8];
 
     // 仅刷新第2行、第4行的有效数据
@@ -2909,7 +5291,7 @@ static void UpdateDisplayForPage1(void) {
         LCD_DisplayString(row, 8, dev_id_buf);
 
         // 刷新温度
-        dev_data = GetFixedSlaveData(dev->aid);
+        dev_data = GetFixedSlaveData(dev->aid, &dev_rec);
         if (dev_data != NULL && dev_data->is_valid) {
             LCD_DisplayNumber(row, 64, (unsigned long)dev_data->temp, 2);
         } else {
@@ -2920,6 +5302,8 @@ static void UpdateDisplayForPage1(void) {
         if (dev_data != NULL && dev_data->is_valid) {
             unsigned int volt_mv = dev_data->volt1 * 100;
             LCD_DisplayNumber(row, 88, (unsigned long)volt_mv, 4);
+        } else if (Live_IsOffline(dev->aid)) {
+            LCD_DisplayString(row, 88, (unsigned char*)"OFF ");  // 离线
         } else {
             LCD_DisplayString(row, 88, (unsigned char*)"----");
         }
@@ -2938,7 +5322,8 @@ static void UpdateDisplayForPage3(void) {
     unsigned char module_index = menu_state.page3_selected;
     unsigned char tx_number = module_index + 1;
     unsigned char aid = tx_number;
-    DataRecord* dev_data = GetRecentDataByAID(aid);
+    DataRecord dev_rec;
+    DataRecord* dev_data = GetRecentDataByAID(aid, &dev_rec);
     
     // 刷新TX编号（固定）
     LCD_DisplayNumber(0, 96, tx_number, 2);
@@ -2961,6 +5346,8 @@ static void UpdateDisplayForPage3(void) {
     if (dev_data != NULL && dev_data->is_valid) {
         unsigned int volt_mv = dev_data->volt1 * 100;
         LCD_DisplayNumber(4, 24, volt_mv, 4);
+    } else if (Live_IsOffline(aid)) {
+        LCD_DisplayString(4, 24, (unsigned char*)"OFF ");  // 离线
     } else {
         LCD_DisplayString(4, 24, (unsigned char*)"----");
     }
@@ -2973,6 +5360,7 @@ void LCD_HandleKey(unsigned char key) {
     unsigned char curr_aid;
     static unsigned char pwd_back_count = 0;
     unsigned char actual_index;
+    DailyMaxTemp day_rec;
     
     // 局部变量声明前置（C89/C90标准要求）
     current_page = menu_state.current_page;
@@ -2988,6 +5376,22 @@ void LCD_HandleKey(unsigned char key) {
                 display_labels_initialized = 0;
             } else if (current_page == PAGE_2) {
                 HandlePrevItem();
+            } else if (current_page == PAGE_27) {
+                if (menu_state.page27_selected > 0) {
+                    menu_state.page27_selected--;
+                } else {
+                    menu_state.page27_selected = TOTAL_SLAVES - 1;
+                }
+                UpdateDisplayForPage27();
+                return;
+            } else if (current_page == PAGE_28) {
+                if (menu_state.page28_selected > 0) {
+                    menu_state.page28_selected--;
+                } else {
+                    menu_state.page28_selected = TOTAL_SLAVES - 1;
+                }
+                UpdateDisplayForPage28();
+                return;
             } else if (current_page == PAGE_16) {
                 DeleteRecoveryEvent(menu_state.page14_selected);
                 menu_state.current_page = PAGE_14;
@@ -2999,7 +5403,8 @@ void LCD_HandleKey(unsigned char key) {
                 if (page19_selected_record > 0) {
                     page19_selected_record--;
                 } else {
-                    page19_selected_record = 3;
+                    unsigned char hist_count = History_Count(page19_selected_slave - 1);
+                    page19_selected_record = (hist_count > 0) ? hist_count - 1 : 0;
                 }
                 display_labels_initialized = 0;
                 return;
@@ -3038,10 +5443,12 @@ void LCD_HandleKey(unsigned char key) {
                 menu_state.page_changed = 1;
                 display_labels_initialized = 0;
             } else if (current_page == PAGE_12) {
-                if (menu_state.page10_selected < alarm_event_count) {
-                    DeleteAlarmEvent(menu_state.page10_selected);
+                if (page11_source == PAGE_13) {
+                    DeleteWarningEvent(menu_state.page11_global_event_idx);
+                } else {
+                    DeleteAlarmEvent(menu_state.page11_global_event_idx);
                 }
-                menu_state.current_page = PAGE_10;
+                menu_state.current_page = page11_source;
                 menu_state.page_changed = 1;
                 display_labels_initialized = 0;
                 return;
@@ -3071,9 +5478,11 @@ void LCD_HandleKey(unsigned char key) {
                 menu_state.page_changed = 1;
                 DisplayPage21();
                 RefreshDisplay();
-                UART4_SendString("PAGE_23: Max temp ");
-                UART4_SendNumber(actual_index, 1);
-                UART4_SendString(" deleted.\r\n");
+                if (LOG_ON(LOG_MOD_DATA, LOG_LEVEL_INFO)) {
+                    UART4_SendString("PAGE_23: Max temp ");
+                    UART4_SendNumber(actual_index, 1);
+                    UART4_SendString(" deleted.\r\n");
+                }
                 return;
             } else {
                 HandlePrevItem();
@@ -3090,8 +5499,23 @@ void LCD_HandleKey(unsigned char key) {
                 display_labels_initialized = 0;
             } else if (current_page == PAGE_2) {
                 HandleNextItem();
+            } else if (current_page == PAGE_5) {
+                // 参数查询下一页：通信诊断
+                menu_state.current_page = PAGE_27;
+                menu_state.page27_selected = 0;
+                menu_state.page_changed = 1;
+                display_labels_initialized = 0;
+            } else if (current_page == PAGE_27) {
+                menu_state.page27_selected = (menu_state.page27_selected + 1) % TOTAL_SLAVES;
+                UpdateDisplayForPage27();
+                return;
+            } else if (current_page == PAGE_28) {
+                menu_state.page28_selected = (menu_state.page28_selected + 1) % TOTAL_SLAVES;
+                UpdateDisplayForPage28();
+                return;
             } else if (current_page == PAGE_19) {
-                page19_selected_record = (page19_selected_record + 1) % 4;
+                unsigned char hist_count = History_Count(page19_selected_slave - 1);
+                page19_selected_record = (hist_count > 0) ? (page19_selected_record + 1) % hist_count : 0;
                 display_labels_initialized = 0;
                 return;
             } else if (current_page == PAGE_20) {
@@ -3129,7 +5553,7 @@ void LCD_HandleKey(unsigned char key) {
                 HandleNextItem();
                 return;
             } else if (current_page == PAGE_11) {
-                menu_state.current_page = PAGE_10;
+                menu_state.current_page = page11_source;
                 menu_state.page_changed = 1;
                 display_labels_initialized = 0;
             } else if (current_page == PAGE_12) {
@@ -3175,13 +5599,22 @@ void LCD_HandleKey(unsigned char key) {
                 display_labels_initialized = 0;
             } else if (current_page == PAGE_21) {
                 if (menu_state.page21_selected < 3 && 
-                    daily_max_temps[menu_state.page21_selected].is_valid && 
-                    daily_max_temps[menu_state.page21_selected].max_temp != -990) {
+                    max_temps[menu_state.page21_selected] != -990) {
                     menu_state.current_page = PAGE_22;
                     menu_state.page22_selected = 0;
                     menu_state.page_changed = 1;
                     display_labels_initialized = 0;
                 }
+            } else if (current_page == PAGE_22) {
+                // 查看该日期各从站统计，从当天最高温所在从站开始（该日期已滚出保留范围时不进入）
+                if (Event_LoadDayMax(menu_state.page21_selected, &day_rec) &&
+                    SlaveDay_Find(&day_rec.temp_time) != SLAVE_DAY_NONE) {
+                    page28_date = day_rec.temp_time;
+                    menu_state.page28_selected = (day_rec.aid >= 1 && day_rec.aid <= TOTAL_SLAVES) ? day_rec.aid - 1 : 0;
+                    menu_state.current_page = PAGE_28;
+                    menu_state.page_changed = 1;
+                    display_labels_initialized = 0;
+                }
             } else if (current_page == PAGE_24) {
                 if (rtc_edit_state == RTC_EDIT_IDLE) {
                     RTC_Edit_Init();
@@ -3210,16 +5643,23 @@ void LCD_HandleKey(unsigned char key) {
                 menu_state.current_page = PAGE_5;
                 menu_state.page_changed = 1;
                 display_labels_initialized = 0;
+            } else if (current_page == PAGE_27) {
+                ClearLinkStats();
+                UpdateDisplayForPage27();
+                return;
             } else if (current_page == PAGE_10) {
                 unsigned char global_event_idx = page10_scroll_page * PAGE10_DISPLAY_COUNT + menu_state.page10_selected;
                 menu_state.page11_global_event_idx = global_event_idx;
                 menu_state.prev_page = PAGE_10;
+                page11_source = PAGE_10;
                 menu_state.current_page = PAGE_11;
                 menu_state.page11_selected = 0;
                 menu_state.page_changed = 1;
                 display_labels_initialized = 0;
             } else if (current_page == PAGE_13) {
                 menu_state.prev_page = PAGE_13;
+                menu_state.page11_global_event_idx = menu_state.page13_selected;
+                page11_source = PAGE_13;
                 menu_state.current_page = PAGE_11;
                 menu_state.page15_selected = 0;
                 menu_state.page_changed = 1;
@@ -3316,6 +5756,7 @@ void LCD_HandleKey(unsigned char key) {
                     break;
                     
                 case PAGE_9:
+                case PAGE_27:
                     menu_state.current_page = PAGE_5;
                     menu_state.page_changed = 1;
                     display_labels_initialized = 0;
@@ -3353,6 +5794,12 @@ void LCD_HandleKey(unsigned char key) {
                     display_labels_initialized = 0;
                     break;
                     
+                case PAGE_28:
+                    menu_state.current_page = PAGE_22;
+                    menu_state.page_changed = 1;
+                    display_labels_initialized = 0;
+                    break;
+                    
                 case PAGE_24:
                 case PAGE_25:
                     menu_state.current_page = PAGE_8;
@@ -3567,7 +6014,7 @@ static void HandleNextItem(void)
             } else {
                 // 下翻页：当前页最后一项→切换到下一页，选中项设为新页第一个
                 if (page10_scroll_page < PAGE10_MAX_PAGE - 1 && 
-                    (page10_scroll_page + 1) * PAGE10_DISPLAY_COUNT < alarm_event_count) {
+                    (unsigned int)((page10_scroll_page + 1) * PAGE10_DISPLAY_COUNT) < Journal_Count(EVENT_TYPE_ALARM)) {
                     page10_scroll_page++;
                     menu_state.page10_selected = 0;  // 新页选中第1项（索引0）
                     display_labels_initialized = 0;  // 翻页需重绘固定标签
@@ -3809,6 +6256,7 @@ static void HandleReturnKey(void)
             break;
             
         case PAGE_9:
+        case PAGE_27:
             menu_state.current_page = PAGE_5;
             menu_state.page_changed = 1;
             display_labels_initialized = 0;
@@ -3864,6 +6312,7 @@ static void HandleReturnKey(void)
             break;
             
         case PAGE_23:  // 新增：从PAGE_23返回PAGE_22
+        case PAGE_28:
             menu_state.current_page = PAGE_22;
             menu_state.page_changed = 1;
             display_labels_initialized = 0;
@@ -3915,125 +6364,208 @@ static void RefreshDisplay(void) {
     }
 }
 
-// 检查并记录报警事件
 // 检查并记录报警事件（原函数名不变，补充恢复事件记录）
-static void CheckAndRecordAlarm(void) {
+// 每帧只有该帧从站的实时数据变化，其余从站的判断结果不变，因此只判断本帧从站；
+// 删除/清空报警事件会改变其余从站的判断依据，之后的第一帧检查全部从站一次
+static void CheckAndRecordAlarm(unsigned char aid) {
     unsigned char i;
-    DataRecord* dev_data = NULL;
-    unsigned char current_abnormal = 0;
     
-    for (i = 0; i < TOTAL_SLAVES; i++) {
-dev_data = GetRecentDataByAID((unsigned char)(i + 1));
-        
-        if (dev_data != NULL && dev_data->is_valid) {
-            current_abnormal = (dev_data->temp > 25) ? 1 : 0;
+    if (alarm_rescan) {
+        alarm_rescan = 0;
+        for (i = 0; i < TOTAL_SLAVES; i++) {
+            Alarm_Evaluate(i);
+        }
+    } else if (aid >= 1 && aid <= TOTAL_SLAVES) {
+        Alarm_Evaluate(aid - 1);
+    }
+}
+
+// 按单个从站的实时数据判断报警/恢复：首次异常记录报警，持续异常更新最高温，恢复正常记录恢复事件
+// 该从站的报警事件由alarm_open引用直接读取，无需在事件日志中按AID查找
+static void Alarm_Evaluate(unsigned char i) {
+    JournalEntry e;
+    EvAlarmData alarm;          // 该从站最新一条报警事件的数据
+    bit has_event;
+    unsigned char cur_temp;     // 当前温度（整数℃，报警记录格式）
+    
+    if (!RT_BIT_TEST(rt_valid_map, i)) {
+        return;
+    }
+    cur_temp = TempShortToChar(rt_temp_deci[i]);
+    has_event = Journal_Read(&alarm_open[i], &e);
+    if (has_event) {
+        memcpy(&alarm, e.dat, sizeof(EvAlarmData));
+    }
+    
+    if (RT_BIT_TEST(rt_abnormal_map, i)) {
+        // 温度>25℃：异常状态
+        if (last_abnormal_status[i] == 0) {
+            // 首次进入异常：生成新报警事件
+            RecordAlarmEvent(rt_pid[i], (unsigned char)(i + 1), cur_temp, rt_volt_mv[i]);
+            last_abnormal_status[i] = 1;
+            Persist_SaveEvents();
             
-            if (current_abnormal == 1) {
-                // 温度>25℃：异常状态
-                if (last_abnormal_status[i] == 0) {
-                    // 首次进入异常：生成新报警事件
-                    RecordAlarmEvent(dev_data->pid, (unsigned char)(i + 1), dev_data->temp, dev_data->volt1 * 100);
-                    last_abnormal_status[i] = 1;
-                    
-                    // 调试信息：确认报警被记录
-                    UART4_SendString("Alarm recorded: AID=");
-                    UART4_SendNumber(i + 1, 2);
-                    UART4_SendString(", Temp=");
-                    UART4_SendNumber(dev_data->temp, 2);
-                    UART4_SendString("\r\n");
-                } else {
-                    // 持续异常：更新为当前最高温（核心新增逻辑）
-                    unsigned char j, alarm_idx;
-                    // 查找该从站（AID=i+1）对应的最新有效报警事件
-                    for (j = 0; j < alarm_event_count; j++) {
-                        alarm_idx = (alarm_event_next_index - j - 1 + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS;
-                        // 匹配AID且事件有效
-                        if (alarm_events[alarm_idx].is_valid && alarm_events[alarm_idx].aid == (i + 1)) {
-                            // 当前温度更高时更新
-                            if (dev_data->temp > alarm_events[alarm_idx].temp) {
-                                alarm_events[alarm_idx].temp = dev_data->temp; // 更新最高温
-                                alarm_events[alarm_idx].volt_mv = dev_data->volt1 * 100; // 同步更新电压（可选）
-                                GetCurrentRTC();
-                                alarm_events[alarm_idx].timestamp = current_rtc_time; // 同步更新时间戳（可选）
-                                
-                                // 调试信息：确认温度更新
-                                UART4_SendString("Alarm updated: AID=");
-                                UART4_SendNumber(i + 1, 2);
-                                UART4_SendString(", New Temp=");
-                                UART4_SendNumber(dev_data->temp, 2);
-                                UART4_SendString("\r\n");
-                            }
-                            break; // 找到最新事件后退出，避免重复更新
-                        }
-                    }
-                }
-            } else if (current_abnormal == 0 && last_abnormal_status[i] == 1) {
-                // 温度≤25℃且之前是异常：记录恢复事件（原有逻辑不变）
-                unsigned char j, alarm_idx;
-                for (j = 0; j < alarm_event_count; j++) {
-                    alarm_idx = (alarm_event_next_index - j - 1 + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS;
-                    if (alarm_events[alarm_idx].is_valid && alarm_events[alarm_idx].aid == (i + 1)) {
-                        RecordRecoveryEvent(
-                            dev_data->pid,
-                            (unsigned char)(i + 1),
-                            alarm_events[alarm_idx].temp, // 记录最终最高温作为异常温度
-                            dev_data->temp,
-                            dev_data->volt1 * 100,
-                            alarm_events[alarm_idx].timestamp
-                        );
-                        UART4_SendString("Recovery recorded: AID=");
-                        UART4_SendNumber(i + 1, 2);
-                        UART4_SendString(", Recovery Temp=");
-                        UART4_SendNumber(dev_data->temp, 2);
-                        UART4_SendString("\r\n");
-                        break;
-                    }
-                }
-                last_abnormal_status[i] = 0;
+            // 调试信息：确认报警被记录
+            if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_INFO)) {
+                UART4_SendString("Alarm recorded: AID=");
+                UART4_SendNumber(i + 1, 2);
+                UART4_SendString(", Temp=");
+                UART4_SendNumber(cur_temp, 2);
+                UART4_SendString("\r\n");
             }
+        } else if (has_event && cur_temp > alarm.temp) {
+            // 持续异常且当前温度更高：原位更新为当前最高温
+            alarm.temp = cur_temp; // 更新最高温
+            alarm.volt_mv = rt_volt_mv[i]; // 同步更新电压（可选）
+            GetCurrentRTC();
+            Journal_Update(&alarm_open[i], &current_rtc_time, &alarm); // 同步更新时间戳（可选）
+            Persist_SaveEvents();
+            
+            // 调试信息：确认温度更新
+            if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_TRACE)) {
+                UART4_SendString("Alarm updated: AID=");
+                UART4_SendNumber(i + 1, 2);
+                UART4_SendString(", New Temp=");
+                UART4_SendNumber(cur_temp, 2);
+                UART4_SendString("\r\n");
+            }
+        }
+    } else if (last_abnormal_status[i] == 1) {
+        // 温度≤25℃且之前是异常：记录恢复事件（报警事件已被删除或丢弃时不记录）
+        if (has_event) {
+            RecordRecoveryEvent(
+                rt_pid[i],
+                (unsigned char)(i + 1),
+                alarm.temp, // 记录最终最高温作为异常温度
+                cur_temp,
+                rt_volt_mv[i],
+                e.time
+            );
+            if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_INFO)) {
+                UART4_SendString("Recovery recorded: AID=");
+                UART4_SendNumber(i + 1, 2);
+                UART4_SendString(", Recovery Temp=");
+                UART4_SendNumber(cur_temp, 2);
+                UART4_SendString("\r\n");
+            }
+        }
+        last_abnormal_status[i] = 0;
+        Persist_SaveEvents();
+    }
+}
+
+// 按事件日志重建各从站的最新报警事件引用：从旧到新遍历，
+// 每个从站最后一次赋值即其最新一条事件（删除了某从站的最新事件/回放后调用）
+static void Alarm_RebuildIndex(void) {
+    unsigned char i;
+    JournalIter it;
+    JournalEntry e;
+    
+    for (i = 0; i < TOTAL_SLAVES; i++) {
+        alarm_open[i].pos = JOURNAL_POS_NONE;
+    }
+    Journal_IterBegin(&it, EVENT_TYPE_ALARM, 0);
+    while (Journal_Next(&it, &e)) {
+        if (e.aid >= 1 && e.aid <= TOTAL_SLAVES) {
+            alarm_open[e.aid - 1] = e.ref;
         }
     }
 }
-// 记录报警事件
+
+// 记录报警事件（日志满时丢弃最旧的记录，被丢弃的alarm_open引用读取失败，无需另行清除）
 static void RecordAlarmEvent(unsigned char pid, unsigned char aid, unsigned char temp, unsigned int volt_mv) {
+    EvAlarmData alarm;
+    JournalRef ref;
+    
     // 强制读取最新RTC时间（避免时间为空）
     GetCurrentRTC();
     
-    alarm_events[alarm_event_next_index].pid = pid;
-    alarm_events[alarm_event_next_index].aid = aid;
-    alarm_events[alarm_event_next_index].temp = temp;
-    alarm_events[alarm_event_next_index].volt_mv = volt_mv;
-    alarm_events[alarm_event_next_index].timestamp = current_rtc_time;
-    alarm_events[alarm_event_next_index].is_valid = 1;
+    alarm.pid = pid;
+    alarm.temp = temp;
+    alarm.volt_mv = volt_mv;
+    Journal_Append(EVENT_TYPE_ALARM, aid, &current_rtc_time, &alarm, sizeof(EvAlarmData), &ref);
+    if (aid >= 1 && aid <= TOTAL_SLAVES) {
+        alarm_open[aid - 1] = ref;
+    }
     
     // 保存到历史数据
     AddToHistoryData(pid, aid, temp, volt_mv);
     
-    // 更新索引（循环覆盖）
-    alarm_event_next_index = (alarm_event_next_index + 1) % MAX_ALARM_EVENTS;
+    Telemetry_Emit(TELEMETRY_TYPE_ALARM, aid, pid, (short)temp * 10, volt_mv);
+    
+    // 调试信息：输出报警事件序号和时间
+    if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_TRACE)) {
+        UART4_SendString("Alarm seq=");
+        UART4_SendNumber(ref.seq, 5);
+        UART4_SendString(", Time=");
+        UART4_SendNumber(current_rtc_time.year, 2);
+        UART4_SendString("-");
+        UART4_SendNumber(current_rtc_time.mon, 2);
+        UART4_SendString("-");
+        UART4_SendNumber(current_rtc_time.day, 2);
+        UART4_SendString("\r\n");
+    }
+}
+
+// 记录升温速率事件（平均升温速率超过限值时调用，回落到限值一半以下之前不重复记录）
+static void RecordRateRiseEvent(unsigned char slave_idx, short temp_deci, short rate) {
+    EvRateData ror;
     
-    if (alarm_event_count < MAX_ALARM_EVENTS) {
-        alarm_event_count++;
+    GetCurrentRTC();
+    ror.pid = rt_pid[slave_idx];
+    ror.temp = TempShortToChar(temp_deci);
+    ror.rate = (unsigned int)rate;
+    Journal_Append(EVENT_TYPE_RATE_RISE, slave_idx + 1, &current_rtc_time, &ror, sizeof(EvRateData), NULL);
+    Persist_SaveEvents();
+    
+    Telemetry_Emit(TELEMETRY_TYPE_RATE_RISE, slave_idx + 1, rt_pid[slave_idx], temp_deci, ror.rate);
+    if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_WARN)) {
+        UART4_SendString("Rate of rise: AID=");
+        UART4_SendNumber(slave_idx + 1, 2);
+        UART4_SendString(", ");
+        UART4_SendNumber(ror.rate, 4);
+        UART4_SendString(" x0.1C/min\r\n");
     }
+}
+
+// 记录预警事件（从正常进入预警或报警时调用，新样本已写入rt_xxx）
+static void RecordWarningEvent(unsigned char slave_idx, short temp_deci) {
+    EvAlarmData warning;
     
-    // 调试信息：输出报警事件索引和时间
-    UART4_SendString("Alarm index=");
-    UART4_SendNumber(alarm_event_next_index, 1);
-    UART4_SendString(", Time=");
-    UART4_SendNumber(current_rtc_time.year, 2);
-    UART4_SendString("-");
-    UART4_SendNumber(current_rtc_time.mon, 2);
-    UART4_SendString("-");
-    UART4_SendNumber(current_rtc_time.day, 2);
-    UART4_SendString("\r\n");
+    GetCurrentRTC();
+    warning.pid = rt_pid[slave_idx];
+    warning.temp = TempShortToChar(temp_deci);
+    warning.volt_mv = rt_volt_mv[slave_idx];
+    Journal_Append(EVENT_TYPE_WARNING, slave_idx + 1, &current_rtc_time, &warning, sizeof(EvAlarmData), NULL);
+    Persist_SaveEvents();
+    
+    Telemetry_Emit(TELEMETRY_TYPE_WARNING, slave_idx + 1, rt_pid[slave_idx], temp_deci, rt_volt_mv[slave_idx]);
+    if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_INFO)) {
+        UART4_SendString("Warning recorded: AID=");
+        UART4_SendNumber(slave_idx + 1, 2);
+        UART4_SendString(", Temp=");
+        UART4_SendNumber(warning.temp, 2);
+        UART4_SendString("\r\n");
+    }
+}
+
+// 删除指定预警事件（display_index：0=最新）
+static void DeleteWarningEvent(unsigned char display_index) {
+    JournalEntry e;
+    
+    if (Journal_FindNewest(EVENT_TYPE_WARNING, 0, display_index, &e)) {
+        Journal_Delete(&e.ref);
+        Persist_SaveEvents();
+    }
 }
 
 // 在PAGE_10上显示报警事件
 static void DisplayAlarmEventsOnPage10(void) {
     unsigned char i;
     unsigned char row;
-    unsigned char display_index;
-    AlarmRecord* event = NULL;
+    unsigned int count = Journal_Count(EVENT_TYPE_ALARM);
+    AlarmRecord rec;
+    AlarmRecord* event = &rec;
     unsigned char start_idx = page10_scroll_page * PAGE10_DISPLAY_COUNT;  // 当前页起始事件索引
     
     for (i = 0; i < PAGE10_DISPLAY_COUNT; i++) {
@@ -4041,12 +6573,11 @@ static void DisplayAlarmEventsOnPage10(void) {
         LCD_DisplayString(row, 64, (unsigned char*)"            "); // 清空数据区
         
         // 仅显示有效事件（当前页索引 < 总事件数）
-        if ((start_idx + i) < alarm_event_count) {
-            // 计算事件在数组中的实际索引（最新事件在前，循环队列逻辑）
-            display_index = (alarm_event_next_index - 1 - (start_idx + i) + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS;
-            event = &alarm_events[display_index];
+        if ((start_idx + i) < count) {
+            // 按显示位置读取（最新事件在前）
+            Event_LoadAlarm(EVENT_TYPE_ALARM, start_idx + i, &rec);
             
-            if (event != NULL && event->is_valid) {
+            if (event->is_valid) {
                 // 显示事件时间（年-月-日格式）
                 LCD_DisplayNumber(row, 64, event->timestamp.year, 2);
                 LCD_DisplayChar(row, 80, '-');
@@ -4074,73 +6605,33 @@ static void DisplayAlarmEventsOnPage10(void) {
 
 // 添加数据到历史记录
 static void AddToHistoryData(unsigned char pid, unsigned char aid, unsigned int temp, unsigned int volt_mv) {
-    unsigned char slave_idx;
-    unsigned short hist_start;
-    unsigned char hist_idx;
-    unsigned short hist_pos;
-    
     if (aid < 1 || aid > TOTAL_SLAVES) {
         return;
     }
     
-    slave_idx = aid - 1;
-    hist_start = HISTORY_DATA_START + (slave_idx * RECORDS_PER_SLAVE);
-    hist_idx = history_index[slave_idx];
-    hist_pos = hist_start + hist_idx;
-    
-    if (hist_pos < TOTAL_RECORDS) {
-        data_summary[hist_pos].pid = pid;
-        data_summary[hist_pos].aid = aid;
-        data_summary[hist_pos].temp = temp;
-        data_summary[hist_pos].volt1 = (unsigned char)(volt_mv / 100);
-        data_summary[hist_pos].timestamp = GetSystemTick();
-        data_summary[hist_pos].is_valid = 1;
-        
-        history_index[slave_idx] = (hist_idx + 1) % RECORDS_PER_SLAVE;
-    }
+    History_Put(aid - 1, pid, (short)temp * 10, volt_mv);
 }
 
 
 
 // ------------------- 删除指定报警事件 -------------------
+// 任意位置均可删除（只置删除标志）；只有删除的正是某从站最新一条事件时才重建该从站的引用
 void DeleteAlarmEvent(unsigned char display_index) {
-    unsigned char actual_index;
-    unsigned char i;
-	  unsigned char idx;
-	  unsigned char j;
-    if (display_index >= alarm_event_count) {
+    JournalEntry e;
+    
+    if (!Journal_FindNewest(EVENT_TYPE_ALARM, 0, display_index, &e)) {
         return; // 无效索引
     }
     
-    // 计算实际数组索引（最新的在前面）
-    actual_index = (alarm_event_next_index - display_index - 1 + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS;
+    Journal_Delete(&e.ref);
+    if (e.aid >= 1 && e.aid <= TOTAL_SLAVES &&
+        alarm_open[e.aid - 1].pos == e.ref.pos && alarm_open[e.aid - 1].seq == e.ref.seq) {
+        Alarm_RebuildIndex();
+    }
+    alarm_rescan = 1;
+    Persist_SaveEvents();
     
-    if (alarm_events[actual_index].is_valid) {
-        // 标记为无效
-        alarm_events[actual_index].is_valid = 0;
-        
-        // 如果是循环队列中的最后一个有效事件，减少计数
-        if (display_index == 0 && alarm_event_count > 0) {
-            // 移动索引，覆盖被删除的事件
-            alarm_event_next_index = (alarm_event_next_index - 1 + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS;
-            alarm_event_count--;
-            
-            // 更新其他事件的显示索引
-            for (i = 0; i < alarm_event_count; i++) {
-                idx = (alarm_event_next_index - i - 1 + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS;
-                if (!alarm_events[idx].is_valid) {
-                    // 找到下一个有效事件
-                    for (j = idx; j != alarm_event_next_index; j = (j - 1 + MAX_ALARM_EVENTS) % MAX_ALARM_EVENTS) {
-                        if (alarm_events[(j + 1) % MAX_ALARM_EVENTS].is_valid) {
-                            // 复制下一个有效事件到当前位置
-                            alarm_events[j] = alarm_events[(j + 1) % MAX_ALARM_EVENTS];
-                            alarm_events[(j + 1) % MAX_ALARM_EVENTS].is_valid = 0;
-                        }
-                    }
-                }
-            }
-        }
-        
+    if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_INFO)) {
         UART4_SendString("Alarm event deleted.\r\n");
     }
 }
@@ -4149,21 +6640,106 @@ void DeleteAlarmEvent(unsigned char display_index) {
 void ClearAllAlarmEvents(void) {
     unsigned char i;
     
-    for (i = 0; i < MAX_ALARM_EVENTS; i++) {
-        alarm_events[i].is_valid = 0;
-    }
-    
-    alarm_event_count = 0;
-    alarm_event_next_index = 0;
+    Journal_DeleteAll(EVENT_TYPE_ALARM);
     
-    // 重置报警状态跟踪数组
+    // 重置报警状态跟踪数组（仍超温的从站在下一帧重新记录报警）
     for (i = 0; i < TOTAL_SLAVES; i++) {
         last_abnormal_status[i] = 0;
+        alarm_open[i].pos = JOURNAL_POS_NONE;
     }
+    alarm_rescan = 1;
+    Persist_SaveEvents();
     
-    UART4_SendString("All alarm events cleared.\r\n");
+    if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_INFO)) {
+        UART4_SendString("All alarm events cleared.\r\n");
+    }
+}
+
+
+// ------------------- 事件日志视图 -------------------
+// 各列表/详情页面按类型读取第nth条最新事件（0=最新），转换为原显示结构体的局部副本
+static bit Event_LoadAlarm(unsigned char type, unsigned char nth, AlarmRecord *rec) {
+    JournalEntry e;
+    EvAlarmData alarm;
+    
+    rec->is_valid = 0;
+    if (!Journal_FindNewest(type, 0, nth, &e)) {
+        return 0;
+    }
+    memcpy(&alarm, e.dat, sizeof(EvAlarmData));
+    rec->pid = alarm.pid;
+    rec->aid = e.aid;
+    rec->temp = alarm.temp;
+    rec->volt_mv = alarm.volt_mv;
+    rec->timestamp = e.time;
+    rec->is_valid = 1;
+    return 1;
+}
+
+static bit Event_LoadRecovery(unsigned char nth, RecoveryRecord *rec) {
+    JournalEntry e;
+    EvRecoveryData recovery;
+    
+    rec->is_valid = 0;
+    if (!Journal_FindNewest(EVENT_TYPE_RECOVERY, 0, nth, &e)) {
+        return 0;
+    }
+    memcpy(&recovery, e.dat, sizeof(EvRecoveryData));
+    rec->pid = recovery.pid;
+    rec->aid = e.aid;
+    rec->abnormal_temp = recovery.abnormal_temp;
+    rec->recovery_temp = recovery.recovery_temp;
+    rec->recovery_volt_mv = recovery.recovery_volt_mv;
+    rec->abnormal_timestamp = recovery.abnormal_time;
+    rec->recovery_timestamp = e.time;
+    rec->is_valid = 1;
+    return 1;
+}
+
+// 最高温记录每天一条，第nth条最新记录即倒数第nth个有记录的日期
+static bit Event_LoadDayMax(unsigned char nth, DailyMaxTemp *rec) {
+    DayMaxRec day_max;
+    
+    rec->is_valid = 0;
+    rec->max_temp = -990;
+    if (!DayMaxLog_Get(nth, &day_max)) {
+        return 0;
+    }
+    rec->max_temp = day_max.max_temp;
+    rec->temp_time = day_max.time;
+    rec->pid = day_max.pid;
+    rec->aid = day_max.aid;
+    rec->volt_mv = day_max.volt_mv;
+    rec->is_valid = 1;
+    return 1;
 }
 
+// 找回当天的最高温（上电回放后调用）：最新一条记录的日期为当天时即当天记录
+// 候选只恢复第0名（记录本身），其余从站的候选随之后的样本重新积累
+static void DayMax_Reopen(void) {
+    DayMaxRec day_max;
+    
+    DayStat_Reset();
+    if (current_system_date[0] == 0 && current_system_date[1] == 0 && current_system_date[2] == 0) {
+        return;
+    }
+    if (!DayMaxLog_Get(0, &day_max) || day_max.time.year != current_system_date[0] ||
+        day_max.time.mon != current_system_date[1] || day_max.time.day != current_system_date[2]) {
+        return;
+    }
+    day_top[0].temp = day_max.max_temp;
+    day_top[0].pid = day_max.pid;
+    day_top[0].aid = day_max.aid;
+    day_top[0].volt_mv = day_max.volt_mv;
+    day_top[0].time = day_max.time;
+    day_top_n = 1;
+    if (day_max.min_aid != 0) {
+        memset(&day_min, 0, sizeof(DayTopEntry));
+        day_min.temp = day_max.min_temp;
+        day_min.aid = day_max.min_aid;
+        day_min_valid = 1;
+    }
+}
 
 // 保留原GetMaxTempRecords函数（数据读取逻辑不变）
 static void GetMaxTempRecords_Ext(short max_temps[], rtc_time_t max_temp_times[], 
@@ -4171,8 +6747,8 @@ static void GetMaxTempRecords_Ext(short max_temps[], rtc_time_t max_temp_times[]
                                 unsigned short *volt_mv_ptr, DataRecord **target_record) {
     unsigned char selected_row = menu_state.page21_selected;
     unsigned char i;
+    DailyMaxTemp rec;
     
-    CheckDailyMaxTemp();
     *pid_ptr = 0;
     *aid_ptr = 0;
     *volt_mv_ptr = 0;
@@ -4180,9 +6756,9 @@ static void GetMaxTempRecords_Ext(short max_temps[], rtc_time_t max_temp_times[]
     
     for (i = 0; i < 3; i++) {
         // 强化校验：必须is_valid=1且max_temp!=-990才视为有效
-        if (daily_max_temps[i].is_valid && daily_max_temps[i].max_temp != -990 && daily_max_temps[i].temp_time.year != 0) {
-            max_temps[i] = daily_max_temps[i].max_temp;
-            max_temp_times[i] = daily_max_temps[i].temp_time;
+        if (Event_LoadDayMax(i, &rec) && rec.max_temp != -990 && rec.temp_time.year != 0) {
+            max_temps[i] = rec.max_temp;
+            max_temp_times[i] = rec.temp_time;
         } else {
             max_temps[i] = -990;
             memset(&max_temp_times[i], 0, sizeof(rtc_time_t));
@@ -4192,16 +6768,15 @@ static void GetMaxTempRecords_Ext(short max_temps[], rtc_time_t max_temp_times[]
     
     // 选中行数据赋值（有效数据优先，无则取实时数据）
     if (selected_row < 3) {
-        if (daily_max_temps[selected_row].is_valid && daily_max_temps[selected_row].max_temp != -990) {
-            *pid_ptr = daily_max_temps[selected_row].pid;
-            *aid_ptr = daily_max_temps[selected_row].aid;
-            *volt_mv_ptr = daily_max_temps[selected_row].volt_mv;
+        if (Event_LoadDayMax(selected_row, &rec) && rec.max_temp != -990) {
+            *pid_ptr = rec.pid;
+            *aid_ptr = rec.aid;
+            *volt_mv_ptr = rec.volt_mv;
         } else {
-            DataRecord *realtime_rec = GetRecentDataByAID((unsigned char)(selected_row + 1));
-            if (realtime_rec != NULL && realtime_rec->is_valid) {
-                *pid_ptr = realtime_rec->pid;
-                *aid_ptr = realtime_rec->aid;
-                *volt_mv_ptr = realtime_rec->volt1 * 100;
+            if (RT_BIT_TEST(rt_valid_map, selected_row)) {
+                *pid_ptr = rt_pid[selected_row];
+                *aid_ptr = selected_row + 1;
+                *volt_mv_ptr = rt_volt_mv[selected_row];
             }
         }
     }
@@ -4210,15 +6785,13 @@ static void GetMaxTempRecords_Ext(short max_temps[], rtc_time_t max_temp_times[]
 // 兼容层函数：保持原函数签名，内部调用扩展函数
 static void GetMaxTempRecords(short max_temps[], rtc_time_t max_temp_times[]) {
     unsigned char i;
+    DailyMaxTemp rec;
     
-    // 强制更新最高温数据
-    CheckDailyMaxTemp();
-    
-    // 将数据复制到传入的数组中
+    // 将最新3条最高温记录复制到传入的数组中
     for (i = 0; i < 3; i++) {
-        if (daily_max_temps[i].is_valid && daily_max_temps[i].max_temp != -990) {
-            max_temps[i] = daily_max_temps[i].max_temp;
-            max_temp_times[i] = daily_max_temps[i].temp_time;
+        if (Event_LoadDayMax(i, &rec) && rec.max_temp != -990) {
+            max_temps[i] = rec.max_temp;
+            max_temp_times[i] = rec.temp_time;
         } else {
             max_temps[i] = -990;
             memset(&max_temp_times[i], 0, sizeof(rtc_time_t));
@@ -4231,70 +6804,40 @@ static void GetMaxTempRecords(short max_temps[], rtc_time_t max_temp_times[]) {
 static void RecordRecoveryEvent(unsigned char pid, unsigned char aid, 
                                unsigned char abnormal_temp, unsigned char recovery_temp,
                                unsigned int recovery_volt_mv, rtc_time_t abnormal_time) {
-    GetCurrentRTC(); // 获取恢复时的实时时间
+    EvRecoveryData recovery;
     
-    recovery_events[recovery_event_next_index].pid = pid;
-    recovery_events[recovery_event_next_index].aid = aid;
-    recovery_events[recovery_event_next_index].abnormal_temp = abnormal_temp;
-    recovery_events[recovery_event_next_index].recovery_temp = recovery_temp;
-    recovery_events[recovery_event_next_index].recovery_volt_mv = recovery_volt_mv;
-    recovery_events[recovery_event_next_index].abnormal_timestamp = abnormal_time;
-    recovery_events[recovery_event_next_index].recovery_timestamp = current_rtc_time;
-    recovery_events[recovery_event_next_index].is_valid = 1;
+    GetCurrentRTC(); // 获取恢复时的实时时间（作为事件时间）
     
-    // 循环覆盖逻辑（与报警事件一致）
-    recovery_event_next_index = (recovery_event_next_index + 1) % MAX_RECOVERY_EVENTS;
-    if (recovery_event_count < MAX_RECOVERY_EVENTS) {
-        recovery_event_count++;
-    }
+    recovery.pid = pid;
+    recovery.abnormal_temp = abnormal_temp;
+    recovery.recovery_temp = recovery_temp;
+    recovery.recovery_volt_mv = recovery_volt_mv;
+    recovery.abnormal_time = abnormal_time;
+    Journal_Append(EVENT_TYPE_RECOVERY, aid, &current_rtc_time, &recovery, sizeof(EvRecoveryData), NULL);
+    
+    // 由调用者（Alarm_Evaluate）清除异常状态后统一保存
+    Telemetry_Emit(TELEMETRY_TYPE_RECOVERY, aid, pid,
+                   (short)recovery_temp * 10, (unsigned int)abnormal_temp * 10);
 }
 															 
-// 实现恢复事件删除函数
+// 实现恢复事件删除函数（任意位置，只置删除标志）
 static void DeleteRecoveryEvent(unsigned char display_index) {
-    unsigned char actual_index;
-    unsigned char i;
-    unsigned char idx;
-    unsigned char j;
+    JournalEntry e;
 
-    // 1. 无效索引直接返回（与报警删除一致）
-    if (display_index >= recovery_event_count) {
-        UART4_SendString("Recovery delete: invalid index\r\n");
+    if (!Journal_FindNewest(EVENT_TYPE_RECOVERY, 0, display_index, &e)) {
+        if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_WARN)) {
+            UART4_SendString("Recovery delete: invalid index\r\n");
+        }
         return;
     }
+    Journal_Delete(&e.ref);
+    Persist_SaveEvents();
 
-    // 2. 计算实际存储索引（完全复刻报警的索引公式）
-    actual_index = (recovery_event_next_index - display_index - 1 + MAX_RECOVERY_EVENTS) % MAX_RECOVERY_EVENTS;
-
-    // 3. 标记事件为无效（核心操作）
-    if (alarm_events[actual_index].is_valid) {
-        recovery_events[actual_index].is_valid = 0;
-        UART4_SendString("Recovery event marked invalid\r\n");
-    }
-
-    // 4. 调整事件计数和索引（报警删除的核心逻辑，之前可能漏了这步）
-    if (display_index == 0 && recovery_event_count > 0) {
-        // 移动索引，覆盖被删除事件
-        recovery_event_next_index = (recovery_event_next_index - 1 + MAX_RECOVERY_EVENTS) % MAX_RECOVERY_EVENTS;
-        recovery_event_count--;
-
-        // 重新整理有效事件，避免列表显示空条目
-        for (i = 0; i < recovery_event_count; i++) {
-            idx = (recovery_event_next_index - i - 1 + MAX_RECOVERY_EVENTS) % MAX_RECOVERY_EVENTS;
-            if (!recovery_events[idx].is_valid) {
-                // 找到下一个有效事件，移动到当前位置
-                for (j = idx; j != recovery_event_next_index; j = (j - 1 + MAX_RECOVERY_EVENTS) % MAX_RECOVERY_EVENTS) {
-                    if (recovery_events[(j + 1) % MAX_RECOVERY_EVENTS].is_valid) {
-                        recovery_events[j] = recovery_events[(j + 1) % MAX_RECOVERY_EVENTS];
-                        recovery_events[(j + 1) % MAX_RECOVERY_EVENTS].is_valid = 0;
-                    }
-                }
-            }
-        }
+    if (LOG_ON(LOG_MOD_ALARM, LOG_LEVEL_INFO)) {
+        UART4_SendString("Recovery delete success. Count=");
+        UART4_SendNumber(Journal_Count(EVENT_TYPE_RECOVERY), 2);
+        UART4_SendString("\r\n");
     }
-
-    UART4_SendString("Recovery delete success. Count=");
-    UART4_SendNumber(recovery_event_count, 1);
-    UART4_SendString("\r\n");
 }
 
 
@@ -4308,15 +6851,7 @@ static void DisplayPassword(void) {
     unsigned char ch;
     unsigned char *pwd_ptr = NULL;
 
-    static unsigned int flash_timer = 0;
-    static bit flash_state = 1;
-
-    // 闪烁频率控制（保持与PAGE_24一致）
-    flash_timer++;
-    if (flash_timer >= FLASH_INTERVAL) {
-        flash_timer = 0;
-        flash_state = !flash_state;
-    }
+    // 选中位闪烁状态flash_state由TMR_ID_BLINK定时器每FLASH_INTERVAL翻转（Blink_OnTimer重绘）
 
     // 密码指针赋值（遵循PAGE_24指针模式）
     if (pwd_edit_state != PWD_EDIT_IDLE) {
@@ -4360,12 +6895,28 @@ static void PWD_Edit_Init(void) {
         pwd_edit_state = PWD_EDIT_SELECT;
         pwd_edit_pos = 0;
         // 重置闪烁状态
-        flash_timer = 0;
-        flash_state = 1;
+        Blink_Restart();
     }
     display_labels_initialized = 0;
 }
 
+// 编辑位闪烁从"显示"重新开始：重新计时（已运行的定时器直接改期）
+static void Blink_Restart(void) {
+    flash_state = 1;
+    TimerWheel_Start(TMR_ID_BLINK, TW_MS(FLASH_INTERVAL));
+}
+
+// 闪烁定时器到期：PAGE_25密码编辑中翻转选中位并重绘，否则停止闪烁
+static void Blink_OnTimer(void) {
+    if (menu_state.current_page != PAGE_25 || pwd_edit_state == PWD_EDIT_IDLE) {
+        flash_state = 1;
+        return;
+    }
+    flash_state = !flash_state;
+    DisplayPassword();
+    TimerWheel_Start(TMR_ID_BLINK, TW_MS(FLASH_INTERVAL));
+}
+
 // 4. 切换密码位函数（对齐PAGE_24的RTC_Switch_Pos）
 static void PWD_Switch_Pos(signed char step) {
     pwd_edit_pos += step;
@@ -4373,10 +6924,7 @@ static void PWD_Switch_Pos(signed char step) {
     if (pwd_edit_pos < 0) pwd_edit_pos = 5;
     if (pwd_edit_pos > 5) pwd_edit_pos = 0;
     // 切换后重置闪烁状态，确保选中位立即开始闪烁（与PAGE_24一致）
-//    static unsigned int flash_timer = 0;
-//    static bit flash_state = 1;
-    flash_timer = 0;
-    flash_state = 1;
+    Blink_Restart();
     display_labels_initialized = 0;
 }
 // 3. 调整数字（按键1/2：数字加减）
@@ -4396,9 +6944,11 @@ static void PWD_Save_Edit(void) {
     memcpy(current_password, edit_temp_pwd, sizeof(current_password));
     memcpy(default_password, current_password, sizeof(default_password));
     pwd_edit_state = PWD_EDIT_SELECT;
-    flash_state = 0; // 闪烁停止
+    Blink_Restart(); // 保存后选中位立即显示
     display_labels_initialized = 0;
-    UART4_SendString("Password saved successfully!\r\n");
+    if (LOG_ON(LOG_MOD_UI, LOG_LEVEL_INFO)) {
+        UART4_SendString("Password saved successfully!\r\n");
+    }
 }
 
 
@@ -4421,148 +6971,228 @@ static void PWD_Save_Edit(void) {
 //    time.sec = 0;
 //    return time;
 //}
-// 检查是否跨天，更新每日最高温数组
-static void CheckDailyMaxTemp(void) {
-    rtc_time_t curr_time;
-    bit is_new_day = 0;
-    unsigned char slave_idx = 0;
-    unsigned char hist_idx = 0;
-    unsigned short hist_start = 0;
-    unsigned short hist_pos = 0;
-    DataRecord *hist_rec = NULL;
-    DataRecord *realtime_rec = NULL;
-    short current_temp = 0;
-    
-    if (disable_max_temp_calc) {
+// ------------------- 每日极值 -------------------
+// 有效样本只与当天最低温和DAY_TOP_K个候选比较，时间取缓存时钟current_rtc_time（TMR_ID_RTC每秒刷新）
+// 候选每个从站最多一条：该从站已在候选中只在更高时上移，否则与末名比较
+static void DayStat_Sample(unsigned char slave_idx, short temp_deci) {
+    unsigned char i;
+    unsigned char aid = slave_idx + 1;
+    
+    if (!day_min_valid || temp_deci < day_min.temp) {
+        day_min.temp = temp_deci;
+        day_min.pid = rt_pid[slave_idx];
+        day_min.aid = aid;
+        day_min.volt_mv = rt_volt_mv[slave_idx];
+        day_min.time = current_rtc_time;
+        day_min_valid = 1;
+        DayMax_Write(0);
+    }
+    
+    for (i = 0; i < day_top_n; i++) {
+        if (day_top[i].aid == aid) {
+            break;
+        }
+    }
+    if (i < day_top_n) {
+        if (temp_deci <= day_top[i].temp) {
+            return;
+        }
+    } else if (day_top_n < DAY_TOP_K) {
+        i = day_top_n++;
+    } else if (temp_deci > day_top[DAY_TOP_K - 1].temp) {
+        i = DAY_TOP_K - 1;
+    } else {
         return;
     }
     
-    GetCurrentRTC();
-    curr_time = current_rtc_time;
+    // 上移到按温度排序的位置（覆盖该从站原来的候选）
+    while (i > 0 && day_top[i - 1].temp < temp_deci) {
+        day_top[i] = day_top[i - 1];
+        i--;
+    }
+    day_top[i].temp = temp_deci;
+    day_top[i].pid = rt_pid[slave_idx];
+    day_top[i].aid = aid;
+    day_top[i].volt_mv = rt_volt_mv[slave_idx];
+    day_top[i].time = current_rtc_time;
+    if (i == 0) {
+        DayMax_Write(1);
+    }
+}
+
+// 当天最高温（第0名）和最低温写入每日最高温记录：已有当天记录则原位改写，否则插入为最新一条
+// 最高温变化时输出遥测并保存快照；只有最低温变化时只改RAM中的记录，随下一次保存写入EEPROM
+static void DayMax_Write(bit is_max) {
+    DayMaxRec day_max;
+    
+    if (day_top_n == 0) {
+        if (!is_max) {
+            Telemetry_Emit(TELEMETRY_TYPE_MIN_TEMP, day_min.aid, day_min.pid, day_min.temp, day_min.volt_mv);
+        }
+        return;     // 最高温候选已被删空：最低温等下一个样本建立记录时一并写入
+    }
+    day_max.pid = day_top[0].pid;
+    day_max.aid = day_top[0].aid;
+    day_max.max_temp = day_top[0].temp;
+    day_max.volt_mv = day_top[0].volt_mv;
+    day_max.min_temp = day_min_valid ? day_min.temp : day_top[0].temp;
+    day_max.min_aid = day_min_valid ? day_min.aid : 0;
+    day_max.time = day_top[0].time;
+    DayMaxLog_Put(&day_max);
+    
+    if (is_max) {
+        Telemetry_Emit(TELEMETRY_TYPE_MAX_TEMP, day_top[0].aid, day_top[0].pid, day_top[0].temp, day_top[0].volt_mv);
+        Persist_SaveDayMax();
+    } else {
+        Telemetry_Emit(TELEMETRY_TYPE_MIN_TEMP, day_min.aid, day_min.pid, day_min.temp, day_min.volt_mv);
+    }
+}
+
+static void DayStat_Reset(void) {
+    day_top_n = 0;
+    day_min_valid = 0;
+}
+
+// 零点定时器到期/上电/修改时间后调用：日期变化即结束前一天（前一天的记录留在每日最高温记录中），
+// 然后按当前时间安排下一次零点检查（多等1秒，RTC与节拍有偏差而提前到期时日期未变，只重新安排）
+static void DayStat_CheckDay(void) {
+    unsigned long elapsed;
     
-    // 初始化当前日期（首次调用时）
+    GetCurrentRTC();
     if (current_system_date[0] == 0 && current_system_date[1] == 0 && current_system_date[2] == 0) {
-        current_system_date[0] = curr_time.year;
-        current_system_date[1] = curr_time.mon;
-        current_system_date[2] = curr_time.day;
+        current_system_date[0] = current_rtc_time.year;
+        current_system_date[1] = current_rtc_time.mon;
+        current_system_date[2] = current_rtc_time.day;
+        Persist_SaveEvents();  // 保存日期，掉电跨天后上电仍能正确判断跨天
+    } else if (current_rtc_time.year != current_system_date[0] ||
+               current_rtc_time.mon != current_system_date[1] ||
+               current_rtc_time.day != current_system_date[2]) {
+        DayStat_Reset();
+        current_system_date[0] = current_rtc_time.year;
+        current_system_date[1] = current_rtc_time.mon;
+        current_system_date[2] = current_rtc_time.day;
+        Persist_SaveEvents();
+        
+        if (LOG_ON(LOG_MOD_DATA, LOG_LEVEL_INFO)) {
+            UART4_SendString("New day detected, reset daily max/min.\r\n");
+        }
     }
     
-    // 跨天判断
-    is_new_day = (curr_time.year != current_system_date[0]) 
-               || (curr_time.mon != current_system_date[1]) 
-               || (curr_time.day != current_system_date[2]);
+    SlaveDay_SyncDate();
     
-    if (is_new_day) {
-        // 跨天时移动数据
-        daily_max_temps[2] = daily_max_temps[1];
-        daily_max_temps[1] = daily_max_temps[0];
-        
-        // 重置当天数据
-        memset(&daily_max_temps[0], 0, sizeof(DailyMaxTemp));
-        daily_max_temps[0].is_valid = 0;
-        daily_max_temps[0].max_temp = -990;
-        
-        // 关键修复：跨天时重置删除标志（新的一天允许计算最高温）
-        disable_today_max_calc = 0;  // 新增这行
-        
-        // 更新日期记录
-        current_system_date[0] = curr_time.year;
-        current_system_date[1] = curr_time.mon;
-        current_system_date[2] = curr_time.day;
-        
-        // 调试信息
-        UART4_SendString("New day detected, reset max temp calculation.\r\n");
+    elapsed = ((unsigned long)current_rtc_time.hour * 60 + current_rtc_time.min) * 60 + current_rtc_time.sec;
+    TimerWheel_Start(TMR_ID_MIDNIGHT, TW_SEC((elapsed < 86400UL) ? (86400UL - elapsed + 1) : 60));
+}
+
+// ------------------- 从站每日统计 -------------------
+// 每个有效样本只改该从站当天一条统计（O(1)），最高温时刻取缓存时钟current_rtc_time
+static void SlaveDay_Sample(unsigned char slave_idx, short temp_deci) {
+    SlaveDayStat *s = &slave_day[slave_day_head][slave_idx];
+    
+    if (s->count == 0) {
+        s->min_temp = temp_deci;
+        s->max_temp = temp_deci;
+        s->sum = 0;
+        s->max_minute = (unsigned int)current_rtc_time.hour * 60 + current_rtc_time.min;
+    } else if (temp_deci < s->min_temp) {
+        s->min_temp = temp_deci;
+    } else if (temp_deci > s->max_temp) {
+        s->max_temp = temp_deci;
+        s->max_minute = (unsigned int)current_rtc_time.hour * 60 + current_rtc_time.min;
+    }
+    if (s->count < 0xFFFF) {
+        s->sum += temp_deci;
+        s->count++;
     }
+}
+
+// 清空后当天行直接使用current_system_date（上电时日期尚为0，由DayStat_CheckDay对齐）
+static void SlaveDay_Clear(void) {
+    memset(slave_day, 0, sizeof(slave_day));
+    memset(slave_day_date, 0, sizeof(slave_day_date));
+    slave_day_head = 0;
+    SlaveDay_SyncDate();
+}
+
+// 当天行已用于别的日期时换到下一行（覆盖最旧一天）；未使用的行直接标记为当天
+static void SlaveDay_SyncDate(void) {
+    unsigned char *d = slave_day_date[slave_day_head];
     
-    // 关键修改：如果当天最高温已被删除，则不重新计算
-    if (disable_today_max_calc && !is_new_day) {
-        return;  // 当天最高温已被删除，不再重新计算
+    if (d[0] == current_system_date[0] && d[1] == current_system_date[1] && d[2] == current_system_date[2]) {
+        return;
     }
+    if (d[0] != 0 || d[1] != 0 || d[2] != 0) {
+        slave_day_head = (slave_day_head + 1) % SLAVE_DAY_DAYS;
+        d = slave_day_date[slave_day_head];
+    }
+    memset(slave_day[slave_day_head], 0, sizeof(slave_day[0]));
+    d[0] = current_system_date[0];
+    d[1] = current_system_date[1];
+    d[2] = current_system_date[2];
+}
+
+// 从当天往前找（修改过RTC日期时同一日期可能有两行，取较新的一行）
+static unsigned char SlaveDay_Find(const rtc_time_t *date) {
+    unsigned char i;
+    unsigned char row;
     
-    // 只有当允许计算时才进行最高温查找
-    if (!disable_today_max_calc) {
-        // 读取实时数据
-        for (slave_idx = 0; slave_idx < TOTAL_SLAVES; slave_idx++) {
-            realtime_rec = &data_summary[slave_idx];
-            if (realtime_rec->is_valid && realtime_rec->temp > 0) {
-                current_temp = realtime_rec->temp * 10;
-                
-                if (daily_max_temps[0].is_valid == 0) {
-                    // 初始化当天记录
-                    daily_max_temps[0].is_valid = 1;
-                    daily_max_temps[0].max_temp = current_temp;
-                    rtc_read(&daily_max_temps[0].temp_time);
-                    daily_max_temps[0].pid = realtime_rec->pid;
-                    daily_max_temps[0].aid = realtime_rec->aid;
-                    daily_max_temps[0].volt_mv = realtime_rec->volt1 * 100;
-                } else if (current_temp > daily_max_temps[0].max_temp) {
-                    // 更新更高的温度
-                    daily_max_temps[0].max_temp = current_temp;
-                    rtc_read(&daily_max_temps[0].temp_time);
-                    daily_max_temps[0].pid = realtime_rec->pid;
-                    daily_max_temps[0].aid = realtime_rec->aid;
-                    daily_max_temps[0].volt_mv = realtime_rec->volt1 * 100;
-                }
-            }
-        }
-        
-        // 读取历史数据
-        for (slave_idx = 0; slave_idx < TOTAL_SLAVES; slave_idx++) {
-            hist_start = HISTORY_DATA_START + (slave_idx * RECORDS_PER_SLAVE);
-            for (hist_idx = 0; hist_idx < RECORDS_PER_SLAVE; hist_idx++) {
-                hist_pos = hist_start + hist_idx;
-                hist_rec = &data_summary[hist_pos];
-                
-                if (hist_rec->is_valid && hist_rec->temp > 0) {
-                    current_temp = hist_rec->temp * 10;
-                    
-                    if (daily_max_temps[0].is_valid == 0) {
-                        daily_max_temps[0].is_valid = 1;
-                        daily_max_temps[0].max_temp = current_temp;
-                        rtc_read(&daily_max_temps[0].temp_time);
-                        daily_max_temps[0].pid = hist_rec->pid;
-                        daily_max_temps[0].aid = hist_rec->aid;
-                        daily_max_temps[0].volt_mv = hist_rec->volt1 * 100;
-                    } else if (current_temp > daily_max_temps[0].max_temp) {
-                        daily_max_temps[0].max_temp = current_temp;
-                        rtc_read(&daily_max_temps[0].temp_time);
-                        daily_max_temps[0].pid = hist_rec->pid;
-                        daily_max_temps[0].aid = hist_rec->aid;
-                        daily_max_temps[0].volt_mv = hist_rec->volt1 * 100;
-                    }
-                }
-            }
+    if (date->year == 0 && date->mon == 0 && date->day == 0) {
+        return SLAVE_DAY_NONE;
+    }
+    for (i = 0; i < SLAVE_DAY_DAYS; i++) {
+        row = (slave_day_head + SLAVE_DAY_DAYS - i) % SLAVE_DAY_DAYS;
+        if (slave_day_date[row][0] == date->year && slave_day_date[row][1] == date->mon &&
+            slave_day_date[row][2] == date->day) {
+            return row;
         }
     }
+    return SLAVE_DAY_NONE;
 }
 
 // ------------------- 删除指定最高温事件 -------------------
 void DeleteMaxTempEvent(unsigned char display_index) {
+    DayMaxRec day_max;
+    unsigned char i;
+    bit is_today = 0;
+    
     if (display_index >= 3) {
         return;
     }
     
-    // 1. 彻底清空目标索引的最高温数据（标记为无效）
-    daily_max_temps[display_index].is_valid = 0;
-    daily_max_temps[display_index].max_temp = -990;
-    daily_max_temps[display_index].pid = 0;
-    daily_max_temps[display_index].aid = 0;
-    daily_max_temps[display_index].volt_mv = 0;
-    memset(&daily_max_temps[display_index].temp_time, 0, sizeof(rtc_time_t));
+    // 1. 删除对应的最高温记录；删除的是当天记录时第0名出列，由下一名候选写入为新的当天记录
+    if (DayMaxLog_Get(display_index, &day_max)) {
+        is_today = (day_max.time.year == current_system_date[0] && day_max.time.mon == current_system_date[1] &&
+                    day_max.time.day == current_system_date[2]) ? 1 : 0;
+        DayMaxLog_Delete(display_index);
+        if (is_today && day_top_n > 0) {
+            for (i = 1; i < day_top_n; i++) {
+                day_top[i - 1] = day_top[i];
+            }
+            day_top_n--;
+        }
+    }
     
     // 2. 同步清空全局缓存，确保页面实时显示空值
     max_temps[display_index] = -990;
     memset(&max_temp_times[display_index], 0, sizeof(rtc_time_t));
+    if (is_today && day_top_n > 0) {
+        DayMax_Write(1);    // 写入下一名并保存
+    } else {
+        Persist_SaveDayMax();
+    }
     
-    // 3. 移除禁止重算逻辑，删除当天数据后仍允许重新计算
-    if (display_index == 0) {
-        UART4_SendString("Today's max temp deleted, allow recalculation.\r\n");
+    // 3. 删除当天数据后由下一名候选接替，之后的样本照常更新
+    if (is_today) {
+        if (LOG_ON(LOG_MOD_DATA, LOG_LEVEL_INFO)) {
+            UART4_SendString("Today's max temp deleted, next candidate takes over.\r\n");
+        }
     } else {
-        UART4_SendString("History max temp deleted.\r\n");
+        if (LOG_ON(LOG_MOD_DATA, LOG_LEVEL_INFO)) {
+            UART4_SendString("History max temp deleted.\r\n");
+        }
     }
     
     // ========== 新增核心逻辑 ==========
-    CheckDailyMaxTemp();  // 主动重算最高温，更新下一个最高值
     display_labels_initialized = 0;  // 强制页面重新绘制
     RefreshDisplay();     // 触发LCD刷新，显示新数据
     // ==================================
@@ -4570,27 +7200,12 @@ void DeleteMaxTempEvent(unsigned char display_index) {
 // 清空所有最高温事件（用于Page23清除Page21/22数据）
 // 修改后的ClearAllMaxTempEvents函数
 void ClearAllMaxTempEvents(void) {
-    unsigned char i;
+    // 1. 删除全部最高温记录，当天候选和最低温重新开始积累
+    DayMaxLog_Init();
+    DayStat_Reset();
+    Persist_SaveDayMax();
     
-    // 1. 禁用最高温重新计算（避免删除过程中被覆盖）
-    disable_max_temp_calc = 1;
-    
-    // 2. 彻底重置3个最高温记录
-    for (i = 0; i < 3; i++) { 
-        daily_max_temps[i].is_valid = 0;
-        daily_max_temps[i].max_temp = -990;    
-        daily_max_temps[i].pid = 0;            
-        daily_max_temps[i].aid = 0;            
-        daily_max_temps[i].volt_mv = 0;        
-        memset(&daily_max_temps[i].temp_time, 0, sizeof(rtc_time_t));
+    if (LOG_ON(LOG_MOD_DATA, LOG_LEVEL_INFO)) {
+        UART4_SendString("All max temp events cleared.\r\n");
     }
-    
-    // 3. 重置计数和索引（关键修复）
-    max_temp_event_count = 0;
-    max_temp_next_index = 0;
-    
-    // 4. 释放禁用标记（关键修复：允许后续重新计算最高温）
-    disable_max_temp_calc = 0;
-    
-    UART4_SendString("All max temp events cleared.\r\n");
 }
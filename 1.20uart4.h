@@ -6,48 +6,317 @@
 #include "config.h"       // 系统配置头文件
 #include "led.h"          // LED驱动头文件
 #include "D1302.h"        // DS1302 RTC时钟驱动头文件
+#include "journal.h"      // 事件日志（各类事件共用的字节环）
+#include "daymax.h"       // 每日最高温记录（按日期保留最近几天）
+#include "uart_frame.h"   // 串口接收组帧（UART_BUFF_SIZE、组帧窗口）
+#include "iap_log.h"      // EEPROM日志区/定长记录区（历史区解码器使用IapAreaIter）
 
 // ------------------- 核心存储配置宏定义 -------------------
 #define TOTAL_SLAVES        35          // 从站设备总数（支持35个从站）
-#define RECORDS_PER_SLAVE   4           // 每个从站的历史记录条数
-#define RECENT_RECORDS      1           // 每个从站的实时数据记录条数
-#define TOTAL_RECORDS       (TOTAL_SLAVES * (RECENT_RECORDS + RECORDS_PER_SLAVE))  // 总记录数 = 从站数 ×（实时+历史）
-
-// ------------------- 存储分区索引定义 -------------------
-#define RECENT_DATA_START   0           // 实时数据存储起始索引
-#define RECENT_DATA_SIZE    TOTAL_SLAVES// 实时数据存储大小（每个从站1条）
-#define HISTORY_DATA_START  RECENT_DATA_SIZE  // 历史数据存储起始索引
-#define HISTORY_DATA_SIZE   (TOTAL_SLAVES * RECORDS_PER_SLAVE)  // 历史数据存储大小
+#define RECORDS_PER_SLAVE   (HIST_ZIP_BLOCKS * (HIST_ZIP_BLOCK_SIZE - HIST_ZIP_KEY_LEN + 1))  // 每个从站最多保存的历史记录条数（全部为单字节增量时）
+#define HIST_EPOCH_EMPTY    0UL         // 纪元分钟为0表示无数据（有效时间从1开始计数）
+#define HIST_SLOT_NONE      0xFF        // 历史记录查找失败返回值
+
+// ------------------- 历史数据压缩环配置 -------------------
+// 每个从站的历史数据按"关键帧+变长增量"压缩存储，以HIST_ZIP_BLOCK_SIZE字节为一块，每块以关键帧开头可独立解码。
+// RAM中只有各从站正在写入的当前块：当前块放不下新记录，或其关键帧已早于HIST_ZIP_SEAL_MIN分钟时，
+// 整块写入EEPROM历史区（iap_log.h定长记录区，需PERSIST_ENABLE）后清空，新块以关键帧开头。
+// 读取时按时间顺序先解码历史区中该从站最新的HIST_ZIP_BLOCKS-1块，再解码当前块。记录格式（首字节为类型头，h为删除标志）：
+//   0htttttt                        1字节：温度增量-32~+31（0.1℃），电压不变，间隔HIST_ZIP_STEP_MIN
+//   10hvvvvv tttttttt               2字节：电压增量-16~+15（0.1V），温度增量-128~+127，间隔HIST_ZIP_STEP_MIN
+//   110h0000 间隔 温度增量 电压增量   4字节：间隔0~255分钟，温度/电压增量为有符号字节
+//   111h0000 纪元分钟(4) 温度(2) 电压 PID   9字节关键帧（多字节小端序）
+// 删除当前块中的记录时原地置位h；历史区中的块写入后不能改写，删除标志记在槽的附加字节中（每条记录1位，0=已删除）。
+// 解码时仍累加已删除记录的增量但不输出该记录
+// 历史区一条记录：[0] 从站索引  [1] 块长度  [2..] 块数据；附加字节为块内各记录的删除位
+// 保留深度：持续按最小间隔（10分钟）以单字节增量记录是写满最快的情况，一块22条约3.7小时；全部从站如此时历史区
+// 保留(20-1)×13=247≥35×7块，每个从站最新7块加当前块覆盖24小时以上（RAM只占35×31=1085字节）。
+// 电压同时变化（双字节增量）时一块约1.8小时，约保留13小时；记录较少的从站按7块计保留更久。
+// 当前块的样本由EEPROM日志回放重建，HIST_ZIP_SEAL_MIN使其不早于日志中保留的样本。PERSIST_ENABLE为0时只保留当前块
+#define HIST_ZIP_BLOCKS     8           // 每个从站保留的块数（历史区HIST_ZIP_BLOCKS-1块+RAM当前块）
+#define HIST_ZIP_BLOCK_SIZE 30          // 每块字节数
+#define HIST_ZIP_KEY_LEN    9           // 关键帧字节数
+#define HIST_ZIP_STEP_MIN   HIST_LOG_MIN_MIN  // 短增量记录隐含的间隔（分钟），与最小记录间隔相同
+#define HIST_ZIP_SEAL_MIN   360         // 当前块关键帧超过该分钟数即写入历史区（日志约保存12小时样本）
+#define HIST_ZIP_RAM_BYTES  (TOTAL_SLAVES * (HIST_ZIP_BLOCK_SIZE + 1))  // 当前块+块长度表占用的RAM
+#define HIST_AREA_REC_LEN   (HIST_ZIP_BLOCK_SIZE + 2)   // 历史区记录长度
+#define HIST_AREA_AUX_LEN   ((HIST_ZIP_BLOCK_SIZE - HIST_ZIP_KEY_LEN + 1 + 7) / 8)  // 删除位字节数（每块最多22条）
+#define HIST_AREA_SECTORS   20          // 历史区扇区数（每扇区13块）
+#define HIST_AREA_FIRST     (ROLLUP_DAY_FIRST + ROLLUP_DAY_SECTORS)  // 历史区首扇区（紧接日区）
+
+// ------------------- 历史记录策略配置 -------------------
+// 按变化记录：新样本与上次记录值相比，温度或电压变化超过死区时记录；
+// 两次记录至少间隔HIST_LOG_MIN_MIN（限速），超过心跳间隔无变化也记录一次
+#define HIST_LOG_MIN_MIN        10    // 最小记录间隔（分钟）
+#define HIST_LOG_MAX_MIN        60    // 心跳间隔（分钟，默认值，可用UART_CMD_SET_HIST_LOG修改）
+#define HIST_LOG_DEADBAND_DECI  5     // 温度死区（0.1℃，默认值，可用UART_CMD_SET_HIST_LOG修改）
+#define HIST_LOG_DEADBAND_MV    200   // 电压死区（mV）
+
+// ------------------- 历史汇总配置 -------------------
+// 写入历史记录的样本（最小间隔10分钟）再逐级汇总为每小时、每天一条最低/最高/平均温度，保存在EEPROM日志区之后的
+// 两个定长记录区（iap_log.h），掉电不丢失；RAM中只有当前小时的各从站累加器（需PERSIST_ENABLE）。
+// 样本累加到当前小时；出现更晚一小时的样本时当前小时写入小时区（全部从站一条记录），跨天时先由小时区中前一天的
+// 各小时汇总算出该天写入日区（平均值按小时平均，最低/最高取各小时极值）。时间倒退（修改RTC）的样本计入当前小时，
+// 当前小时已写入后到达的更早样本（含上电回放的已汇总样本）忽略；当前小时由上电回放的历史样本重建
+// 一条记录：[0-3] 小时序号（纪元分钟/60）或天序号（纪元分钟/1440）  之后各从站4字节：
+//   [0-1] 平均温度（0.1℃，ROLLUP_EMPTY=无样本）  [2] 平均值-最低温  [3] 最高温-平均值（0.1℃，不超过ROLLUP_SPAN_MAX）
+// 下载程序时STC-ISP中EEPROM大小需不小于PERSIST_EEPROM_SECTORS×512（见"EEPROM持久化配置"）
+#define ROLLUP_HOURS            24    // 小时区至少保留的已结束小时数
+#define ROLLUP_DAYS             30    // 日区至少保留的已结束天数
+#define ROLLUP_REC_LEN          (4 + TOTAL_SLAVES * 4)  // 一条汇总记录长度（35个从站144字节，每扇区3条）
+#define ROLLUP_HOUR_SECTORS     9     // 小时区扇区数（回收一个扇区后仍有(9-1)×3=24条）
+#define ROLLUP_DAY_SECTORS      11    // 日区扇区数（回收一个扇区后仍有(11-1)×3=30条）
+#define ROLLUP_HOUR_FIRST       IAP_LOG_SECTORS                          // 小时区首扇区（紧接日志区）
+#define ROLLUP_DAY_FIRST        (IAP_LOG_SECTORS + ROLLUP_HOUR_SECTORS)  // 日区首扇区
+#define ROLLUP_NONE             0xFFFFFFFFUL  // 小时/天序号：尚无记录
+#define ROLLUP_EMPTY            ((short)0x8000)  // 汇总记录平均值：该小时/天无样本
+#define ROLLUP_SPAN_MAX         255   // 最低/最高温相对平均值的最大偏差（0.1℃，超过按此值保存）
+
+// ------------------- EEPROM持久化配置 -------------------
+// 事件日志和历史样本写入EEPROM追加日志（iap_log.c），上电回放重建RAM数据
+// 事件为快照（只保留最新一条），历史样本与删除为流水，可回放的历史深度受日志区大小限制
+// 记录类型和格式变化后旧日志无法回放，需在STC-ISP中擦除EEPROM
+#define PERSIST_ENABLE          1     // 1=启用EEPROM持久化，0=去除（掉电丢失全部事件和历史）
+#define PERSIST_REC_EVENTS      1     // 快照：异常状态位图、跨天判断日期(3)、事件日志最新记录（从旧到新）
+#define PERSIST_REC_DAY_MAX     2     // 快照：每日最高温记录（DayMaxRec，从新到旧，最多DAY_MAX_DAYS条）
+#define PERSIST_REC_HIST_SAMPLE 0x10  // 流水：从站索引 纪元分钟(4) 温度(2) 电压(0.1V) PID
+#define PERSIST_REC_HIST_DELETE 0x11  // 流水：从站索引 纪元分钟(4)（删除该时间的历史记录）
+#define PERSIST_EVENT_BYTES     190   // 事件快照保存的日志字节数（最新的未删除记录，整条保存）
+#define PERSIST_EVENT_HDR       (RT_BITMAP_BYTES + 3)   // 事件快照中日志记录之前的字节数
+#define PERSIST_BUF_SIZE        (PERSIST_EVENT_HDR + PERSIST_EVENT_BYTES)  // 快照记录组装缓冲区
+// 事件快照（约201字节）与每日最高温快照（48字节，均含记录头）合计约249字节，满足iap_log.h中快照类记录
+// 合计不超过半个扇区可用空间的要求；增加PERSIST_EVENT_BYTES或DAY_MAX_DAYS时需同步检查（RAM事件日志容量不影响快照长度）。擦除扇区期间CPU暂停约4~6ms，期间到达的串口字节可能丢失，由帧重同步处理
+// EEPROM依次为：日志区、小时汇总区、日汇总区、历史区、阈值区、校准区，STC-ISP中EEPROM大小需不小于PERSIST_EEPROM_SECTORS×512（54KB）
+#define PERSIST_EEPROM_SECTORS  (NTC_CAL_AREA_FIRST + NTC_CAL_AREA_SECTORS)
+
+// ------------------- 实时数据表配置 -------------------
+// 实时数据按字段分列存储（rt_xxx[从站索引]），有效/异常状态按位打包，
+// 全部从站扫描时只访问所需字段和位图
+#define RT_BITMAP_BYTES     ((TOTAL_SLAVES + 7) / 8)  // 位图字节数
+#define RT_BIT_TEST(map, idx)   ((map)[(idx) >> 3] & (1 << ((idx) & 7)))
+#define RT_BIT_SET(map, idx)    ((map)[(idx) >> 3] |= (unsigned char)(1 << ((idx) & 7)))
+#define RT_BIT_CLR(map, idx)    ((map)[(idx) >> 3] &= (unsigned char)~(1 << ((idx) & 7)))
+
+// ------------------- 从站在线检测配置 -------------------
+// 从站超过离线超时未上报即判为离线：清除实时有效位和异常位（不再显示旧数据、不参与报警判断），
+// 置离线位、离线次数加1并记下中断时间；再次收到该从站的数据帧即恢复在线。中断/恢复只输出遥测和调试日志，
+// 不写入事件日志（链路抖动时不挤占报警等事件、不重写事件快照）；每个从站在RAM中只保留最近一次中断时间，
+// 与离线次数一起在通信统计输出中显示，清零通信统计时一并清除
+// 每个从站一个软件定时器（TMR_ID_LIVE），收帧时重新计时，到期即判为离线
+#define LIVE_TIMEOUT_S          300   // 默认离线超时（秒，可用UART_CMD_SET_LIVE_TIMEOUT修改）
+#define LIVE_TIMEOUT_MIN_S      10    // 离线超时下限（秒）
+#define LIVE_TIMEOUT_MAX_S      3600  // 离线超时上限（秒）
+
+// ------------------- 软件定时器分配 -------------------
+// 周期性截止时间统一由软件定时器（timer_wheel.c）管理，到期回调在主循环中执行；
+// ID总数不超过timer_wheel.h中的TW_TIMER_COUNT
+#define TMR_ID_HIST(idx)        (idx)                     // 各从站历史记录：最小间隔→心跳间隔
+#define TMR_ID_LIVE(idx)        (TOTAL_SLAVES + (idx))    // 各从站离线超时
+#define TMR_ID_BLINK            (2 * TOTAL_SLAVES)        // 编辑位闪烁翻转
+#define TMR_ID_RTC              (2 * TOTAL_SLAVES + 1)    // RTC重新读取（缓存时钟current_rtc_time、PAGE_24时间显示）
+#define TMR_ID_MIDNIGHT         (2 * TOTAL_SLAVES + 2)    // 零点跨天（每日极值）
+#define TMR_ID_COUNT            (2 * TOTAL_SLAVES + 3)
+#define RTC_REFRESH_MS          1000  // RTC重新读取周期（ms）
 
 // ------------------- NTC温度传感器参数 -------------------
 #define NTC_R_REF       10000UL       // 参考电阻值（10KΩ）
 #define NTC_R0          10000UL       // NTC传感器25℃时阻值（10KΩ）
 #define NTC_T0          298.15f       // 25℃对应的开尔文温度（298.15K）
 #define NTC_B_VALUE     3950.0f       // NTC传感器B值（典型值3950）
+#define NTC_USE_LUT     1             // 1=查表线性插值（无浮点），0=B值公式实时计算（需math.h浮点库）
+#define NTC_LUT_SHIFT   4             // 查表节点间隔2^4=16个ADC码（修改后需用tools/ntc_lut_gen.c重新生成表）
+
+// ------------------- NTC单传感器校准配置 -------------------
+// 每个从站可单独设置B值、25℃阻值和温度偏移；校准变化时预先计算该从站相对名义曲线的
+// 修正量（0.01℃，按名义温度每20.48℃一个节点），逐帧换算只做整数插值，不用浮点。
+// 应用/恢复校准后全部从站参数写为校准区（EEPROM阈值区之后）一条记录，上电恢复最新一条（需PERSIST_ENABLE）
+#define NTC_CAL_BASE        (-4000)   // 首个修正节点对应的名义温度（0.01℃，即-40℃）
+#define NTC_CAL_SHIFT       11        // 修正节点间隔2^11=2048（0.01℃，即20.48℃）
+#define NTC_CAL_KNOTS       10        // 修正节点数（覆盖-40℃~144.32℃）
+#define NTC_CAL_ENABLE      1         // 1=支持单传感器校准（校准时用浮点计算修正表），0=去除校准及浮点库
+#define NTC_CAL_AREA_REC_LEN (TOTAL_SLAVES * 6)  // 校准区记录长度（ntc_calib[]，每从站6字节）
+#define NTC_CAL_AREA_SECTORS 2        // 校准区扇区数（每扇区2条，只需最新一条）
+#define NTC_CAL_AREA_FIRST  (THR_AREA_FIRST + THR_AREA_SECTORS)  // 校准区首扇区（紧接阈值区）
 
 // ------------------- UART通信配置 -------------------
-#define UART_BUFF_SIZE  6             // 串口接收缓冲区大小（6字节协议帧）
+#define UART_FRAME_QUEUE_DEPTH  64    // 有效帧队列深度（必须为2的幂，≥TOTAL_SLAVES，整屏重绘期间35个从站一轮突发不丢帧）
+#define UART_FRAME_QUEUE_MASK   (UART_FRAME_QUEUE_DEPTH - 1)  // 帧队列下标掩码
+#define UART_FRAME_GAP_MS       4     // 帧间静默超时（参照Modbus 3.5字符：9600bps下≈3.6ms，取4ms）
+
+// ------------------- UART4发送缓冲区配置 -------------------
+#define UART_TX_BUFF_SIZE       256   // 发送环形缓冲区大小（必须为2的幂）
+#define UART_TX_BUFF_MASK       (UART_TX_BUFF_SIZE - 1)
+// 缓冲区满时的处理策略：0=丢弃新字节并计入tx_drops（不阻塞主循环）；
+// 1=等待发送中断腾出空间（输出完整，但主循环会被阻塞，且不能在关中断时调用）
+#define UART_TX_BLOCK_ON_FULL   0
+
+// ------------------- 上位机命令帧配置 -------------------
+// 命令帧与从站数据帧格式相同（6字节，第6字节为前5字节和校验），以PID=0xFF、AID=0区分
+#define UART_CMD_PID            0xFF  // 命令帧PID标识
+#define UART_CMD_AID            0x00  // 命令帧AID标识（从站AID从1开始，0保留给上位机）
+#define UART_CMD_DUMP_STATS     0x01  // 命令：输出通信质量统计
+#define UART_CMD_CLEAR_STATS    0x02  // 命令：清零通信质量统计
+#define UART_CMD_SET_LOG        0x03  // 命令：设置日志级别（frame[3]=级别，frame[4]=模块掩码）
+#define UART_CMD_SET_TELEMETRY  0x04  // 命令：切换遥测输出模式（frame[3]=TELEMETRY_MODE_xxx）
+// NTC校准命令：先选择从站，再逐项设置（frame[3]低字节、frame[4]高字节），最后应用
+#define UART_CMD_CAL_SELECT     0x05  // 选择校准从站（frame[3]=AID），暂存区载入该从站当前参数
+#define UART_CMD_CAL_SET_B      0x06  // 设置B值（单位K）
+#define UART_CMD_CAL_SET_R0     0x07  // 设置25℃阻值（单位10Ω）
+#define UART_CMD_CAL_SET_OFFSET 0x08  // 设置温度偏移（有符号，单位0.01℃）
+#define UART_CMD_CAL_APPLY      0x09  // 应用暂存参数并重新计算修正表
+#define UART_CMD_CAL_RESET      0x0A  // 恢复名义参数（frame[3]=AID，0=全部从站）
+#define UART_CMD_CAL_DUMP       0x0B  // 输出校准参数（frame[3]=AID，0=全部已校准从站）
+#define UART_CMD_HIST_EXPORT    0x0C  // 导出历史数据（frame[3]=AID，0=全部从站），逐条解码输出ASCII
+#define UART_CMD_SET_HIST_LOG   0x0D  // 设置历史记录策略（frame[3]=温度死区0.1℃，0=有变化即记录；frame[4]=心跳间隔分钟，0=默认）
+#define UART_CMD_PERSIST_FORMAT 0x0E  // 清空EEPROM日志并重新写入当前事件表（frame[3]=0xA5确认）
+#define UART_CMD_SET_LIVE_TIMEOUT 0x0F  // 设置离线超时（frame[3]低字节、frame[4]高字节，单位秒，0=默认）
+// 阈值命令：先选择从站，再逐项设置（立即生效）
+#define UART_CMD_THR_SELECT     0x10  // 选择阈值设置的从站（frame[3]=AID，0=全部从站）
+#define UART_CMD_THR_SET        0x11  // 设置所选从站的一项阈值（frame[3]=THR_FIELD_xxx，frame[4]=值）
+#define UART_CMD_THR_DUMP       0x12  // 输出阈值表（frame[3]=AID，0=全部从站）
+#define UART_CMD_ROLLUP_DUMP    0x13  // 输出历史汇总（frame[3]=AID，0=全部从站；frame[4]=0小时汇总，1每日汇总），从旧到新
+
+// ------------------- 二进制遥测配置 -------------------
+// 遥测记录固定13字节（多字节字段小端序，上位机解码参考tools/telemetry_decode.c）：
+//   [0]    同步字 TELEMETRY_SYNC
+//   [1]    记录类型 TELEMETRY_TYPE_xxx
+//   [2]    AID
+//   [3]    PID
+//   [4-5]  value1（有符号，0.1℃）：采样/报警/预警/升温速率/最高温/最低温为温度，恢复为恢复温度；通信中断/恢复为距上一帧秒数
+//   [6-7]  value2（无符号）：采样/报警/预警/最高温/最低温为电压mV，升温速率为平均速率（0.1℃/分钟），
+//          恢复为报警期间最高温（0.1℃）；通信中断/恢复为累计离线次数
+//   [8-11] 系统滴答（ms）
+//   [12]   校验和：[1]~[11]字节累加和（低8位）
+#define TELEMETRY_ENABLE        1     // 1=编译遥测功能，0=完全去除
+#define TELEMETRY_SYNC          0xA5  // 记录同步字
+#define TELEMETRY_REC_LEN       13    // 记录长度（字节）
+#define TELEMETRY_TYPE_SAMPLE   0x01  // 采样记录（每个被接收的从站数据帧一条）
+#define TELEMETRY_TYPE_ALARM    0x02  // 报警事件
+#define TELEMETRY_TYPE_RECOVERY 0x03  // 恢复事件
+#define TELEMETRY_TYPE_MAX_TEMP 0x04  // 当天最高温更新
+#define TELEMETRY_TYPE_COMM_LOSS    0x05  // 从站离线（超时未上报）
+#define TELEMETRY_TYPE_COMM_RESTORE 0x06  // 离线从站恢复上报
+#define TELEMETRY_TYPE_WARNING  0x07  // 预警事件
+#define TELEMETRY_TYPE_RATE_RISE 0x08 // 升温速率事件
+#define TELEMETRY_TYPE_MIN_TEMP 0x09  // 当天最低温更新
+#define TELEMETRY_MODE_ASCII    0     // 遥测关闭，仅输出ASCII调试信息
+#define TELEMETRY_MODE_BINARY   1     // 输出二进制遥测记录，ASCII日志关闭
+
+// ------------------- 调试日志配置 -------------------
+// 日志级别（数值越大输出越多）
+#define LOG_LEVEL_NONE          0
+#define LOG_LEVEL_ERROR         1
+#define LOG_LEVEL_WARN          2
+#define LOG_LEVEL_INFO          3
+#define LOG_LEVEL_TRACE         4     // 逐帧/逐次读取的跟踪信息
+
+// 日志模块掩码
+#define LOG_MOD_UART            0x01  // 串口收帧
+#define LOG_MOD_ALARM           0x02  // 报警/恢复事件
+#define LOG_MOD_RTC             0x04  // DS1302时钟
+#define LOG_MOD_DATA            0x08  // 数据存储/历史/最高温
+#define LOG_MOD_UI              0x10  // 菜单操作
+#define LOG_MOD_SYS             0x20  // 系统启动
+#define LOG_MOD_ALL             0x3F
+
+// 编译期上限：高于LOG_COMPILE_LEVEL或不在LOG_COMPILE_MODULES中的日志，
+// 条件为常量0，整段输出代码被编译器删除；运行期可通过UART_CMD_SET_LOG在上限内调节
+#define LOG_COMPILE_LEVEL       LOG_LEVEL_INFO
+#define LOG_COMPILE_MODULES     LOG_MOD_ALL
+
+#define LOG_ON(mod, lvl)  ((LOG_COMPILE_LEVEL >= (lvl)) && ((LOG_COMPILE_MODULES & (mod)) != 0) && \
+                           (log_level >= (lvl)) && ((log_module_mask & (mod)) != 0))
 
 // ------------------- 页面显示配置 -------------------
 #define PAGE3_MAX_MODULES    30         // PAGE_3页面支持的最大模块数（30个）
 #define PAGE1_DEV_COUNT      sizeof(page1_devices)/sizeof(Page1_DevInfo)  // PAGE_1设备数（自动计算，避免硬编码）
 #define PAGE10_DISPLAY_COUNT 3          // PAGE_10每页显示报警事件数（3条）
-#define PAGE10_MAX_PAGE      2          // PAGE_10最大页数（支持6条报警事件）
+#define PAGE10_MAX_PAGE      8          // PAGE_10最大页数（最多浏览最新24条报警事件）
 #define PAGE18_DISPLAY_COUNT 3          // PAGE_18每页显示从站数（3个）
 #define PAGE18_MAX_PAGE      ((TOTAL_SLAVES + PAGE18_DISPLAY_COUNT - 1) / PAGE18_DISPLAY_COUNT)  // PAGE_18最大页数（自动计算）
 #define PAGE1_TOTAL_DEVICES  sizeof(page1_devices)/sizeof(Page1_DevInfo)  // PAGE_1总设备数（自动计算）
 
 // ------------------- 事件记录配置 -------------------
-#define MAX_ALARM_EVENTS     6          // 最大报警事件记录数（6条）
-#define MAX_RECOVERY_EVENTS  6          // 最大传感器恢复事件记录数（6条）
-#define MAX_MAX_TEMP_EVENTS  3          // 最大最高温事件记录数（3条，近3天）
+// 报警/恢复/预警/升温速率事件统一写入事件日志（journal.c），各列表页面是按类型过滤的视图（0=最新），
+// 可删除任意一条；总容量JOURNAL_SIZE由各类事件共享，满时丢弃最旧的记录。每日最高温不在事件日志中（见daymax.h）
+#define EVENT_TYPE_ALARM     1          // 报警事件（数据EvAlarmData）
+#define EVENT_TYPE_RECOVERY  2          // 恢复事件（数据EvRecoveryData，事件时间为恢复时间）
+#define EVENT_TYPE_WARNING   3          // 预警事件（数据EvAlarmData）
+#define EVENT_TYPE_RATE_RISE 5          // 升温速率事件（数据EvRateData，平均升温速率超过该从站ror_limit）
+#define MAX_MAX_TEMP_EVENTS  3          // PAGE_21显示的最高温记录数（近3天，不超过DAY_MAX_DAYS）
+
+// ------------------- 每日极值配置 -------------------
+// 每个有效样本按O(DAY_TOP_K)更新当天最高/最低温（时间取每秒刷新的current_rtc_time，不逐次读RTC），
+// 零点由TMR_ID_MIDNIGHT定时器触发跨天；当天最高温候选按从站去重，删除当天最高温后由下一名接替。
+// 当天最高温（含最低温）写入每日最高温记录（daymax.c，每个日期一条，单独作为一条EEPROM快照保存）
+#define DAY_TOP_K            4          // 当天最高温候选数（仅RAM，上电后从当天记录重新开始积累）
+#define ALARM_TEMP_DECI      250        // 默认报警温度阈值（0.1℃，高于25.0℃报警）
+
+// ------------------- 从站每日统计配置 -------------------
+// 每个从站每天一条统计（最低/最高温、温度和与样本数、最高温时刻），按天循环保存近SLAVE_DAY_DAYS天（仅RAM）；
+// 有效样本O(1)累加，跨天时最旧一天的行清零作为新的一天。PAGE_21选中日期后经PAGE_22按键3逐个从站查看
+#define SLAVE_DAY_DAYS       3          // 保留天数（与PAGE_21的3行对应，RAM占用SLAVE_DAY_DAYS×TOTAL_SLAVES×12字节；更早的日期见每日汇总）
+#define SLAVE_DAY_NONE       0xFF       // 该日期不在保留范围内
+
+// ------------------- RAM预算 -------------------
+// STC32G12K128片内RAM共12KB（edata 4KB含堆栈 + xdata 8KB）。可配置的大表（历史压缩环、事件日志、从站每日统计、
+// 汇总累加器）与其余静态变量（实时数据表、阈值/校准表、串口收发缓冲区、帧队列、软件定时器、EEPROM日志缓冲区等，
+// code表在Flash中不计）、堆栈预留与余量之和不得超过片内RAM；小时/每日汇总本身在EEPROM中。
+// RAM_OTHER_BYTES为按源码逐项估算的值（约5.8KB，向上取整），并非编译结果：应以Keil链接生成的.M51映射文件中
+// EDATA/XDATA段合计减去RAM_TABLE_BYTES核对后修正；RAM_MARGIN_BYTES为估算误差与后续扩展保留的余量
+#define RAM_TOTAL_BYTES      12288      // 片内RAM
+#define RAM_STACK_BYTES      768        // 堆栈预留
+#define RAM_OTHER_BYTES      6144       // 其余静态变量估算值（增加全局/静态变量时同步修改，以.M51为准）
+#define RAM_MARGIN_BYTES     1024       // 估算误差与后续扩展余量
+#define RAM_TABLE_BYTES      (HIST_ZIP_RAM_BYTES + JOURNAL_SIZE + SLAVE_DAY_DAYS * TOTAL_SLAVES * 12 + TOTAL_SLAVES * 10)  // 末项为RollupAcc
+#if RAM_TABLE_BYTES + RAM_OTHER_BYTES + RAM_STACK_BYTES + RAM_MARGIN_BYTES > RAM_TOTAL_BYTES
+#error "static RAM over budget: shrink HIST_ZIP_*, JOURNAL_SIZE or SLAVE_DAY_DAYS"
+#endif
+
+// ------------------- 预警/报警阈值配置 -------------------
+// 每个从站独立的阈值表（slave_thr[]，可用UART_CMD_THR_xxx修改）：修改后全部从站写为阈值区（EEPROM历史区之后）一条记录，
+// 上电恢复最新一条，阈值区无记录或PERSIST_ENABLE为0时使用默认值；
+// 温度高于阈值进入该级别，低于"阈值-回差"才退出；与当前级别不同的判断结果须持续驻留时间
+// （进入/退出分别设置）才生效，在阈值附近波动的传感器不会反复产生报警/恢复事件
+// 报警级别即rt_abnormal_map，由此产生报警/恢复事件；从正常进入预警或报警时记录一条预警事件（PAGE_13）
+#define THR_WARN_C_DEFAULT      23    // 默认预警阈值（℃）
+#define THR_ALARM_C_DEFAULT     (ALARM_TEMP_DECI / 10)  // 默认报警阈值（℃）
+#define THR_HYST_DECI_DEFAULT   10    // 默认回差（0.1℃）
+#define THR_DWELL_SET_S_DEFAULT 5     // 默认进入驻留时间（秒）
+#define THR_DWELL_CLR_S_DEFAULT 30    // 默认退出驻留时间（秒）
+#define TEMP_LEVEL_NORMAL       0     // 温度级别：正常
+#define TEMP_LEVEL_WARN         1     // 温度级别：预警
+#define TEMP_LEVEL_ALARM        2     // 温度级别：报警
+#define THR_FIELD_WARN_C        0     // UART_CMD_THR_SET字段：预警阈值（℃）
+#define THR_FIELD_ALARM_C       1     // 报警阈值（℃）
+#define THR_FIELD_HYST_DECI     2     // 回差（0.1℃）
+#define THR_FIELD_DWELL_SET_S   3     // 进入驻留时间（秒）
+#define THR_FIELD_DWELL_CLR_S   4     // 退出驻留时间（秒）
+#define THR_FIELD_ROR_LIMIT     5     // 升温速率报警限值（0.1℃/分钟）
+#define THR_FIELD_COUNT         6     // 字段个数
+#define THR_AREA_REC_LEN        (TOTAL_SLAVES * THR_FIELD_COUNT)  // 阈值区记录长度（全部从站，35个从站210字节）
+#define THR_AREA_SECTORS        2     // 阈值区扇区数（每扇区2条，只需最新一条）
+#define THR_AREA_FIRST          (HIST_AREA_FIRST + HIST_AREA_SECTORS)  // 阈值区首扇区（紧接历史区）
+
+// ------------------- 升温速率检测配置 -------------------
+// 每个有效样本O(1)更新：与参考样本间隔不少于ROR_MIN_DT_S时计算一次速率并更新参考，
+// 速率经指数平均（系数1/2^ROR_EMA_SHIFT，定点ROR_EMA_Q位小数）后与该从站ror_limit比较；
+// 超过限值产生一条升温速率事件（写入事件日志，未回落期间PAGE_4标出该从站），降到限值一半以下后重新允许触发；
+// 间隔超过ROR_MAX_GAP_S（含离线）重新开始
+// 每从站状态6字节+1位，与从站数量线性相关
+#define THR_ROR_LIMIT_DEFAULT   80    // 默认升温速率报警限值（0.1℃/分钟，8.0℃/分钟，0=关闭）
+#define ROR_MIN_DT_S            10    // 两次速率计算的最小间隔（秒，抑制0.1℃量化噪声）
+#define ROR_MAX_GAP_S           600   // 参考样本最长有效时间（秒，须小于65535个定时器节拍）
+#define ROR_EMA_SHIFT           2     // 指数平均系数1/4
+#define ROR_EMA_Q               4     // 平均速率定点小数位数（×16）
+#define ROR_RATE_CLAMP          1000  // 单次速率限幅（0.1℃/分钟，±100℃/分钟）
 
 // ------------------- 闪烁效果配置 -------------------
 #define PWD_FLASH_DURATION   30        // 密码闪烁单次时长（30个系统节拍≈250ms）
-#define FLASH_INTERVAL       25        // 通用闪烁间隔（25个系统节拍，与密码闪烁保持一致）
+#define FLASH_INTERVAL       250       // 通用闪烁间隔（ms，由TMR_ID_BLINK定时器翻转）
 
 // ------------------- PAGE_19自动记录配置 -------------------
-#define PAGE19_READ_INTERVAL 600000    // PAGE_19自动读取间隔（600000ms=10分钟）
+#define PAGE19_READ_INTERVAL (HIST_LOG_MIN_MIN * 60000UL)  // PAGE_19自动读取间隔（与最小历史记录间隔一致）
 #define PAGE19_TRIGGER_INTERVAL 1000   // PAGE_19触发间隔（1000ms=1秒，避免高频调用）
 
 // ------------------- IO引脚定义 -------------------
@@ -80,7 +349,9 @@ typedef enum {
     PAGE_23 = 22,  // 最高温度删除确认页面
     PAGE_24 = 23,  // 修改日期时间页面
     PAGE_25 = 24,  // 修改密码页面
-    PAGE_26 = 25   // 恢复出厂设置确认页面
+    PAGE_26 = 25,  // 恢复出厂设置确认页面
+    PAGE_27 = 26,  // 通信诊断页面（链路质量统计）
+    PAGE_28 = 27   // 从站每日统计页面（PAGE_22按键3进入）
 } PageType;
 
 // ------------------- 菜单项枚举（各菜单页面选项标识） -------------------
@@ -119,15 +390,69 @@ typedef struct {
     unsigned long timestamp;     // 系统时间戳（毫秒级，用于计时）
     rtc_time_t save_time;       // RTC时间（用于历史记录的精确时间戳）
     unsigned char is_valid;      // 记录有效性标志（1=有效，0=无效）
-    unsigned char reserved[3];   // 预留字段（用于对齐，增强兼容性）
+    short temp_deci;             // 温度值（单位0.1℃，-990=无效；报警/最高温判断使用）
+    unsigned char reserved[1];   // 预留字段（用于对齐，增强兼容性）
 } DataRecord;
 
+// ------------------- 历史记录结构体（压缩环解码结果/增量基准值） -------------------
+// 时间以2000-01-01 00:00起的分钟数+1保存（0=无数据），显示时还原为DataRecord
+typedef struct {
+    unsigned long epoch_min;     // 保存时间（纪元分钟，HIST_EPOCH_EMPTY=无数据）
+    short temp_deci;             // 温度值（单位0.1℃，-990=无效）
+    unsigned char volt_dv;       // 电池电压（单位0.1V，与协议帧分辨率相同）
+    unsigned char pid;           // 从站ID
+} HistEntry;
+
+// ------------------- 历史压缩环流式解码器 -------------------
+// 按时间顺序逐条解码一个从站的全部记录（含已删除记录，由hidden区分）：先历史区中的块，再RAM当前块
+typedef struct {
+    unsigned char slave_idx;     // 从站索引
+    unsigned char blk;           // 当前读取块（0~blk_count-1为历史区中的块，blk_count为RAM当前块）
+    unsigned char blk_count;     // 历史区中该从站的块数（不超过HIST_ZIP_BLOCKS-1）
+    unsigned char len;           // 当前读取块的长度
+    unsigned char pos;           // 块内读取位置
+    unsigned char rec;           // 块内已解码的记录数（历史区块删除位的序号）
+    unsigned char hdr_pos;       // 最近一条记录类型头的块内位置（删除RAM当前块中的记录时原地置位）
+    unsigned char hidden;        // 最近一条记录已删除（1=已删除）
+    unsigned char buf[HIST_ZIP_BLOCK_SIZE];   // 历史区中当前读取块的副本
+    unsigned char aux[HIST_AREA_AUX_LEN];     // 历史区中当前读取块的删除位
+#if PERSIST_ENABLE
+    IapAreaIter blk_it[HIST_ZIP_BLOCKS - 1];  // 历史区中该从站的块（从旧到新）
+#endif
+    HistEntry cur;               // 最近一条记录的解码值
+} HistZipReader;
+
+// ------------------- 历史汇总累加器（当前小时/汇总一天，count=0表示尚无样本） -------------------
+typedef struct {
+    short min_temp;              // 最低温度（0.1℃）
+    short max_temp;              // 最高温度（0.1℃）
+    long sum;                    // 温度和（0.1℃）
+    unsigned int count;          // 样本数
+} RollupAcc;
+
+// ------------------- NTC校准参数结构体（每个从站一条） -------------------
+typedef struct {
+    unsigned int b_value;         // B值（单位K）
+    unsigned int r0_10ohm;        // 25℃阻值（单位10Ω）
+    short offset_centi;           // 温度偏移（单位0.01℃）
+} NTC_Calib;
+
+// ------------------- 预警/报警阈值结构体（每个从站一条，6字节） -------------------
+typedef struct {
+    unsigned char warn_c;         // 预警阈值（℃，高于该温度进入预警）
+    unsigned char alarm_c;        // 报警阈值（℃，高于该温度进入报警）
+    unsigned char hyst_deci;      // 回差（0.1℃，低于"阈值-回差"才退出）
+    unsigned char dwell_set_s;    // 进入驻留时间（秒，升级条件持续该时间才生效）
+    unsigned char dwell_clr_s;    // 退出驻留时间（秒，降级条件持续该时间才生效）
+    unsigned char ror_limit;      // 升温速率报警限值（0.1℃/分钟，0=关闭）
+} SlaveThreshold;
+
 // ------------------- UART协议解析结构体（存储解析后的协议数据） -------------------
 typedef struct {
     unsigned char PID;          // 从站ID（协议帧解析结果）
     unsigned char AID;          // 区域ID（协议帧解析结果）
     unsigned int ADC_Value;     // 12位ADC原始值（传感器采集数据）
-    float Bat_Voltage;          // 电池电压（单位V，保留1位小数）
+    unsigned int Bat_mV;        // 电池电压（单位mV，协议帧为0.1V单位）
     unsigned char Check_OK;     // FCS校验结果（1=校验通过，0=校验失败）
     short temperature;          // 转换后的温度值（放大10倍，保留1位小数）
 } Protocol_Data;
@@ -159,6 +484,8 @@ typedef struct {
     unsigned char page24_selected;
     unsigned char page25_selected;
     unsigned char page26_selected;
+    unsigned char page27_selected; // PAGE_27当前查看的从站索引（0~TOTAL_SLAVES-1）
+    unsigned char page28_selected; // PAGE_28当前查看的从站索引（0~TOTAL_SLAVES-1）
     unsigned char page_changed; // 页面变更标志（1=页面已变更，需刷新）
     unsigned char menu_initialized; // 菜单初始化标志（1=已初始化）
     unsigned char page11_global_event_idx; // PAGE_11页面关联的全局报警事件索引
@@ -206,7 +533,46 @@ typedef enum {
     PWD_EDIT_CHANGE = 2   // 调整状态（调整选中位的数字）
 } Password_EditState;
 
-// ------------------- 每日最高温结构体（存储近3天的最高温数据） -------------------
+// ------------------- 事件日志数据（各类型记录头之后的数据） -------------------
+typedef struct {
+    unsigned char pid;           // 从站ID
+    unsigned char temp;          // 温度（单位℃；报警事件为报警期间最高温）
+    unsigned int volt_mv;        // 电压（单位mV）
+} EvAlarmData;
+
+typedef struct {
+    unsigned char pid;           // 从站ID
+    unsigned char temp;          // 触发时温度（单位℃）
+    unsigned int rate;           // 平均升温速率（0.1℃/分钟）
+} EvRateData;
+
+typedef struct {
+    unsigned char pid;           // 从站ID
+    unsigned char abnormal_temp; // 报警期间最高温（单位℃）
+    unsigned char recovery_temp; // 恢复时温度（单位℃）
+    unsigned int recovery_volt_mv; // 恢复时电压（单位mV）
+    rtc_time_t abnormal_time;    // 报警发生时间
+} EvRecoveryData;
+
+// ------------------- 当天最高温候选（每个从站最多一条，按温度从高到低） -------------------
+typedef struct {
+    short temp;                  // 该从站当天最高温度（0.1℃）
+    unsigned char pid;
+    unsigned char aid;
+    unsigned int volt_mv;
+    rtc_time_t time;             // 发生时间
+} DayTopEntry;
+
+// ------------------- 从站每日统计（count=0表示当天无有效样本） -------------------
+typedef struct {
+    short min_temp;              // 最低温度（0.1℃）
+    short max_temp;              // 最高温度（0.1℃）
+    long sum;                    // 温度和（0.1℃，平均值=sum/count）
+    unsigned int count;          // 样本数（达到0xFFFF后不再累加温度和，平均值为前0xFFFF个样本的平均）
+    unsigned int max_minute;     // 最高温发生时刻（当天第几分钟，0~1439）
+} SlaveDayStat;
+
+// ------------------- 每日最高温结构体（最高温事件的显示视图） -------------------
 typedef struct {
     short max_temp;        // 当日最高温度（放大10倍，保留1位小数）
     rtc_time_t temp_time;  // 最高温发生的RTC时间
@@ -226,11 +592,45 @@ typedef struct {
     unsigned char is_valid;      // 记录有效性标志（1=有效，0=无效）
 } Page19_AutoRecord;
 
+// ------------------- 通信质量统计结构体（UART链路诊断计数） -------------------
+typedef struct {
+    unsigned long frames_ok;       // 校验通过并入队的帧数
+    unsigned long fcs_errors;      // FCS校验失败次数（滑动窗口每滑动一次计1）
+    unsigned long resync_events;   // 失步后重新对齐到有效帧的次数
+    unsigned long queue_overruns;  // 帧队列满导致丢帧的次数
+    unsigned long gap_discards;    // 静默超时丢弃不完整帧的次数
+    unsigned long aid_rejects;     // AID超出范围被AddDataToSummary拒绝的次数
+    unsigned long tx_drops;        // 发送缓冲区满被丢弃的字节数
+} UART_LinkStats;
+
 // ------------------- 全局变量声明（extern表示在其他文件中定义） -------------------
 // UART通信相关
-extern unsigned char uart_rx_buff[UART_BUFF_SIZE];  // 串口接收缓冲区
-extern unsigned char uart_rx_len;                 // 串口接收数据长度
 extern bit uart_rx_complete;                    // 串口接收完成标志（1=完成）
+extern unsigned char uart_frame_queue[UART_FRAME_QUEUE_DEPTH][UART_BUFF_SIZE];  // 有效帧队列（ISR写入，主循环读取）
+extern volatile unsigned char uart_frame_head;  // 帧队列写指针（仅ISR修改）
+extern volatile unsigned char uart_frame_tail;  // 帧队列读指针（仅主循环修改）
+extern volatile unsigned char uart_rx_idle_ms;  // 距上一个接收字节的静默时间（毫秒，饱和计数）
+
+// 通信质量统计相关
+extern UART_LinkStats link_stats;                          // 链路质量统计计数
+extern unsigned int link_aid_rx[TOTAL_SLAVES];            // 各从站收到的有效帧数
+extern unsigned int link_aid_fail[TOTAL_SLAVES];          // 各从站失败帧数（校验失败/温度无效）
+extern unsigned int link_aid_offline[TOTAL_SLAVES];       // 各从站离线次数
+
+// 调试日志相关
+extern unsigned char log_level;                           // 运行期日志级别
+extern unsigned char log_module_mask;                     // 运行期日志模块掩码
+
+// NTC校准相关
+extern NTC_Calib ntc_calib[TOTAL_SLAVES];                 // 各从站校准参数
+extern SlaveThreshold slave_thr[TOTAL_SLAVES];            // 各从站预警/报警阈值
+
+// 二进制遥测相关
+extern unsigned char telemetry_mode;                      // 遥测输出模式（TELEMETRY_MODE_xxx）
+
+// 历史记录策略相关
+extern unsigned char hist_log_deadband_deci;              // 温度死区（0.1℃）
+extern unsigned char hist_log_max_min;                    // 心跳间隔（分钟）
 
 // 系统计时相关
 extern unsigned long delay_count;               // 延时计数器
@@ -243,36 +643,33 @@ extern bit display_labels_initialized;          // 固定标签初始化标志
 // 菜单状态相关
 extern MenuState menu_state;                    // 菜单系统状态
 extern rtc_time_t current_rtc_time;             // 当前RTC时间
-extern unsigned long rtc_refresh_counter;       // RTC刷新计数器
 extern bit need_rtc_refresh;                   // RTC刷新标志（1=需要刷新）
 
 // 协议解析相关
 extern Protocol_Data parsed_data;               // 解析后的协议数据
 
 // 数据存储相关
-extern DataRecord data_summary[TOTAL_RECORDS];  // 数据记录存储数组（实时+历史）
-extern unsigned char history_index[TOTAL_SLAVES];// 每个从站的历史记录索引
+extern unsigned char hist_zip[TOTAL_SLAVES][HIST_ZIP_BLOCK_SIZE];  // 历史数据当前块
+extern unsigned char hist_zip_len[TOTAL_SLAVES];  // 当前块已用字节数（0=空块）
+extern short rt_temp_deci[TOTAL_SLAVES];        // 实时温度（0.1℃，-990=无效）
+extern unsigned int rt_volt_mv[TOTAL_SLAVES];   // 实时电池电压（mV）
+extern unsigned char rt_pid[TOTAL_SLAVES];      // 最近一帧的PID
+extern unsigned long rt_last_tick[TOTAL_SLAVES];// 最近一帧的系统滴答（ms）
+extern unsigned char rt_valid_map[RT_BITMAP_BYTES];    // 实时数据有效位图
+extern unsigned char rt_abnormal_map[RT_BITMAP_BYTES]; // 温度超过报警阈值位图
+extern unsigned char rt_offline_map[RT_BITMAP_BYTES];  // 离线位图（曾上报、已超时未再上报）
+extern unsigned char rt_level[TOTAL_SLAVES];    // 温度级别（TEMP_LEVEL_xxx，已按回差和驻留时间确认）
+extern unsigned int live_timeout_s;             // 离线超时（秒）
 
 // RTC编辑相关
 extern RTC_EditState rtc_edit_state;            // RTC编辑状态
 extern unsigned char rtc_edit_pos;              // RTC编辑选中位置（0-9：年1-分2）
 extern rtc_time_t edit_temp_time;               // 临时存储待修改的RTC时间
 
-// 事件记录相关
-extern AlarmRecord alarm_events[MAX_ALARM_EVENTS];          // 报警事件存储数组
-extern RecoveryRecord recovery_events[MAX_RECOVERY_EVENTS];  // 恢复事件存储数组
-extern unsigned char alarm_event_count;                    // 当前报警事件数量
-extern unsigned char alarm_event_next_index;               // 下一个报警事件存储索引
-extern unsigned char recovery_event_count;                 // 当前恢复事件数量
-extern unsigned char recovery_event_next_index;            // 下一个恢复事件存储索引
+// 事件记录相关（事件本身在事件日志中，见journal.h）
 extern unsigned char last_abnormal_status[TOTAL_SLAVES];   // 各从站上次异常状态（1=异常，0=正常）
 
 // 最高温相关
-extern DailyMaxTemp daily_max_temps[MAX_MAX_TEMP_EVENTS];  // 近3天最高温存储数组
-extern unsigned char max_temp_event_count;                // 当前最高温事件数量
-extern unsigned char max_temp_next_index;                 // 下一个最高温事件存储索引
-extern bit disable_today_max_calc;                       // 禁止当天最高温计算标志（1=禁止）
-extern bit disable_max_temp_calc;                        // 禁止最高温计算标志（1=禁止）
 extern short max_temps[3];                              // 前3高温度缓存（放大10倍）
 extern rtc_time_t max_temp_times[3];                     // 前3高温度对应的时间
 
@@ -287,7 +684,12 @@ void UART4_Init(unsigned long baudrate);                  // UART4初始化（
 void UART4_SendByte(unsigned char dat);                  // UART4发送1字节数据
 void UART4_SendString(unsigned char *str);               // UART4发送字符串
 void UART4_SendNumber(unsigned long num, unsigned char digits);  // UART4发送指定位数的数字
+void UART4_FlushTx(void);                               // 等待发送缓冲区全部发出
+void Telemetry_Emit(unsigned char type, unsigned char aid, unsigned char pid,
+                    short value1, unsigned int value2);  // 输出一条二进制遥测记录
 void UART4_ReceiveString(void);                         // UART4接收字符串（协议帧）
+void UART4_DumpLinkStats(void);                         // UART4输出通信质量统计
+void ClearLinkStats(void);                              // 清零通信质量统计
 
 // 定时器/延时函数
 void Timer0_Init(void);                                 // 定时器0初始化（用于延时和系统滴答）
@@ -306,8 +708,11 @@ void UpdateRTCRefresh(void);                            // 更新RTC刷新状态
 
 // 数据存储函数
 void InitDataStorage(void);                             // 数据存储初始化（清空缓存、初始化索引）
-void AddDataToSummary(unsigned char pid, unsigned char aid, unsigned char temp, unsigned char volt1, unsigned char volt2, unsigned char fosc);  // 添加数据到摘要存储
-DataRecord* GetRecentDataByAID(unsigned char aid);       // 根据AID获取最新数据
+void NTC_CalibInit(void);                               // 所有从站恢复名义NTC参数
+void Threshold_Init(void);                              // 所有从站恢复默认阈值
+void NTC_CalibApply(unsigned char aid);                 // 按ntc_calib重新计算指定从站修正表
+void AddDataToSummary(unsigned char pid, unsigned char aid, short temp_deci, unsigned int volt_mv);  // 添加数据到摘要存储（温度0.1℃，电压mV）
+DataRecord* GetRecentDataByAID(unsigned char aid, DataRecord *out); // 根据AID获取最新数据（复制到out，失败返回NULL）
 
 // 事件处理函数
 void DeleteAlarmEvent(unsigned char display_index);      // 删除指定报警事件
@@ -102,12 +102,17 @@ void rtc_init(void) {
 void rtc_read(rtc_time_t *t) {
     unsigned char temp;
     
-    // 先读取原始寄存器值用于调试
-    rtc_debug_raw();
+    // 先读取原始寄存器值用于调试（仅TRACE级别，避免每次读时间多读6个寄存器）
+    if (LOG_ON(LOG_MOD_RTC, LOG_LEVEL_TRACE)) {
+        rtc_debug_raw();
+    }
     
     // 读取时间寄存器（原始BCD码）
     temp = ds1302_read_byte(DS1302_SEC);
     t->sec = temp & 0x7F;  // 去掉CH位
+    if ((temp & 0x80) && LOG_ON(LOG_MOD_RTC, LOG_LEVEL_WARN)) {
+        UART4_SendString("WARNING: CH=1 (Oscillator Halted)\r\n");
+    }
     
     temp = ds1302_read_byte(DS1302_MIN);
     t->min = temp & 0x7F;
@@ -124,19 +129,21 @@ void rtc_read(rtc_time_t *t) {
     temp = ds1302_read_byte(DS1302_YEAR);
     t->year = temp & 0xFF;
     
-    UART4_SendString("Before BCD conversion: ");
-    UART4_SendNumber((unsigned long)t->sec, 2);
-    UART4_SendString("-");
-    UART4_SendNumber((unsigned long)t->min, 2);
-    UART4_SendString("-");
-    UART4_SendNumber((unsigned long)t->hour, 2);
-    UART4_SendString(" ");
-    UART4_SendNumber((unsigned long)t->day, 2);
-    UART4_SendString("-");
-    UART4_SendNumber((unsigned long)t->mon, 2);
-    UART4_SendString("-");
-    UART4_SendNumber((unsigned long)t->year, 2);
-    UART4_SendString("\r\n");
+    if (LOG_ON(LOG_MOD_RTC, LOG_LEVEL_TRACE)) {
+        UART4_SendString("Before BCD conversion: ");
+        UART4_SendNumber((unsigned long)t->sec, 2);
+        UART4_SendString("-");
+        UART4_SendNumber((unsigned long)t->min, 2);
+        UART4_SendString("-");
+        UART4_SendNumber((unsigned long)t->hour, 2);
+        UART4_SendString(" ");
+        UART4_SendNumber((unsigned long)t->day, 2);
+        UART4_SendString("-");
+        UART4_SendNumber((unsigned long)t->mon, 2);
+        UART4_SendString("-");
+        UART4_SendNumber((unsigned long)t->year, 2);
+        UART4_SendString("\r\n");
+    }
     
     // BCD转十进制
     t->sec = (t->sec >> 4) * 10 + (t->sec & 0x0F);
@@ -204,7 +211,7 @@ void rtc_debug_raw(void) {
     UART4_SendString("\r\n");
     
     // 检查CH位（秒寄存器的第7位）
-    if (sec & 0x80) {
+    if ((sec & 0x80) && LOG_ON(LOG_MOD_RTC, LOG_LEVEL_WARN)) {
         UART4_SendString("WARNING: CH=1 (Oscillator Halted)\r\n");
     }
 }
@@ -215,7 +222,9 @@ void rtc_check_and_init(void) {
     
     // 如果时间为0，设置默认时间
     if (t.year == 0 && t.mon == 0 && t.day == 0) {
-        UART4_SendString("RTC not initialized. Setting default time...\r\n");
+        if (LOG_ON(LOG_MOD_RTC, LOG_LEVEL_WARN)) {
+            UART4_SendString("RTC not initialized. Setting default time...\r\n");
+        }
         
         t.year = 25;   // 2025
         t.mon = 12;    // 12月
@@ -225,8 +234,10 @@ void rtc_check_and_init(void) {
         t.sec = 0;     // 0秒
         
         rtc_write(&t);
-        UART4_SendString("Default time set: 2025-12-24 10:30:00\r\n");
-    } else {
+        if (LOG_ON(LOG_MOD_RTC, LOG_LEVEL_INFO)) {
+            UART4_SendString("Default time set: 2025-12-24 10:30:00\r\n");
+        }
+    } else if (LOG_ON(LOG_MOD_RTC, LOG_LEVEL_INFO)) {
         UART4_SendString("RTC already initialized.\r\n");
     }
 }
@@ -0,0 +1,86 @@
+// 每日最高温记录（按日期保留最近DAY_MAX_DAYS天，格式见daymax.h）
+// dm_rec[0]为最新一条，dm_count为记录条数；记录很少，插入/删除直接搬移
+// 上位机测试：tools/alarm_replay.c 直接编译本文件（定义DM_HOST），在事件日志被灌满时核对保留的日期
+
+#ifndef DM_HOST
+#include "STC32G.H"
+#endif
+#include <string.h>       // memcpy
+#include "daymax.h"
+
+// ------------------- 全局变量 -------------------
+static DayMaxRec dm_rec[DAY_MAX_DAYS];            // 记录（从新到旧）
+static unsigned char dm_count;                    // 记录条数
+
+// ------------------- 对外接口 -------------------
+void DayMaxLog_Init(void)
+{
+    dm_count = 0;
+}
+
+void DayMaxLog_Put(const DayMaxRec *rec)
+{
+    unsigned char i;
+
+    if (dm_count == 0 || dm_rec[0].time.year != rec->time.year ||
+        dm_rec[0].time.mon != rec->time.mon || dm_rec[0].time.day != rec->time.day)
+    {
+        if (dm_count < DAY_MAX_DAYS)
+        {
+            dm_count++;
+        }
+        for (i = dm_count - 1; i > 0; i--)
+        {
+            dm_rec[i] = dm_rec[i - 1];
+        }
+    }
+    dm_rec[0] = *rec;
+}
+
+bit DayMaxLog_Get(unsigned char nth, DayMaxRec *rec)
+{
+    if (nth >= dm_count)
+    {
+        return 0;
+    }
+    *rec = dm_rec[nth];
+    return 1;
+}
+
+void DayMaxLog_Delete(unsigned char nth)
+{
+    unsigned char i;
+
+    if (nth >= dm_count)
+    {
+        return;
+    }
+    for (i = nth; i + 1 < dm_count; i++)
+    {
+        dm_rec[i] = dm_rec[i + 1];
+    }
+    dm_count--;
+}
+
+unsigned char DayMaxLog_Count(void)
+{
+    return dm_count;
+}
+
+unsigned char DayMaxLog_Export(unsigned char *buf)
+{
+    memcpy(buf, dm_rec, dm_count * sizeof(DayMaxRec));
+    return (unsigned char)(dm_count * sizeof(DayMaxRec));
+}
+
+void DayMaxLog_Import(const unsigned char *buf, unsigned char len)
+{
+    dm_count = 0;
+    while (dm_count < DAY_MAX_DAYS && len >= sizeof(DayMaxRec))
+    {
+        memcpy(&dm_rec[dm_count], buf, sizeof(DayMaxRec));
+        dm_count++;
+        buf += sizeof(DayMaxRec);
+        len -= sizeof(DayMaxRec);
+    }
+}
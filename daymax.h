@@ -0,0 +1,33 @@
+#ifndef __DAYMAX_H__
+#define __DAYMAX_H__
+
+#ifndef DM_HOST
+#include "D1302.h"        // rtc_time_t（上位机工具自行定义）
+#endif
+
+// ------------------- 每日最高温记录配置 -------------------
+// 每个日期一条记录，只保留最近DAY_MAX_DAYS个有记录的日期（从新到旧），与事件日志分开存放：
+// 报警等事件再多也不会挤掉每日最高温。最新一条与写入记录同一日期时原位改写，否则插入到最前，最旧一条随之丢弃；
+// 删除一条后其后的记录前移。整表可导出为一条快照（DAY_MAX_DAYS×sizeof(DayMaxRec)字节以内）
+#define DAY_MAX_DAYS        3             // 保留的日期数（与PAGE_21的3行对应）
+
+typedef struct {
+    rtc_time_t time;             // 最高温发生时间（年月日即该记录的日期）
+    unsigned char pid;           // 从站ID
+    unsigned char aid;           // 区域ID（当天内可能换成别的从站）
+    short max_temp;              // 当日最高温度（0.1℃）
+    unsigned int volt_mv;        // 对应电压（单位mV）
+    short min_temp;              // 当日最低温度（0.1℃，只随最高温更新一起保存）
+    unsigned char min_aid;       // 最低温对应的区域ID（0=无）
+} DayMaxRec;
+
+// ------------------- 函数声明 -------------------
+void DayMaxLog_Init(void);                                       // 清空全部记录
+void DayMaxLog_Put(const DayMaxRec *rec);                        // 写入一条（同日期原位改写，否则插入最前）
+bit DayMaxLog_Get(unsigned char nth, DayMaxRec *rec);            // 第nth条最新记录（0=最新）
+void DayMaxLog_Delete(unsigned char nth);                        // 删除第nth条最新记录
+unsigned char DayMaxLog_Count(void);                             // 记录条数
+unsigned char DayMaxLog_Export(unsigned char *buf);              // 导出全部记录（从新到旧），返回字节数
+void DayMaxLog_Import(const unsigned char *buf, unsigned char len);  // 按导出的数据恢复（长度不符的部分忽略）
+
+#endif
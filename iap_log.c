@@ -0,0 +1,588 @@
+// EEPROM（IAP）追加写日志
+// 记录只追加不改写，扇区按环形顺序使用；当前扇区写满后打开下一扇区，并回收其后的最旧扇区：
+// 最旧扇区中仍是最新的快照类记录先搬移到当前扇区，再整扇区擦除，保证"下一扇区已擦除"
+// 上电时按扇区序号从旧到新回放全部有效记录，由使用者在IapLog_OnReplay中重建RAM数据
+//
+// 上位机测试：tools/iap_log_sim.c 以RAM模拟EEPROM编译本文件（定义IAP_LOG_HOST），含掉电注入
+
+#ifndef IAP_LOG_HOST
+#include "STC32G.H"       // STC32G单片机核心头文件（IAP寄存器）
+#include "config.h"       // 系统配置头文件（FOSC）
+#include <intrins.h>
+#endif
+#include "iap_log.h"
+
+#define IAP_PIN_NONE        0xFF          // 快照类型无记录
+
+// ------------------- 全局变量 -------------------
+unsigned char iap_log_ready = 0;          // 1=已挂载，可写入
+unsigned int iap_log_replayed = 0;        // 挂载时回放的有效记录数
+unsigned int iap_log_torn = 0;            // 挂载时跳过的损坏记录数
+unsigned int iap_log_gc_count = 0;        // 本次上电以来回收的扇区数
+
+static unsigned char iap_head;            // 当前写入扇区
+static unsigned int iap_head_off;         // 当前扇区写入偏移
+static unsigned long iap_head_seq;        // 当前扇区序号
+static unsigned char iap_pin_sector[IAP_LOG_PINNED_MAX];  // 各快照类型最新记录所在扇区
+static unsigned int iap_pin_off[IAP_LOG_PINNED_MAX];      // 各快照类型最新记录的扇区内偏移
+static unsigned char iap_buf[IAP_LOG_REC_MAX + 3];        // 记录读取/搬移缓冲区
+
+// ------------------- 静态函数声明 -------------------
+static unsigned char Iap_ReadByte(unsigned long addr);            // 读1字节
+static void Iap_ProgramByte(unsigned long addr, unsigned char dat); // 写1字节（只能1→0）
+static void Iap_EraseSector(unsigned long addr);                  // 擦除扇区（全部置0xFF）
+static unsigned char Crc8(unsigned char crc, unsigned char dat);  // CRC8（多项式0x07）累加1字节
+static unsigned long Sector_Addr(unsigned char sector);           // 扇区起始地址
+static bit Sector_ReadHeader(unsigned char sector, unsigned long *seq);  // 读扇区头（1=有效）
+static bit Sector_IsErased(unsigned char sector);                 // 扇区是否全部为0xFF
+static void Sector_WriteHeader(unsigned char sector, unsigned long seq);  // 擦除（如需）并写扇区头
+static void Sector_Open(unsigned char sector, unsigned long seq); // 写扇区头并设为日志当前扇区
+static unsigned int Sector_Scan(unsigned char sector, bit replay);  // 扫描扇区记录，返回空闲区起始偏移
+static void Rec_Program(unsigned char type, const unsigned char *payload, unsigned char len);  // 在当前位置写一条记录
+static void Gc_Next(void);                                        // 回收当前扇区的下一个扇区
+
+// ------------------- 底层读写 -------------------
+#ifdef IAP_LOG_HOST
+// 上位机模拟：由tools/iap_log_sim.c提供
+extern unsigned char SimFlash_Read(unsigned long addr);
+extern void SimFlash_Program(unsigned long addr, unsigned char dat);
+extern void SimFlash_Erase(unsigned long addr);
+
+static unsigned char Iap_ReadByte(unsigned long addr)
+{
+    return SimFlash_Read(addr);
+}
+
+static void Iap_ProgramByte(unsigned long addr, unsigned char dat)
+{
+    SimFlash_Program(addr, dat);
+}
+
+static void Iap_EraseSector(unsigned long addr)
+{
+    SimFlash_Erase(addr);
+}
+#else
+// 关闭IAP功能，地址指向非EEPROM区，防止误操作
+static void Iap_Idle(void)
+{
+    IAP_CONTR = 0;
+    IAP_CMD = 0;
+    IAP_TRIG = 0;
+    IAP_ADDRE = 0xFF;
+    IAP_ADDRH = 0xFF;
+    IAP_ADDRL = 0xFF;
+}
+
+// 设置地址并触发命令（触发序列期间关中断，擦写期间CPU自动暂停）
+static void Iap_Command(unsigned char cmd, unsigned long addr)
+{
+    bit ea_save;
+
+    IAP_CONTR = 0x80;                     // 使能IAP
+    IAP_TPS = (unsigned char)IAP_TPS_VALUE;
+    IAP_CMD = cmd;
+    IAP_ADDRL = (unsigned char)addr;
+    IAP_ADDRH = (unsigned char)(addr >> 8);
+    IAP_ADDRE = (unsigned char)(addr >> 16);
+    ea_save = EA;
+    EA = 0;
+    IAP_TRIG = 0x5A;
+    IAP_TRIG = 0xA5;
+    _nop_();
+    _nop_();
+    _nop_();
+    _nop_();
+    EA = ea_save;
+}
+
+static unsigned char Iap_ReadByte(unsigned long addr)
+{
+    unsigned char dat;
+
+    Iap_Command(1, addr);
+    dat = IAP_DATA;
+    Iap_Idle();
+    return dat;
+}
+
+static void Iap_ProgramByte(unsigned long addr, unsigned char dat)
+{
+    IAP_DATA = dat;
+    Iap_Command(2, addr);
+    Iap_Idle();
+}
+
+static void Iap_EraseSector(unsigned long addr)
+{
+    Iap_Command(3, addr);
+    Iap_Idle();
+}
+#endif
+
+static unsigned char Crc8(unsigned char crc, unsigned char dat)
+{
+    unsigned char i;
+
+    crc ^= dat;
+    for (i = 0; i < 8; i++)
+    {
+        crc = (crc & 0x80) ? (unsigned char)((crc << 1) ^ 0x07) : (unsigned char)(crc << 1);
+    }
+    return crc;
+}
+
+// ------------------- 扇区操作 -------------------
+static unsigned long Sector_Addr(unsigned char sector)
+{
+    return IAP_LOG_BASE + (unsigned long)sector * IAP_SECTOR_SIZE;
+}
+
+static bit Sector_ReadHeader(unsigned char sector, unsigned long *seq)
+{
+    unsigned long addr = Sector_Addr(sector);
+    unsigned char hdr[8];
+    unsigned char crc = 0;
+    unsigned char i;
+
+    for (i = 0; i < 8; i++)
+    {
+        hdr[i] = Iap_ReadByte(addr + i);
+    }
+    for (i = 0; i < 6; i++)
+    {
+        crc = Crc8(crc, hdr[i]);
+    }
+    if (hdr[0] != IAP_LOG_MAGIC0 || hdr[1] != IAP_LOG_MAGIC1 || hdr[6] != crc || hdr[7] != 0)
+    {
+        return 0;
+    }
+
+    *seq = (unsigned long)hdr[2] | ((unsigned long)hdr[3] << 8) |
+           ((unsigned long)hdr[4] << 16) | ((unsigned long)hdr[5] << 24);
+    return 1;
+}
+
+static bit Sector_IsErased(unsigned char sector)
+{
+    unsigned long addr = Sector_Addr(sector);
+    unsigned int i;
+
+    for (i = 0; i < IAP_SECTOR_SIZE; i++)
+    {
+        if (Iap_ReadByte(addr + i) != 0xFF)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void Sector_WriteHeader(unsigned char sector, unsigned long seq)
+{
+    unsigned long addr = Sector_Addr(sector);
+    unsigned char hdr[8];
+    unsigned char i;
+
+    if (!Sector_IsErased(sector))
+    {
+        Iap_EraseSector(addr);
+    }
+
+    hdr[0] = IAP_LOG_MAGIC0;
+    hdr[1] = IAP_LOG_MAGIC1;
+    hdr[2] = (unsigned char)seq;
+    hdr[3] = (unsigned char)(seq >> 8);
+    hdr[4] = (unsigned char)(seq >> 16);
+    hdr[5] = (unsigned char)(seq >> 24);
+    hdr[6] = 0;
+    hdr[7] = 0;
+    for (i = 0; i < 6; i++)
+    {
+        hdr[6] = Crc8(hdr[6], hdr[i]);
+    }
+    for (i = 0; i < 8; i++)
+    {
+        Iap_ProgramByte(addr + i, hdr[i]);
+    }
+}
+
+static void Sector_Open(unsigned char sector, unsigned long seq)
+{
+    Sector_WriteHeader(sector, seq);
+    iap_head = sector;
+    iap_head_seq = seq;
+    iap_head_off = IAP_LOG_HDR_LEN;
+}
+
+// 逐条扫描扇区记录：有效记录更新快照位置，replay=1时回放；损坏记录按长度跳过
+static unsigned int Sector_Scan(unsigned char sector, bit replay)
+{
+    unsigned long addr = Sector_Addr(sector);
+    unsigned int off = IAP_LOG_HDR_LEN;
+    unsigned char type;
+    unsigned char len;
+    unsigned char crc;
+    unsigned char i;
+
+    while (off + 3 <= IAP_SECTOR_SIZE)
+    {
+        type = Iap_ReadByte(addr + off);
+        len = Iap_ReadByte(addr + off + 1);
+
+        // 空闲区
+        if (len == 0xFF && type == 0xFF)
+        {
+            break;
+        }
+        // 长度损坏（超出扇区）：其后无法定位，视为扇区已满
+        if (len == 0xFF || off + len + 3 > IAP_SECTOR_SIZE)
+        {
+            iap_log_torn++;
+            return IAP_SECTOR_SIZE;
+        }
+
+        crc = Crc8(Crc8(0, type), len);
+        for (i = 0; i < len; i++)
+        {
+            iap_buf[i] = Iap_ReadByte(addr + off + 2 + i);
+            crc = Crc8(crc, iap_buf[i]);
+        }
+
+        if (type != 0xFF && type != 0 && crc == Iap_ReadByte(addr + off + 2 + len))
+        {
+            if (type < IAP_LOG_PINNED_MAX)
+            {
+                iap_pin_sector[type] = sector;
+                iap_pin_off[type] = off;
+            }
+            if (replay)
+            {
+                iap_log_replayed++;
+                IapLog_OnReplay(type, iap_buf, len);
+            }
+        }
+        else
+        {
+            iap_log_torn++;
+        }
+        off += len + 3;
+    }
+    return off;
+}
+
+// ------------------- 记录写入与扇区回收 -------------------
+// 在当前扇区写入位置写一条记录（调用者保证空间足够），类型字节最后写入
+static void Rec_Program(unsigned char type, const unsigned char *payload, unsigned char len)
+{
+    unsigned long addr = Sector_Addr(iap_head) + iap_head_off;
+    unsigned char crc;
+    unsigned char i;
+
+    crc = Crc8(Crc8(0, type), len);
+    Iap_ProgramByte(addr + 1, len);
+    for (i = 0; i < len; i++)
+    {
+        Iap_ProgramByte(addr + 2 + i, payload[i]);
+        crc = Crc8(crc, payload[i]);
+    }
+    Iap_ProgramByte(addr + 2 + len, crc);
+    Iap_ProgramByte(addr, type);
+
+    if (type < IAP_LOG_PINNED_MAX)
+    {
+        iap_pin_sector[type] = iap_head;
+        iap_pin_off[type] = iap_head_off;
+    }
+    iap_head_off += len + 3;
+}
+
+// 回收当前扇区的下一个扇区（最旧扇区）：搬移其中仍为最新的快照记录后整扇区擦除
+static void Gc_Next(void)
+{
+    unsigned char next = (iap_head + 1) % IAP_LOG_SECTORS;
+    unsigned long addr = Sector_Addr(next);
+    unsigned char type;
+    unsigned char len;
+    unsigned char i;
+
+    if (Sector_IsErased(next))
+    {
+        return;
+    }
+
+    for (type = 1; type < IAP_LOG_PINNED_MAX; type++)
+    {
+        if (iap_pin_sector[type] != next)
+        {
+            continue;
+        }
+        len = Iap_ReadByte(addr + iap_pin_off[type] + 1);
+        for (i = 0; i < len; i++)
+        {
+            iap_buf[i] = Iap_ReadByte(addr + iap_pin_off[type] + 2 + i);
+        }
+        // 当前扇区刚打开时空间足够；挂载时补做回收若空间不足则放弃该快照
+        if (iap_head_off + len + 3 <= IAP_SECTOR_SIZE)
+        {
+            Rec_Program(type, iap_buf, len);
+        }
+        else
+        {
+            iap_pin_sector[type] = IAP_PIN_NONE;
+        }
+    }
+
+    Iap_EraseSector(addr);
+    iap_log_gc_count++;
+}
+
+// ------------------- 对外接口 -------------------
+void IapLog_Mount(void)
+{
+    unsigned char sector;
+    unsigned char head = IAP_PIN_NONE;
+    unsigned char i;
+    unsigned long seq;
+    unsigned long head_seq = 0;
+    unsigned int off;
+
+    iap_log_ready = 0;
+    iap_log_replayed = 0;
+    iap_log_torn = 0;
+    for (i = 0; i < IAP_LOG_PINNED_MAX; i++)
+    {
+        iap_pin_sector[i] = IAP_PIN_NONE;
+    }
+
+    // 1. 序号最大的有效扇区为当前扇区
+    for (sector = 0; sector < IAP_LOG_SECTORS; sector++)
+    {
+        if (Sector_ReadHeader(sector, &seq) && (head == IAP_PIN_NONE || seq > head_seq))
+        {
+            head = sector;
+            head_seq = seq;
+        }
+    }
+    if (head == IAP_PIN_NONE)
+    {
+        IapLog_Format();
+        return;
+    }
+
+    // 2. 从当前扇区的下一个扇区（最旧）开始按环形顺序回放
+    iap_head = head;
+    iap_head_seq = head_seq;
+    iap_head_off = IAP_LOG_HDR_LEN;
+    for (i = 1; i <= IAP_LOG_SECTORS; i++)
+    {
+        sector = (head + i) % IAP_LOG_SECTORS;
+        if (Sector_ReadHeader(sector, &seq))
+        {
+            off = Sector_Scan(sector, 1);
+            if (sector == head)
+            {
+                iap_head_off = off;
+            }
+        }
+    }
+
+    // 3. 上次回收可能被掉电打断：补做，保证下一扇区已擦除
+    Gc_Next();
+    iap_log_ready = 1;
+}
+
+bit IapLog_Append(unsigned char type, const unsigned char *payload, unsigned char len)
+{
+    if (!iap_log_ready || type == 0 || type == 0xFF || len > IAP_LOG_REC_MAX)
+    {
+        return 0;
+    }
+
+    // 当前扇区放不下：打开下一扇区（已擦除），再回收其后的最旧扇区
+    if (iap_head_off + len + 3 > IAP_SECTOR_SIZE)
+    {
+        Sector_Open((iap_head + 1) % IAP_LOG_SECTORS, iap_head_seq + 1);
+        Gc_Next();
+    }
+
+    Rec_Program(type, payload, len);
+    return 1;
+}
+
+void IapLog_Format(void)
+{
+    unsigned char sector;
+    unsigned char i;
+
+    for (sector = 0; sector < IAP_LOG_SECTORS; sector++)
+    {
+        if (!Sector_IsErased(sector))
+        {
+            Iap_EraseSector(Sector_Addr(sector));
+        }
+    }
+    for (i = 0; i < IAP_LOG_PINNED_MAX; i++)
+    {
+        iap_pin_sector[i] = IAP_PIN_NONE;
+    }
+
+    Sector_Open(0, 1);
+    iap_log_ready = 1;
+}
+
+// ------------------- 定长记录区 -------------------
+static unsigned long Area_SlotAddr(const IapArea *a, unsigned char k, unsigned char slot)
+{
+    return Sector_Addr(a->first + k) + IAP_LOG_HDR_LEN + (unsigned long)slot * (a->rec_len + 2 + a->aux_len);
+}
+
+void IapArea_Mount(IapArea *a)
+{
+    unsigned char k;
+    unsigned char s;
+    unsigned char found = 0;
+    unsigned long seq;
+    unsigned long addr;
+    unsigned int i;
+
+    // 1. 序号最大的有效扇区为当前扇区
+    a->head = 0;
+    a->seq = 0;
+    a->slot = 0;
+    for (k = 0; k < a->sectors; k++)
+    {
+        if (Sector_ReadHeader(a->first + k, &seq) && (!found || seq > a->seq))
+        {
+            a->head = k;
+            a->seq = seq;
+            found = 1;
+        }
+    }
+    if (!found)
+    {
+        a->seq = 1;
+        Sector_WriteHeader(a->first, a->seq);
+        return;
+    }
+
+    // 2. 空闲槽：最后一个非空槽之后（掉电中断的槽也视为已用）
+    for (s = IAP_AREA_SLOTS_AUX(a->rec_len, a->aux_len); s > 0; s--)
+    {
+        addr = Area_SlotAddr(a, a->head, s - 1);
+        for (i = 0; i < (unsigned int)a->rec_len + 2; i++)
+        {
+            if (Iap_ReadByte(addr + i) != 0xFF)
+            {
+                break;
+            }
+        }
+        if (i < (unsigned int)a->rec_len + 2)
+        {
+            a->slot = s;
+            break;
+        }
+    }
+}
+
+void IapArea_Begin(IapArea *a)
+{
+    if (a->slot >= IAP_AREA_SLOTS_AUX(a->rec_len, a->aux_len))
+    {
+        a->head = (a->head + 1) % a->sectors;
+        a->seq++;
+        Sector_WriteHeader(a->first + a->head, a->seq);
+        a->slot = 0;
+    }
+
+    a->wr_addr = Area_SlotAddr(a, a->head, a->slot);
+    a->wr_crc = 0;
+    a->slot++;                            // 槽一经写入即视为已用
+}
+
+void IapArea_Put(IapArea *a, const unsigned char *dat, unsigned char len)
+{
+    unsigned char i;
+
+    for (i = 0; i < len; i++)
+    {
+        Iap_ProgramByte(a->wr_addr++, dat[i]);
+        a->wr_crc = Crc8(a->wr_crc, dat[i]);
+    }
+}
+
+void IapArea_Commit(IapArea *a)
+{
+    unsigned long addr = Area_SlotAddr(a, a->head, a->slot - 1) + a->rec_len;
+
+    Iap_ProgramByte(addr, a->wr_crc);
+    Iap_ProgramByte(addr + 1, 0x00);
+}
+
+void IapArea_IterBegin(const IapArea *a, IapAreaIter *it)
+{
+    it->k = 0;
+    it->slot = IAP_AREA_SLOTS_AUX(a->rec_len, a->aux_len);
+    it->addr = 0;
+}
+
+// 从当前扇区的下一个扇区（最旧）起按环形顺序遍历；扇区序号与当前扇区不连续（未写过或已过期）的跳过
+bit IapArea_Next(const IapArea *a, IapAreaIter *it)
+{
+    unsigned char slots = IAP_AREA_SLOTS_AUX(a->rec_len, a->aux_len);
+    unsigned char k;
+    unsigned char crc;
+    unsigned char i;
+    unsigned long seq;
+    unsigned long addr;
+
+    while (1)
+    {
+        if (it->slot >= ((it->k == a->sectors) ? a->slot : slots))
+        {
+            if (it->k == a->sectors)
+            {
+                return 0;
+            }
+            it->k++;
+            k = (a->head + it->k) % a->sectors;
+            it->slot = (Sector_ReadHeader(a->first + k, &seq) &&
+                        seq == a->seq - a->sectors + it->k) ? 0 : slots;
+            continue;
+        }
+
+        k = (a->head + it->k) % a->sectors;
+        addr = Area_SlotAddr(a, k, it->slot);
+        it->slot++;
+        if (Iap_ReadByte(addr + a->rec_len + 1) != 0x00)
+        {
+            continue;                     // 未提交（掉电中断）
+        }
+        crc = 0;
+        for (i = 0; i < a->rec_len; i++)
+        {
+            crc = Crc8(crc, Iap_ReadByte(addr + i));
+        }
+        if (crc == Iap_ReadByte(addr + a->rec_len))
+        {
+            it->addr = addr;
+            return 1;
+        }
+    }
+}
+
+void IapArea_Read(const IapAreaIter *it, unsigned char off, unsigned char *buf, unsigned char len)
+{
+    unsigned char i;
+
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = Iap_ReadByte(it->addr + off + i);
+    }
+}
+
+// 只能把1写为0：要清的位在EEPROM中已为0时不影响，其余位保持不变
+void IapArea_ClearBits(const IapAreaIter *it, unsigned char off, unsigned char bits)
+{
+    Iap_ProgramByte(it->addr + off, (unsigned char)~bits);
+}
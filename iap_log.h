@@ -0,0 +1,86 @@
+#ifndef __IAP_LOG_H__
+#define __IAP_LOG_H__
+
+// ------------------- EEPROM（IAP）日志区配置 -------------------
+// 下载程序时需在STC-ISP中把EEPROM大小设置为不小于IAP_LOG_SECTORS×IAP_SECTOR_SIZE（另加使用者分配的定长记录区）
+#ifndef IAP_LOG_SECTORS
+#define IAP_LOG_SECTORS     64            // 日志区扇区数（64×512=32KB）
+#endif
+#define IAP_SECTOR_SIZE     512           // STC32G EEPROM扇区大小（擦除单位）
+#define IAP_LOG_BASE        0x000000UL    // 日志区起始地址（EEPROM内部地址）
+#define IAP_TPS_VALUE       (FOSC / 1000000UL)  // IAP擦写等待参数（系统时钟MHz数）
+
+// ------------------- 日志格式 -------------------
+// 扇区按环形顺序依次使用（磨损均衡），每个扇区开头为8字节扇区头：
+//   [0-1] 魔数 IAP_LOG_MAGIC0/1   [2-5] 扇区序号（小端，逐个递增）   [6] 前6字节CRC8   [7] 0x00
+// 第7字节最后写入作为提交标志，写扇区头时掉电则该字节不为0，整个扇区视为无效
+// 扇区头之后依次为记录：
+//   [0] 类型   [1] 数据长度N   [2..N+1] 数据   [N+2] CRC8（覆盖类型、长度、数据）
+// 写入顺序为长度→数据→CRC→类型，类型字节最后写入作为提交标志：掉电中断的记录类型为0xFF
+// 或CRC不符，回放时按长度跳过，不影响其后的记录
+#define IAP_LOG_MAGIC0      0x4C          // 'L'
+#define IAP_LOG_MAGIC1      0x47          // 'G'
+#define IAP_LOG_HDR_LEN     8             // 扇区头长度
+#define IAP_LOG_REC_MAX     250           // 单条记录数据最大长度（长度字节0xFF保留给空闲区）
+
+// 类型1~(IAP_LOG_PINNED_MAX-1)为快照类：只有最新一条有效，回收扇区时搬移到当前扇区；
+// 类型IAP_LOG_PINNED_MAX~0xFE为流水类：随所在扇区回收而丢弃
+// 全部快照类记录（每条数据长度+3）之和不应超过(IAP_SECTOR_SIZE-IAP_LOG_HDR_LEN)/2，
+// 以便回收被掉电打断后，上电时能在同一扇区内重新搬移
+#define IAP_LOG_PINNED_MAX  8
+
+// ------------------- 定长记录区 -------------------
+// 日志区之后可划出若干定长记录区（扇区号从IAP_LOG_SECTORS起，由使用者分配），每区若干扇区按环形顺序使用：
+// 扇区头与日志区相同（序号在区内逐个递增），其后为IAP_AREA_SLOTS(rec_len)个定长记录槽：
+//   [0..rec_len-1] 数据   [rec_len] CRC8（覆盖数据）   [rec_len+1] 提交标志0x00（最后写入）
+// 掉电中断的记录提交标志为0xFF，读取时跳过；当前扇区写满后擦除并打开下一扇区，其中最旧的记录随之丢弃，
+// 因此一个区至少保留(扇区数-1)×IAP_AREA_SLOTS(rec_len)条最新记录（掉电中断的槽除外）。记录流式写入，不占用RAM缓冲区
+// 区可另设aux_len个附加字节（紧跟提交标志，不受CRC保护）：写入记录时保持0xFF，之后可用IapArea_ClearBits逐位清0，
+// 用于记录写入后仍需改变的标志（如删除标志）
+#define IAP_AREA_SLOTS_AUX(rec_len, aux_len)  ((IAP_SECTOR_SIZE - IAP_LOG_HDR_LEN) / ((rec_len) + 2 + (aux_len)))
+#define IAP_AREA_SLOTS(rec_len)   IAP_AREA_SLOTS_AUX(rec_len, 0)   // 每扇区记录数（无附加字节）
+#define IAP_AREA_AUX(rec_len)     ((rec_len) + 2)   // 附加字节在槽内的偏移（IapArea_Read/IapArea_ClearBits使用）
+
+typedef struct {
+    unsigned char first;                  // 首扇区号（不小于IAP_LOG_SECTORS）
+    unsigned char sectors;                // 扇区数（不少于2）
+    unsigned char rec_len;                // 记录数据长度
+    unsigned char aux_len;                // 附加字节数（0=无）
+    unsigned char head;                   // 当前扇区（区内序号0~sectors-1）
+    unsigned char slot;                   // 当前扇区下一个空闲槽
+    unsigned long seq;                    // 当前扇区序号
+    unsigned long wr_addr;                // 正在写入的记录的下一字节地址
+    unsigned char wr_crc;                 // 正在写入的记录的CRC
+} IapArea;
+
+// 遍历位置（从旧到新）
+typedef struct {
+    unsigned char k;                      // 已遍历到第k个扇区（1~sectors，sectors为当前扇区）
+    unsigned char slot;                   // 下一个待读槽
+    unsigned long addr;                   // 最近一条有效记录的地址（IapArea_Read使用）
+} IapAreaIter;
+
+// ------------------- 运行状态 -------------------
+extern unsigned char iap_log_ready;       // 1=已挂载，可写入
+extern unsigned int iap_log_replayed;     // 挂载时回放的有效记录数
+extern unsigned int iap_log_torn;         // 挂载时跳过的损坏记录数
+extern unsigned int iap_log_gc_count;     // 本次上电以来回收的扇区数
+
+// ------------------- 函数声明 -------------------
+void IapLog_Mount(void);                  // 扫描扇区、按写入顺序回放全部记录并确定写入位置（无有效扇区时格式化）
+bit IapLog_Append(unsigned char type, const unsigned char *payload, unsigned char len);  // 追加一条记录（1=成功）
+void IapLog_Format(void);                 // 擦除日志区并重新开始
+
+void IapArea_Mount(IapArea *a);           // 找到序号最大的有效扇区及其空闲槽（无有效扇区时打开区内首扇区）
+void IapArea_Begin(IapArea *a);           // 开始写一条记录（当前扇区已满时擦除并打开下一扇区）
+void IapArea_Put(IapArea *a, const unsigned char *dat, unsigned char len);  // 写入记录数据（可分多次，合计rec_len字节）
+void IapArea_Commit(IapArea *a);          // 写CRC和提交标志
+void IapArea_IterBegin(const IapArea *a, IapAreaIter *it);   // 从最旧的记录开始遍历
+bit IapArea_Next(const IapArea *a, IapAreaIter *it);         // 下一条有效记录（校验CRC），0=已到最新
+void IapArea_Read(const IapAreaIter *it, unsigned char off, unsigned char *buf, unsigned char len);  // 读当前记录的部分数据/附加字节
+void IapArea_ClearBits(const IapAreaIter *it, unsigned char off, unsigned char bits);  // 当前记录附加字节中bits各位清0
+
+// 回放回调（由使用者实现）：挂载时每条有效记录调用一次，顺序与写入顺序相同
+void IapLog_OnReplay(unsigned char type, const unsigned char *payload, unsigned char len);
+
+#endif
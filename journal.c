@@ -0,0 +1,395 @@
+// 事件日志（各类事件共用的字节环，格式见journal.h）
+// 记录可跨越缓冲区末尾，所有读写经Jr_Get/Jr_Set按环形地址访问；
+// jr_head为最旧记录位置，jr_used为已用字节数，jr_first_seq为最旧记录序号（日志为空时等于jr_next_seq）
+// 上位机测试：tools/alarm_replay.c 直接编译本文件（定义JR_HOST），回放报警判断
+
+#ifndef JR_HOST
+#include "STC32G.H"
+#endif
+#include <string.h>       // NULL
+#include "journal.h"
+
+#define JR_WRAP(p)          ((unsigned int)((p) >= JOURNAL_SIZE ? (p) - JOURNAL_SIZE : (p)))
+
+// ------------------- 全局变量 -------------------
+static unsigned char jr_buf[JOURNAL_SIZE];        // 日志缓冲区
+static unsigned int jr_head;                      // 最旧记录位置
+static unsigned int jr_used;                      // 已用字节数
+static unsigned int jr_first_seq;                 // 最旧记录序号
+static unsigned int jr_next_seq;                  // 下一条记录序号
+static unsigned int jr_count[JOURNAL_TYPE_MAX];   // 各类型未删除记录数
+
+// ------------------- 静态函数声明 -------------------
+static unsigned char Jr_Get(unsigned int pos, unsigned char off);
+static void Jr_Set(unsigned int pos, unsigned char off, unsigned char val);
+static void Jr_DropOldest(void);                  // 丢弃最旧一条记录
+static bit Jr_RefLive(const JournalRef *ref);     // 引用的记录仍在日志内
+static void Jr_Load(unsigned int pos, JournalEntry *e);
+static void Jr_Write(unsigned char type, unsigned int seq, unsigned char aid, const rtc_time_t *time,
+                     const unsigned char *dat, unsigned char len, JournalRef *ref);
+static bit Jr_TimeBefore(const rtc_time_t *a, const rtc_time_t *b);
+
+// ------------------- 环形访问 -------------------
+static unsigned char Jr_Get(unsigned int pos, unsigned char off)
+{
+    return jr_buf[JR_WRAP(pos + off)];
+}
+
+static void Jr_Set(unsigned int pos, unsigned char off, unsigned char val)
+{
+    jr_buf[JR_WRAP(pos + off)] = val;
+}
+
+static void Jr_DropOldest(void)
+{
+    unsigned char len = Jr_Get(jr_head, 0);
+    unsigned char type = Jr_Get(jr_head, 1);
+
+    if (!(type & JOURNAL_FLAG_DELETED))
+    {
+        jr_count[type & JOURNAL_TYPE_MASK]--;
+    }
+    jr_head = JR_WRAP(jr_head + len);
+    jr_used -= len;
+    jr_first_seq = jr_used ? ((unsigned int)Jr_Get(jr_head, 2) | ((unsigned int)Jr_Get(jr_head, 3) << 8))
+                           : jr_next_seq;
+}
+
+// 序号在[jr_first_seq, jr_next_seq)内：记录未被丢弃，位置仍然有效
+static bit Jr_RefLive(const JournalRef *ref)
+{
+    return (ref->pos < JOURNAL_SIZE &&
+            (unsigned int)(ref->seq - jr_first_seq) < (unsigned int)(jr_next_seq - jr_first_seq)) ? 1 : 0;
+}
+
+static void Jr_Load(unsigned int pos, JournalEntry *e)
+{
+    unsigned char i;
+    unsigned char *t = (unsigned char *)&e->time;
+
+    e->ref.pos = pos;
+    e->ref.seq = (unsigned int)Jr_Get(pos, 2) | ((unsigned int)Jr_Get(pos, 3) << 8);
+    e->type = Jr_Get(pos, 1) & JOURNAL_TYPE_MASK;
+    e->aid = Jr_Get(pos, 4);
+    for (i = 0; i < sizeof(rtc_time_t); i++)
+    {
+        t[i] = Jr_Get(pos, 5 + i);
+    }
+    e->len = Jr_Get(pos, 0) - JOURNAL_HDR_LEN;
+    for (i = 0; i < e->len; i++)
+    {
+        e->dat[i] = Jr_Get(pos, JOURNAL_HDR_LEN + i);
+    }
+}
+
+// 腾出空间后在尾部写入一条记录
+static void Jr_Write(unsigned char type, unsigned int seq, unsigned char aid, const rtc_time_t *time,
+                     const unsigned char *dat, unsigned char len, JournalRef *ref)
+{
+    unsigned char total = JOURNAL_HDR_LEN + len;
+    unsigned int pos;
+    unsigned char i;
+    const unsigned char *t = (const unsigned char *)time;
+
+    while (JOURNAL_SIZE - jr_used < total)
+    {
+        Jr_DropOldest();
+    }
+    if (jr_used == 0)
+    {
+        jr_first_seq = seq;
+    }
+    pos = JR_WRAP(jr_head + jr_used);
+    Jr_Set(pos, 0, total);
+    Jr_Set(pos, 1, type);
+    Jr_Set(pos, 2, (unsigned char)(seq & 0xFF));
+    Jr_Set(pos, 3, (unsigned char)(seq >> 8));
+    Jr_Set(pos, 4, aid);
+    for (i = 0; i < sizeof(rtc_time_t); i++)
+    {
+        Jr_Set(pos, 5 + i, t[i]);
+    }
+    for (i = 0; i < len; i++)
+    {
+        Jr_Set(pos, JOURNAL_HDR_LEN + i, dat[i]);
+    }
+    jr_used += total;
+    jr_next_seq = seq + 1;
+    if (!(type & JOURNAL_FLAG_DELETED))
+    {
+        jr_count[type & JOURNAL_TYPE_MASK]++;
+    }
+    if (ref != NULL)
+    {
+        ref->pos = pos;
+        ref->seq = seq;
+    }
+}
+
+static bit Jr_TimeBefore(const rtc_time_t *a, const rtc_time_t *b)
+{
+    if (a->year != b->year)
+    {
+        return (a->year < b->year) ? 1 : 0;
+    }
+    if (a->mon != b->mon)
+    {
+        return (a->mon < b->mon) ? 1 : 0;
+    }
+    if (a->day != b->day)
+    {
+        return (a->day < b->day) ? 1 : 0;
+    }
+    if (a->hour != b->hour)
+    {
+        return (a->hour < b->hour) ? 1 : 0;
+    }
+    if (a->min != b->min)
+    {
+        return (a->min < b->min) ? 1 : 0;
+    }
+    return (a->sec < b->sec) ? 1 : 0;
+}
+
+// ------------------- 对外接口 -------------------
+void Journal_Init(void)
+{
+    unsigned char i;
+
+    jr_head = 0;
+    jr_used = 0;
+    jr_first_seq = 0;
+    jr_next_seq = 0;
+    for (i = 0; i < JOURNAL_TYPE_MAX; i++)
+    {
+        jr_count[i] = 0;
+    }
+}
+
+bit Journal_Append(unsigned char type, unsigned char aid, const rtc_time_t *time,
+                   const void *dat, unsigned char len, JournalRef *ref)
+{
+    if (type == 0 || type >= JOURNAL_TYPE_MAX || len > JOURNAL_DATA_MAX)
+    {
+        return 0;
+    }
+    Jr_Write(type, jr_next_seq, aid, time, (const unsigned char *)dat, len, ref);
+    return 1;
+}
+
+bit Journal_Read(const JournalRef *ref, JournalEntry *e)
+{
+    if (!Jr_RefLive(ref) || (Jr_Get(ref->pos, 1) & JOURNAL_FLAG_DELETED))
+    {
+        return 0;
+    }
+    Jr_Load(ref->pos, e);
+    return 1;
+}
+
+void Journal_Update(const JournalRef *ref, const rtc_time_t *time, const void *dat)
+{
+    unsigned char i;
+    unsigned char len;
+    const unsigned char *t = (const unsigned char *)time;
+    const unsigned char *d = (const unsigned char *)dat;
+
+    if (!Jr_RefLive(ref))
+    {
+        return;
+    }
+    for (i = 0; i < sizeof(rtc_time_t); i++)
+    {
+        Jr_Set(ref->pos, 5 + i, t[i]);
+    }
+    len = Jr_Get(ref->pos, 0) - JOURNAL_HDR_LEN;
+    for (i = 0; i < len; i++)
+    {
+        Jr_Set(ref->pos, JOURNAL_HDR_LEN + i, d[i]);
+    }
+}
+
+void Journal_Delete(const JournalRef *ref)
+{
+    unsigned char type;
+
+    if (!Jr_RefLive(ref))
+    {
+        return;
+    }
+    type = Jr_Get(ref->pos, 1);
+    if (!(type & JOURNAL_FLAG_DELETED))
+    {
+        Jr_Set(ref->pos, 1, type | JOURNAL_FLAG_DELETED);
+        jr_count[type & JOURNAL_TYPE_MASK]--;
+    }
+}
+
+void Journal_DeleteAll(unsigned char type)
+{
+    unsigned int pos = jr_head;
+    unsigned int left = jr_used;
+    unsigned char len;
+
+    while (left > 0)
+    {
+        len = Jr_Get(pos, 0);
+        if (Jr_Get(pos, 1) == type)
+        {
+            Jr_Set(pos, 1, type | JOURNAL_FLAG_DELETED);
+        }
+        pos = JR_WRAP(pos + len);
+        left -= len;
+    }
+    if (type < JOURNAL_TYPE_MAX)
+    {
+        jr_count[type] = 0;
+    }
+}
+
+unsigned int Journal_Count(unsigned char type)
+{
+    return (type < JOURNAL_TYPE_MAX) ? jr_count[type] : 0;
+}
+
+void Journal_IterBegin(JournalIter *it, unsigned char type, unsigned char aid)
+{
+    it->type = type;
+    it->aid = aid;
+    it->since.year = 0;
+    it->since.mon = 0;
+    it->since.day = 0;
+    it->since.hour = 0;
+    it->since.min = 0;
+    it->since.sec = 0;
+    it->pos = jr_head;
+    it->left = jr_used;
+}
+
+// 先比较记录头中的类型和AID，符合条件才读出整条记录
+bit Journal_Next(JournalIter *it, JournalEntry *e)
+{
+    unsigned int pos;
+    unsigned char len;
+    unsigned char type;
+
+    while (it->left > 0)
+    {
+        pos = it->pos;
+        len = Jr_Get(pos, 0);
+        type = Jr_Get(pos, 1);
+        it->pos = JR_WRAP(pos + len);
+        it->left -= len;
+
+        if ((type & JOURNAL_FLAG_DELETED) ||
+            (it->type != 0 && type != it->type) ||
+            (it->aid != 0 && Jr_Get(pos, 4) != it->aid))
+        {
+            continue;
+        }
+        Jr_Load(pos, e);
+        if (it->since.year != 0 && Jr_TimeBefore(&e->time, &it->since))
+        {
+            continue;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// 记录只能从旧到新遍历：先数出符合条件的条数，再取第(条数-1-nth)条
+bit Journal_FindNewest(unsigned char type, unsigned char aid, unsigned int nth, JournalEntry *e)
+{
+    JournalIter it;
+    unsigned int total;
+
+    if (aid == 0 && type != 0)
+    {
+        total = Journal_Count(type);
+    }
+    else
+    {
+        total = 0;
+        Journal_IterBegin(&it, type, aid);
+        while (Journal_Next(&it, e))
+        {
+            total++;
+        }
+    }
+    if (nth >= total)
+    {
+        return 0;
+    }
+
+    Journal_IterBegin(&it, type, aid);
+    total -= nth;
+    while (Journal_Next(&it, e))
+    {
+        if (--total == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 从最新往回累计未删除记录的长度不超过max：先求全部未删除记录总长，再从最旧一端跳过多出的部分
+unsigned int Journal_Export(unsigned char *buf, unsigned int max)
+{
+    unsigned int pos = jr_head;
+    unsigned int left = jr_used;
+    unsigned int live = 0;
+    unsigned int out = 0;
+    unsigned char len;
+    unsigned char i;
+
+    while (left > 0)
+    {
+        len = Jr_Get(pos, 0);
+        if (!(Jr_Get(pos, 1) & JOURNAL_FLAG_DELETED))
+        {
+            live += len;
+        }
+        pos = JR_WRAP(pos + len);
+        left -= len;
+    }
+
+    pos = jr_head;
+    left = jr_used;
+    while (left > 0)
+    {
+        len = Jr_Get(pos, 0);
+        if (!(Jr_Get(pos, 1) & JOURNAL_FLAG_DELETED))
+        {
+            if (live <= max)
+            {
+                for (i = 0; i < len; i++)
+                {
+                    buf[out++] = Jr_Get(pos, i);
+                }
+            }
+            live -= len;
+        }
+        pos = JR_WRAP(pos + len);
+        left -= len;
+    }
+    return out;
+}
+
+bit Journal_Import(const unsigned char *rec, unsigned char len)
+{
+    unsigned char type;
+
+    if (len < JOURNAL_HDR_LEN || len != rec[0] || len > JOURNAL_HDR_LEN + JOURNAL_DATA_MAX)
+    {
+        return 0;
+    }
+    type = rec[1] & JOURNAL_TYPE_MASK;
+    if (type == 0)
+    {
+        return 0;
+    }
+    Jr_Write(rec[1], (unsigned int)rec[2] | ((unsigned int)rec[3] << 8), rec[4],
+             (const rtc_time_t *)(rec + 5), rec + JOURNAL_HDR_LEN, len - JOURNAL_HDR_LEN, NULL);
+    return 1;
+}
@@ -0,0 +1,66 @@
+#ifndef __JOURNAL_H__
+#define __JOURNAL_H__
+
+#ifndef JR_HOST
+#include "D1302.h"        // rtc_time_t（上位机工具自行定义）
+#endif
+
+// ------------------- 事件日志配置 -------------------
+// 各类事件共用一个字节环：记录按追加顺序紧密排列（可跨越缓冲区末尾），空间不足时丢弃最旧的记录，
+// 总容量由实际发生的事件共享。记录写入后位置不变，删除只置标志位，空间随最旧记录一起回收
+// 记录格式：
+//   [0]    记录总长度（含记录头）
+//   [1]    类型（低4位，使用者定义1~JOURNAL_TYPE_MAX-1）| JOURNAL_FLAG_DELETED
+//   [2-3]  序号（小端，逐条递增，回绕）
+//   [4]    AID（0=不属于某个从站）
+//   [5-10] 事件时间（rtc_time_t：年月日时分秒）
+//   [11..] 数据（类型自定义，不超过JOURNAL_DATA_MAX字节）
+#define JOURNAL_SIZE        512           // 日志缓冲区字节数（不超过65534，约25条事件；上电后只恢复EEPROM快照中的最新约190字节）
+#define JOURNAL_HDR_LEN     11            // 记录头长度
+#define JOURNAL_DATA_MAX    16            // 单条记录数据最大长度
+#define JOURNAL_TYPE_MAX    16            // 类型个数上限（类型占低4位）
+#define JOURNAL_TYPE_MASK   0x0F
+#define JOURNAL_FLAG_DELETED 0x80         // 已删除（迭代时跳过，不计入条数）
+#define JOURNAL_POS_NONE    0xFFFF        // 空引用
+
+// 记录引用：位置+序号。序号仍在日志内（未被丢弃）即说明位置有效
+typedef struct {
+    unsigned int pos;
+    unsigned int seq;
+} JournalRef;
+
+// 读出的一条记录
+typedef struct {
+    JournalRef ref;
+    unsigned char type;
+    unsigned char aid;
+    rtc_time_t time;
+    unsigned char len;                    // 数据长度
+    unsigned char dat[JOURNAL_DATA_MAX];
+} JournalEntry;
+
+// 迭代器（从旧到新）：type/aid为0表示不过滤；since.year为0表示不按时间过滤（只返回不早于since的记录）
+typedef struct {
+    unsigned char type;
+    unsigned char aid;
+    rtc_time_t since;
+    unsigned int pos;
+    unsigned int left;                    // 尚未遍历的字节数
+} JournalIter;
+
+// ------------------- 函数声明 -------------------
+void Journal_Init(void);                  // 清空日志，序号从0开始
+bit Journal_Append(unsigned char type, unsigned char aid, const rtc_time_t *time,
+                   const void *dat, unsigned char len, JournalRef *ref);  // 追加一条记录（ref可为NULL）
+bit Journal_Read(const JournalRef *ref, JournalEntry *e);   // 读取引用的记录（已丢弃/已删除返回0）
+void Journal_Update(const JournalRef *ref, const rtc_time_t *time, const void *dat);  // 原位改写时间和数据（长度不变）
+void Journal_Delete(const JournalRef *ref);                 // 删除引用的记录
+void Journal_DeleteAll(unsigned char type);                 // 删除某类型的全部记录
+unsigned int Journal_Count(unsigned char type);             // 某类型未删除的记录数
+void Journal_IterBegin(JournalIter *it, unsigned char type, unsigned char aid);  // 开始遍历（since清零）
+bit Journal_Next(JournalIter *it, JournalEntry *e);         // 取下一条符合条件的记录
+bit Journal_FindNewest(unsigned char type, unsigned char aid, unsigned int nth, JournalEntry *e);  // 第nth条最新记录（0=最新）
+unsigned int Journal_Export(unsigned char *buf, unsigned int max);  // 导出不超过max字节的最新未删除记录（从旧到新）
+bit Journal_Import(const unsigned char *rec, unsigned char len);   // 追加一条导出的记录（保留原序号）
+
+#endif
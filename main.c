@@ -28,7 +28,9 @@ void main() {
 
     
     // 输出RTC状态
-    UART4_SendString("RTC initialized. Time will be displayed on LCD.\r\n");
+    if (LOG_ON(LOG_MOD_SYS, LOG_LEVEL_INFO)) {
+        UART4_SendString("RTC initialized. Time will be displayed on LCD.\r\n");
+    }
     
     while(1) {
         key_scan();               // 扫描按键
@@ -0,0 +1,209 @@
+// 软件定时器（分层时间轮）
+// 定时器以ID标识，节点为数组下标（前驱/后继/所在槽各1字节），各槽为双向链表：
+// 启动时按到期时间与当前节拍之差挂入对应层的槽，取消时直接从所在槽摘下
+// 中断中只累计节拍，链表操作和回调全部在主循环中进行，无需关中断保护链表
+// 上位机测试：tools/timer_wheel_sim.c 直接编译本文件（定义TW_HOST），与全扫描参考模型逐节拍对比
+
+#ifndef TW_HOST
+#include "STC32G.H"       // STC32G单片机核心头文件（EA）
+#endif
+#include "timer_wheel.h"
+
+#define TW_HEADS            (TW_SLOTS * TW_LEVELS)   // 全部槽数（槽号=层×TW_SLOTS+层内槽）
+
+// ------------------- 全局变量 -------------------
+static unsigned char tw_head[TW_HEADS];           // 各槽链表头（定时器ID）
+static unsigned char tw_next[TW_TIMER_COUNT];     // 槽内后继
+static unsigned char tw_prev[TW_TIMER_COUNT];     // 槽内前驱
+static unsigned char tw_slot[TW_TIMER_COUNT];     // 所在槽号（TW_NONE=未运行）
+static unsigned long tw_expire[TW_TIMER_COUNT];   // 到期节拍
+static unsigned long tw_now;                      // 已处理到的节拍
+static volatile unsigned char tw_pending;         // 中断累计、主循环尚未处理的节拍数
+static unsigned char tw_ms_div;                   // 中断中的毫秒分频计数
+
+// ------------------- 静态函数声明 -------------------
+static void Tw_Link(unsigned char id);            // 按到期时间挂入对应槽
+static void Tw_Unlink(unsigned char id);          // 从所在槽摘下
+static void Tw_Cascade(unsigned char slot);       // 高层槽中的定时器按剩余时间重新挂入
+
+// ------------------- 链表操作 -------------------
+// 剩余不足64节拍挂第0层到期节拍对应的槽；不足64×64挂第1层；其余挂第2层
+// 高层槽在低层转满一圈时整体降层，到期时间落在同一周期内，降层后正好落入低层对应槽
+static void Tw_Link(unsigned char id)
+{
+    unsigned long expire = tw_expire[id];
+    unsigned long delta = expire - tw_now;
+    unsigned char slot;
+
+    // 降层时恰好到期的定时器挂入当前槽，随后在本节拍内回调
+    if ((long)delta < 0)
+    {
+        delta = 0;
+        expire = tw_now;
+    }
+
+    if (delta < TW_SLOTS)
+    {
+        slot = (unsigned char)(expire & TW_SLOT_MASK);
+    }
+    else if (delta < (1UL << (2 * TW_SLOT_BITS)))
+    {
+        slot = (unsigned char)(TW_SLOTS + ((expire >> TW_SLOT_BITS) & TW_SLOT_MASK));
+    }
+    else
+    {
+        // 超过总跨度：先挂在最远槽，降层时按实际到期时间重新挂入
+        if (delta >= TW_SPAN)
+        {
+            expire = tw_now + TW_SPAN - 1;
+        }
+        slot = (unsigned char)(2 * TW_SLOTS + ((expire >> (2 * TW_SLOT_BITS)) & TW_SLOT_MASK));
+    }
+
+    tw_slot[id] = slot;
+    tw_prev[id] = TW_NONE;
+    tw_next[id] = tw_head[slot];
+    if (tw_head[slot] != TW_NONE)
+    {
+        tw_prev[tw_head[slot]] = id;
+    }
+    tw_head[slot] = id;
+}
+
+static void Tw_Unlink(unsigned char id)
+{
+    unsigned char prev = tw_prev[id];
+    unsigned char next = tw_next[id];
+
+    if (prev != TW_NONE)
+    {
+        tw_next[prev] = next;
+    }
+    else
+    {
+        tw_head[tw_slot[id]] = next;
+    }
+    if (next != TW_NONE)
+    {
+        tw_prev[next] = prev;
+    }
+    tw_slot[id] = TW_NONE;
+}
+
+static void Tw_Cascade(unsigned char slot)
+{
+    unsigned char id;
+
+    while ((id = tw_head[slot]) != TW_NONE)
+    {
+        Tw_Unlink(id);
+        Tw_Link(id);
+    }
+}
+
+// ------------------- 对外接口 -------------------
+void TimerWheel_Init(void)
+{
+    unsigned char i;
+
+    for (i = 0; i < TW_HEADS; i++)
+    {
+        tw_head[i] = TW_NONE;
+    }
+    for (i = 0; i < TW_TIMER_COUNT; i++)
+    {
+        tw_slot[i] = TW_NONE;
+    }
+    tw_now = 0;
+    EA = 0;
+    tw_pending = 0;
+    tw_ms_div = 0;
+    EA = 1;
+}
+
+void TimerWheel_Start(unsigned char id, unsigned long ticks)
+{
+    if (id >= TW_TIMER_COUNT)
+    {
+        return;
+    }
+    if (tw_slot[id] != TW_NONE)
+    {
+        Tw_Unlink(id);
+    }
+    // 至少1个节拍：回调中重新启动的定时器不会挂回正在处理的槽
+    tw_expire[id] = tw_now + (ticks ? ticks : 1);
+    Tw_Link(id);
+}
+
+void TimerWheel_Cancel(unsigned char id)
+{
+    if (id < TW_TIMER_COUNT && tw_slot[id] != TW_NONE)
+    {
+        Tw_Unlink(id);
+    }
+}
+
+bit TimerWheel_IsRunning(unsigned char id)
+{
+    return (id < TW_TIMER_COUNT && tw_slot[id] != TW_NONE) ? 1 : 0;
+}
+
+unsigned long TimerWheel_Now(void)
+{
+    return tw_now;
+}
+
+// 中断中只做分频和节拍累计（主循环停顿超过255个节拍时多余节拍丢弃，定时器相应推迟）
+void TimerWheel_IsrTick(void)
+{
+    if (++tw_ms_div >= TW_TICK_MS)
+    {
+        tw_ms_div = 0;
+        if (tw_pending < 0xFF)
+        {
+            tw_pending++;
+        }
+    }
+}
+
+// 逐节拍推进：第0层转满一圈时先降层第2层（如需）再降层第1层当前槽，然后回调第0层当前槽
+// 回调前先把定时器从槽中摘下，回调中启动/取消任意定时器都不影响后续遍历
+void TimerWheel_Run(void)
+{
+    unsigned char ticks;
+    unsigned char slot;
+    unsigned char id;
+
+    EA = 0;
+    ticks = tw_pending;
+    tw_pending = 0;
+    EA = 1;
+
+    while (ticks--)
+    {
+        tw_now++;
+        slot = (unsigned char)(tw_now & TW_SLOT_MASK);
+        if (slot == 0)
+        {
+            if (((tw_now >> TW_SLOT_BITS) & TW_SLOT_MASK) == 0)
+            {
+                Tw_Cascade((unsigned char)(2 * TW_SLOTS + ((tw_now >> (2 * TW_SLOT_BITS)) & TW_SLOT_MASK)));
+            }
+            Tw_Cascade((unsigned char)(TW_SLOTS + ((tw_now >> TW_SLOT_BITS) & TW_SLOT_MASK)));
+        }
+
+        while ((id = tw_head[slot]) != TW_NONE)
+        {
+            Tw_Unlink(id);
+            if ((long)(tw_expire[id] - tw_now) > 0)
+            {
+                Tw_Link(id);    // 超过总跨度的定时器尚未到期
+            }
+            else
+            {
+                TimerWheel_OnExpire(id);
+            }
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+// ------------------- 软件定时器（分层时间轮）配置 -------------------
+// 定时器0中断每TW_TICK_MS毫秒累计1个节拍，主循环中TimerWheel_Run()推进时间轮并回调到期定时器，
+// 启动/取消均为O(1)，每节拍只处理当前槽，开销与定时器个数无关
+// 3层×64槽：第0层1节拍/槽（3.2秒），第1层64节拍/槽（204.8秒），第2层4096节拍/槽（约3.6小时）；
+// 低层转满一圈时把高层当前槽中的定时器按剩余时间降层，超过总跨度的定时器先挂在第2层最远槽
+#define TW_TIMER_COUNT      80            // 定时器个数（ID 0~TW_TIMER_COUNT-1，分配见uart4.h"软件定时器分配"，不超过254）
+#define TW_TICK_MS          50            // 节拍长度（ms），定时精度为1个节拍
+#define TW_SLOT_BITS        6             // 每层槽数的位数
+#define TW_SLOTS            (1 << TW_SLOT_BITS)          // 每层槽数
+#define TW_SLOT_MASK        (TW_SLOTS - 1)
+#define TW_LEVELS           3             // 层数
+#define TW_SPAN             (1UL << (TW_SLOT_BITS * TW_LEVELS))  // 总跨度（节拍）
+#define TW_NONE             0xFF          // 链表结束/定时器未运行
+
+#define TW_MS(ms)           (((unsigned long)(ms) + TW_TICK_MS - 1) / TW_TICK_MS)  // 毫秒→节拍（向上取整）
+#define TW_SEC(s)           ((unsigned long)(s) * (1000 / TW_TICK_MS))             // 秒→节拍
+
+// ------------------- 函数声明 -------------------
+void TimerWheel_Init(void);               // 停止全部定时器，节拍计数清零
+void TimerWheel_Start(unsigned char id, unsigned long ticks);  // 启动（已运行则重新计时），ticks个节拍后到期（最少1）
+void TimerWheel_Cancel(unsigned char id); // 停止定时器（未运行时无操作）
+bit TimerWheel_IsRunning(unsigned char id);  // 定时器是否运行中
+unsigned long TimerWheel_Now(void);       // 主循环已处理到的节拍数
+void TimerWheel_IsrTick(void);            // 定时器0中断中每1ms调用一次
+void TimerWheel_Run(void);                // 主循环调用：推进时间轮并回调到期定时器
+
+// 到期回调（由使用者实现）：定时器为单次，回调中可重新启动本定时器或启动/取消其他定时器
+void TimerWheel_OnExpire(unsigned char id);
+
+#endif
@@ -0,0 +1,676 @@
+// 报警判断等价性回放测试（上位机工具，标准C）
+// 直接编译固件的journal.c，同一组随机帧序列分别送入两种报警判断方式，两种方式各有一份事件日志，
+// 每步核对两份日志（逐字节）和异常状态完全一致：
+//   全表方式：每帧检查全部从站，按AID在事件日志中查找该从站最新一条报警事件（Journal_FindNewest）
+//   单站方式：每帧只判断本帧从站，报警事件由alarm_open引用直接读取，删除/清空报警事件后的第一帧检查全部从站
+// 温度级别按各从站阈值、回差和驻留时间判断（两种方式共用），从正常进入预警/报警时写预警事件；
+// 序列中穿插温度越限/恢复、校验失败帧、AID越界帧、从站离线/恢复（不写事件日志）、修改阈值、
+// 删除和清空报警事件。日志容量与固件相同，覆盖报警事件被最旧记录丢弃后失效的情况
+// 同时编译固件的daymax.c，按有效帧维护每日最高温记录，每步核对保留的日期与当天最高温；
+// 序列结束后再跨3天、每天用事件灌满日志，核对PAGE_21的3天记录仍然完整（每日最高温不在事件日志中）
+// 以下函数的判断逻辑与1.20uart4.c中的同名函数一致：Threshold_Update、Alarm_Evaluate、CheckAndRecordAlarm、
+// RecordAlarmEvent、RecordRecoveryEvent、RecordWarningEvent、Alarm_RebuildIndex、DeleteAlarmEvent、
+// ClearAllAlarmEvents、Live_OnTimeout/Live_Touch中的状态部分
+// （显示、遥测、持久化、历史记录等与判断结果无关的部分省略，RTC时间由模拟节拍换算）
+//
+// 编译：gcc -O2 -I.. -o alarm_replay alarm_replay.c
+// 用法：alarm_replay [步数] [随机种子]    默认1000000步、种子1
+// 返回：两种方式结果不一致时返回1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JR_HOST
+#define bit                 unsigned char
+
+// 与D1302.h保持一致
+typedef struct {
+    unsigned char year;
+    unsigned char mon;
+    unsigned char day;
+    unsigned char hour;
+    unsigned char min;
+    unsigned char sec;
+} rtc_time_t;
+
+// C251的int为16位：按16位编译事件日志，记录序号回绕与固件一致
+#define int                 short
+#include "../journal.c"
+#define DM_HOST
+#include "../daymax.c"
+#undef int
+
+typedef unsigned short u16;               // 与固件unsigned int等宽
+
+// 与uart4.h保持一致
+#define TOTAL_SLAVES            35
+#define EVENT_TYPE_ALARM        1
+#define EVENT_TYPE_RECOVERY     2
+#define EVENT_TYPE_WARNING      3
+#define TEMP_LEVEL_NORMAL       0
+#define TEMP_LEVEL_WARN         1
+#define TEMP_LEVEL_ALARM        2
+#define TW_SEC(s)               ((u16)((s) * 20))  // 50ms节拍
+
+// 记录数据按C251布局（无填充），记录长度与固件相同
+#pragma pack(push, 1)
+typedef struct {
+    unsigned char pid;
+    unsigned char temp;
+    u16 volt_mv;
+} EvAlarmData;
+
+typedef struct {
+    unsigned char pid;
+    unsigned char abnormal_temp;
+    unsigned char recovery_temp;
+    u16 recovery_volt_mv;
+    rtc_time_t abnormal_time;
+} EvRecoveryData;
+#pragma pack(pop)
+
+typedef struct {
+    unsigned char warn_c;
+    unsigned char alarm_c;
+    unsigned char hyst_deci;
+    unsigned char dwell_set_s;
+    unsigned char dwell_clr_s;
+} SlaveThreshold;
+
+// journal.c的全部状态（两种方式各一份，轮流换入）
+typedef struct {
+    unsigned char buf[JOURNAL_SIZE];
+    u16 head;
+    u16 used;
+    u16 first_seq;
+    u16 next_seq;
+    u16 count[JOURNAL_TYPE_MAX];
+} JournalState;
+
+// 一种判断方式的全部状态
+typedef struct {
+    JournalState jr;
+    unsigned char last_abnormal_status[TOTAL_SLAVES];
+    JournalRef alarm_open[TOTAL_SLAVES];          // 仅单站方式读取
+    unsigned char alarm_rescan;                   // 仅单站方式使用
+    unsigned long work;                           // 检查的从站数+在日志中查找报警事件的次数
+} Model;
+
+// 两种方式共用的实时数据和阈值状态（由帧序列写入）
+static unsigned char rt_valid[TOTAL_SLAVES];
+static unsigned char rt_abnormal[TOTAL_SLAVES];
+static unsigned char rt_offline[TOTAL_SLAVES];
+static short rt_temp_deci[TOTAL_SLAVES];
+static u16 rt_volt_mv[TOTAL_SLAVES];
+static unsigned char rt_pid[TOTAL_SLAVES];
+static unsigned char rt_level[TOTAL_SLAVES];
+static unsigned char thr_pending[TOTAL_SLAVES];
+static u16 thr_since[TOTAL_SLAVES];
+static SlaveThreshold slave_thr[TOTAL_SLAVES];
+static unsigned long now_tick;
+static rtc_time_t current_rtc_time;
+
+static Model full;
+static Model event;
+static Model *cur;                                // 当前换入journal.c的方式
+
+static unsigned long n_alarms;
+static unsigned long n_updates;
+static unsigned long n_recoveries;
+static unsigned long n_warnings;
+static unsigned long n_offline;
+static unsigned long n_lost;                      // 持续报警期间报警事件已被丢弃/删除
+static unsigned long n_days;                      // 出现过有效样本的日期数
+
+// 每日最高温的预期值：最近DAY_MAX_DAYS个日期（从新到旧）和当天最高温
+static rtc_time_t dm_date[DAY_MAX_DAYS];
+static short dm_top;
+
+static unsigned char TempShortToChar(short temp)
+{
+    if (temp == -990)
+    {
+        return 0;
+    }
+    return (unsigned char)(abs(temp) / 10);
+}
+
+// 模拟节拍换算为RTC时间（每28天一个月，只需单调且两种方式相同）
+static void GetCurrentRTC(void)
+{
+    unsigned long s = now_tick / 20;
+
+    current_rtc_time.sec = (unsigned char)(s % 60);
+    current_rtc_time.min = (unsigned char)(s / 60 % 60);
+    current_rtc_time.hour = (unsigned char)(s / 3600 % 24);
+    current_rtc_time.day = (unsigned char)(1 + s / 86400 % 28);
+    current_rtc_time.mon = (unsigned char)(1 + s / (86400UL * 28) % 12);
+    current_rtc_time.year = (unsigned char)(25 + s / (86400UL * 28 * 12));
+}
+
+// ------------------- 方式切换 -------------------
+static void Model_Enter(Model *m)
+{
+    memcpy(jr_buf, m->jr.buf, JOURNAL_SIZE);
+    jr_head = m->jr.head;
+    jr_used = m->jr.used;
+    jr_first_seq = m->jr.first_seq;
+    jr_next_seq = m->jr.next_seq;
+    memcpy(jr_count, m->jr.count, sizeof(jr_count));
+    cur = m;
+}
+
+static void Model_Leave(void)
+{
+    memcpy(cur->jr.buf, jr_buf, JOURNAL_SIZE);
+    cur->jr.head = jr_head;
+    cur->jr.used = jr_used;
+    cur->jr.first_seq = jr_first_seq;
+    cur->jr.next_seq = jr_next_seq;
+    memcpy(cur->jr.count, jr_count, sizeof(jr_count));
+    cur = NULL;
+}
+
+static void Model_Init(Model *m)
+{
+    unsigned char i;
+
+    Model_Enter(m);
+    Journal_Init();
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        m->alarm_open[i].pos = JOURNAL_POS_NONE;
+    }
+    Model_Leave();
+}
+
+// ------------------- 两种方式共用的事件记录 -------------------
+static void RecordAlarmEvent(unsigned char pid, unsigned char aid, unsigned char temp, u16 volt_mv)
+{
+    EvAlarmData alarm;
+    JournalRef ref;
+
+    GetCurrentRTC();
+    alarm.pid = pid;
+    alarm.temp = temp;
+    alarm.volt_mv = volt_mv;
+    Journal_Append(EVENT_TYPE_ALARM, aid, &current_rtc_time, &alarm, sizeof(EvAlarmData), &ref);
+    if (aid >= 1 && aid <= TOTAL_SLAVES)
+    {
+        cur->alarm_open[aid - 1] = ref;
+    }
+}
+
+static void RecordRecoveryEvent(unsigned char pid, unsigned char aid, unsigned char abnormal_temp,
+                                unsigned char recovery_temp, u16 recovery_volt_mv, rtc_time_t abnormal_time)
+{
+    EvRecoveryData recovery;
+
+    GetCurrentRTC();
+    recovery.pid = pid;
+    recovery.abnormal_temp = abnormal_temp;
+    recovery.recovery_temp = recovery_temp;
+    recovery.recovery_volt_mv = recovery_volt_mv;
+    recovery.abnormal_time = abnormal_time;
+    Journal_Append(EVENT_TYPE_RECOVERY, aid, &current_rtc_time, &recovery, sizeof(EvRecoveryData), NULL);
+}
+
+// 预警事件由帧处理产生，与判断方式无关，两份日志各追加一条
+static void Both_Append(unsigned char type, unsigned char aid, const void *dat, unsigned char len)
+{
+    GetCurrentRTC();
+    Model_Enter(&full);
+    Journal_Append(type, aid, &current_rtc_time, dat, len, NULL);
+    Model_Leave();
+    Model_Enter(&event);
+    Journal_Append(type, aid, &current_rtc_time, dat, len, NULL);
+    Model_Leave();
+}
+
+static void RecordWarningEvent(unsigned char slave_idx, short temp_deci)
+{
+    EvAlarmData warning;
+
+    warning.pid = rt_pid[slave_idx];
+    warning.temp = TempShortToChar(temp_deci);
+    warning.volt_mv = rt_volt_mv[slave_idx];
+    Both_Append(EVENT_TYPE_WARNING, slave_idx + 1, &warning, sizeof(EvAlarmData));
+    n_warnings++;
+}
+
+// ------------------- 每日最高温 -------------------
+// DayStat_Sample/DayMax_Write中与记录有关的部分：新的日期插入一条，当天出现更高温度时原位改写
+static void DayMax_Sample(unsigned char slave_idx)
+{
+    DayMaxRec rec;
+    unsigned char i;
+
+    GetCurrentRTC();
+    if (n_days == 0 || dm_date[0].year != current_rtc_time.year ||
+        dm_date[0].mon != current_rtc_time.mon || dm_date[0].day != current_rtc_time.day)
+    {
+        for (i = DAY_MAX_DAYS - 1; i > 0; i--)
+        {
+            dm_date[i] = dm_date[i - 1];
+        }
+        dm_date[0] = current_rtc_time;
+        dm_top = -990;
+        n_days++;
+    }
+    if (rt_temp_deci[slave_idx] <= dm_top)
+    {
+        return;
+    }
+    dm_top = rt_temp_deci[slave_idx];
+    memset(&rec, 0, sizeof(rec));
+    rec.time = current_rtc_time;
+    rec.pid = rt_pid[slave_idx];
+    rec.aid = slave_idx + 1;
+    rec.max_temp = dm_top;
+    rec.volt_mv = rt_volt_mv[slave_idx];
+    DayMaxLog_Put(&rec);
+}
+
+// 保留的日期数、各条日期和当天最高温与预期一致；导出后再导入内容不变（EEPROM快照）
+static int DayMax_Check(void)
+{
+    unsigned char buf[DAY_MAX_DAYS * sizeof(DayMaxRec)];
+    unsigned char again[DAY_MAX_DAYS * sizeof(DayMaxRec)];
+    unsigned char n;
+    unsigned char i;
+    DayMaxRec rec;
+
+    if (DayMaxLog_Count() != (n_days < DAY_MAX_DAYS ? n_days : DAY_MAX_DAYS))
+    {
+        return 0;
+    }
+    for (i = 0; i < DayMaxLog_Count(); i++)
+    {
+        DayMaxLog_Get(i, &rec);
+        if (rec.time.year != dm_date[i].year || rec.time.mon != dm_date[i].mon || rec.time.day != dm_date[i].day ||
+            (i == 0 && rec.max_temp != dm_top))
+        {
+            return 0;
+        }
+    }
+    n = DayMaxLog_Export(buf);
+    DayMaxLog_Import(buf, n);
+    return DayMaxLog_Export(again) == n && memcmp(buf, again, n) == 0;
+}
+
+// ------------------- 温度级别（两种方式共用） -------------------
+static void Threshold_Update(unsigned char slave_idx, short temp_deci)
+{
+    SlaveThreshold *thr = &slave_thr[slave_idx];
+    unsigned char level = rt_level[slave_idx];
+    unsigned char target;
+    unsigned char dwell_s;
+    u16 now = (u16)now_tick;
+    short alarm_deci = (short)thr->alarm_c * 10;
+    short warn_deci = (short)thr->warn_c * 10;
+
+    if (temp_deci > alarm_deci ||
+        (level == TEMP_LEVEL_ALARM && temp_deci > alarm_deci - thr->hyst_deci))
+    {
+        target = TEMP_LEVEL_ALARM;
+    }
+    else if (temp_deci > warn_deci ||
+             (level != TEMP_LEVEL_NORMAL && temp_deci > warn_deci - thr->hyst_deci))
+    {
+        target = TEMP_LEVEL_WARN;
+    }
+    else
+    {
+        target = TEMP_LEVEL_NORMAL;
+    }
+
+    if (target == level)
+    {
+        thr_pending[slave_idx] = level;
+        return;
+    }
+    if (target != thr_pending[slave_idx])
+    {
+        thr_pending[slave_idx] = target;
+        thr_since[slave_idx] = now;
+    }
+    dwell_s = (target > level) ? thr->dwell_set_s : thr->dwell_clr_s;
+    if ((u16)(now - thr_since[slave_idx]) < TW_SEC(dwell_s))
+    {
+        return;
+    }
+
+    rt_level[slave_idx] = target;
+    rt_abnormal[slave_idx] = (target == TEMP_LEVEL_ALARM);
+    if (level == TEMP_LEVEL_NORMAL)
+    {
+        RecordWarningEvent(slave_idx, temp_deci);
+    }
+}
+
+// ------------------- 单个从站的判断（两种方式只在报警事件的定位上不同） -------------------
+static void Alarm_Judge(unsigned char i, unsigned char has_event, JournalEntry *e)
+{
+    EvAlarmData alarm;
+    unsigned char cur_temp = TempShortToChar(rt_temp_deci[i]);
+
+    if (has_event)
+    {
+        memcpy(&alarm, e->dat, sizeof(EvAlarmData));
+    }
+    if (rt_abnormal[i])
+    {
+        if (cur->last_abnormal_status[i] == 0)
+        {
+            RecordAlarmEvent(rt_pid[i], (unsigned char)(i + 1), cur_temp, rt_volt_mv[i]);
+            cur->last_abnormal_status[i] = 1;
+            if (cur == &event)
+            {
+                n_alarms++;
+            }
+        }
+        else if (has_event && cur_temp > alarm.temp)
+        {
+            alarm.temp = cur_temp;
+            alarm.volt_mv = rt_volt_mv[i];
+            GetCurrentRTC();
+            Journal_Update(&e->ref, &current_rtc_time, &alarm);
+            if (cur == &event)
+            {
+                n_updates++;
+            }
+        }
+        else if (!has_event && cur == &event)
+        {
+            n_lost++;
+        }
+    }
+    else if (cur->last_abnormal_status[i] == 1)
+    {
+        if (has_event)
+        {
+            RecordRecoveryEvent(rt_pid[i], (unsigned char)(i + 1), alarm.temp, cur_temp, rt_volt_mv[i], e->time);
+            if (cur == &event)
+            {
+                n_recoveries++;
+            }
+        }
+        cur->last_abnormal_status[i] = 0;
+    }
+}
+
+// ------------------- 全表方式（参考） -------------------
+static void Check_FullScan(void)
+{
+    unsigned char i;
+    JournalEntry e;
+    unsigned char has_event;
+
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        cur->work++;
+        if (!rt_valid[i])
+        {
+            continue;
+        }
+        cur->work++;
+        has_event = Journal_FindNewest(EVENT_TYPE_ALARM, (unsigned char)(i + 1), 0, &e);
+        Alarm_Judge(i, has_event, &e);
+    }
+}
+
+// ------------------- 单站方式（固件实现） -------------------
+static void Alarm_Evaluate(unsigned char i)
+{
+    JournalEntry e;
+    unsigned char has_event;
+
+    cur->work++;
+    if (!rt_valid[i])
+    {
+        return;
+    }
+    has_event = Journal_Read(&cur->alarm_open[i], &e);
+    Alarm_Judge(i, has_event, &e);
+}
+
+static void CheckAndRecordAlarm(unsigned char aid)
+{
+    unsigned char i;
+
+    if (cur->alarm_rescan)
+    {
+        cur->alarm_rescan = 0;
+        for (i = 0; i < TOTAL_SLAVES; i++)
+        {
+            Alarm_Evaluate(i);
+        }
+    }
+    else if (aid >= 1 && aid <= TOTAL_SLAVES)
+    {
+        Alarm_Evaluate(aid - 1);
+    }
+}
+
+static void Alarm_RebuildIndex(void)
+{
+    unsigned char i;
+    JournalIter it;
+    JournalEntry e;
+
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        cur->alarm_open[i].pos = JOURNAL_POS_NONE;
+    }
+    Journal_IterBegin(&it, EVENT_TYPE_ALARM, 0);
+    while (Journal_Next(&it, &e))
+    {
+        if (e.aid >= 1 && e.aid <= TOTAL_SLAVES)
+        {
+            cur->alarm_open[e.aid - 1] = e.ref;
+        }
+    }
+}
+
+// ------------------- 删除/清空报警事件（两种方式相同，引用维护只对单站方式有意义） -------------------
+static void DeleteAlarmEvent(unsigned char display_index)
+{
+    JournalEntry e;
+
+    if (!Journal_FindNewest(EVENT_TYPE_ALARM, 0, display_index, &e))
+    {
+        return;
+    }
+    Journal_Delete(&e.ref);
+    if (e.aid >= 1 && e.aid <= TOTAL_SLAVES &&
+        cur->alarm_open[e.aid - 1].pos == e.ref.pos && cur->alarm_open[e.aid - 1].seq == e.ref.seq)
+    {
+        Alarm_RebuildIndex();
+    }
+    cur->alarm_rescan = 1;
+}
+
+static void ClearAllAlarmEvents(void)
+{
+    unsigned char i;
+
+    Journal_DeleteAll(EVENT_TYPE_ALARM);
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        cur->last_abnormal_status[i] = 0;
+        cur->alarm_open[i].pos = JOURNAL_POS_NONE;
+    }
+    cur->alarm_rescan = 1;
+}
+
+// ------------------- 帧序列 -------------------
+static void Random_Threshold(unsigned char i)
+{
+    slave_thr[i].warn_c = (unsigned char)(20 + rand() % 5);
+    slave_thr[i].alarm_c = (unsigned char)(slave_thr[i].warn_c + 1 + rand() % 4);
+    slave_thr[i].hyst_deci = (unsigned char)(rand() % 31);
+    slave_thr[i].dwell_set_s = (unsigned char)(rand() % 8);
+    slave_thr[i].dwell_clr_s = (unsigned char)(rand() % 40);
+}
+
+// 从站离线（Live_OnTimeout）：清除有效位和异常位，级别回到正常，不触发报警检查
+static void Live_OnTimeout(unsigned char i)
+{
+    rt_offline[i] = 1;
+    rt_valid[i] = 0;
+    rt_abnormal[i] = 0;
+    rt_level[i] = TEMP_LEVEL_NORMAL;
+    thr_pending[i] = TEMP_LEVEL_NORMAL;
+    n_offline++;
+}
+
+// 收到数据帧（AddDataToSummary中与报警判断有关的部分）
+static void Frame(unsigned char i)
+{
+    if (rt_offline[i])
+    {
+        rt_offline[i] = 0;
+    }
+    rt_pid[i] = (unsigned char)(1 + rand() % 3);
+    rt_temp_deci[i] += (short)(rand() % 41 - 20);
+    if (rt_temp_deci[i] < 150 || rt_temp_deci[i] > 400)
+    {
+        rt_temp_deci[i] = (short)(180 + rand() % 150);
+    }
+    rt_volt_mv[i] = (u16)(3000 + rand() % 1200);
+    rt_valid[i] = (rand() % 20) != 0;
+    if (rt_valid[i])
+    {
+        Threshold_Update(i, rt_temp_deci[i]);
+        DayMax_Sample(i);
+    }
+}
+
+static int Same_State(void)
+{
+    return memcmp(&full.jr, &event.jr, sizeof(JournalState)) == 0 &&
+           memcmp(full.last_abnormal_status, event.last_abnormal_status, TOTAL_SLAVES) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long steps = 1000000;
+    unsigned long step;
+    unsigned long frames = 0;
+    unsigned char aid;
+    unsigned char i;
+    unsigned char del;
+    unsigned char day;
+    unsigned int k;
+    int op;
+
+    if (argc > 1)
+    {
+        steps = strtoul(argv[1], NULL, 10);
+    }
+    srand(argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : 1U);
+
+    Model_Init(&full);
+    Model_Init(&event);
+    DayMaxLog_Init();
+    for (i = 0; i < TOTAL_SLAVES; i++)
+    {
+        rt_temp_deci[i] = 200;
+        Random_Threshold(i);
+    }
+
+    for (step = 1; step <= steps; step++)
+    {
+        now_tick += 1 + rand() % 40;
+        op = rand() % 1000;
+        if (op < 930)
+        {
+            aid = (unsigned char)(1 + rand() % TOTAL_SLAVES);
+            Frame(aid - 1);
+            frames++;
+        }
+        else if (op < 950)
+        {
+            aid = 0;                        // AID越界帧：仍触发报警检查
+            frames++;
+        }
+        else if (op < 970)
+        {
+            i = (unsigned char)(rand() % TOTAL_SLAVES);
+            if (!rt_offline[i])
+            {
+                Live_OnTimeout(i);
+            }
+            continue;
+        }
+        else if (op < 980)
+        {
+            Random_Threshold((unsigned char)(rand() % TOTAL_SLAVES));  // UART_CMD_THR_SET，下一帧生效
+            continue;
+        }
+        else if (op < 996)
+        {
+            del = (unsigned char)(rand() % 8);
+            Model_Enter(&full);
+            DeleteAlarmEvent(del);
+            Model_Leave();
+            Model_Enter(&event);
+            DeleteAlarmEvent(del);
+            Model_Leave();
+            continue;
+        }
+        else
+        {
+            Model_Enter(&full);
+            ClearAllAlarmEvents();
+            Model_Leave();
+            Model_Enter(&event);
+            ClearAllAlarmEvents();
+            Model_Leave();
+            continue;
+        }
+
+        Model_Enter(&full);
+        Check_FullScan();
+        Model_Leave();
+        Model_Enter(&event);
+        CheckAndRecordAlarm(aid);
+        Model_Leave();
+        if (!Same_State())
+        {
+            fprintf(stderr, "FAILED at step %lu (AID %u)\n", step, aid);
+            return 1;
+        }
+        if (!DayMax_Check())
+        {
+            fprintf(stderr, "FAILED at step %lu: daily max records\n", step);
+            return 1;
+        }
+    }
+
+    // 灌满事件日志：再跨3天，每天一个有效样本后追加远超日志容量的预警事件，PAGE_21仍有3天
+    for (day = 0; day < DAY_MAX_DAYS; day++)
+    {
+        now_tick += 20UL * 86400;
+        rt_valid[0] = 1;
+        DayMax_Sample(0);
+        for (k = 0; k < JOURNAL_SIZE / JOURNAL_HDR_LEN * 2; k++)
+        {
+            RecordWarningEvent((unsigned char)(k % TOTAL_SLAVES), 300);
+        }
+    }
+    if (DayMaxLog_Count() != DAY_MAX_DAYS || !DayMax_Check())
+    {
+        fprintf(stderr, "FAILED: daily max records lost after the journal flood\n");
+        return 1;
+    }
+
+    fprintf(stderr, "steps %lu, frames %lu: alarms %lu, max-temp updates %lu, recoveries %lu, "
+            "warnings %lu, offline %lu, evaluations with the alarm gone %lu, days %lu\n",
+            steps, frames, n_alarms, n_updates, n_recoveries, n_warnings, n_offline, n_lost, n_days);
+    fprintf(stderr, "work per frame: full scan %.1f, per-slave %.2f\n",
+            (double)full.work / frames, (double)event.work / frames);
+    fprintf(stderr, "PASS\n");
+    return 0;
+}
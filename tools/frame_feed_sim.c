@@ -0,0 +1,251 @@
+// 串口接收组帧重新同步测试（上位机工具，标准C）
+// 直接编译固件的uart_frame.c，生成随机的6字节协议帧字节流，按比例在帧中注入三类错误：
+//   丢字节：删去帧中任意一个字节
+//   多字节：在帧前、帧中或帧后插入1~3个随机字节
+//   错位字节：帧中任意一个字节翻转一位
+// 每个字节逐个送入UART4_FrameFeed（与UART4_ISR相同），得到帧时核对uart_rx_buff就是最近送入的6个字节，
+// 并按字节来源判断是某个原始帧还是误同步得到的帧（FCS为求和校验，错误字节拼出的窗口可能恰好通过校验）
+// 分两种总线时序各跑一遍：
+//   帧间静默：每帧后总线静默，按Timer0_ISR的静默超时将uart_rx_len清零。
+//     每个未注入错误的帧都必须收到；丢字节和错位字节的帧不能产生任何帧
+//   帧间无静默：各帧首尾相接（整屏重绘期间的突发）。未注入错误的帧只有在误同步帧结束于其前5个字节时
+//     才允许丢失（窗口此时无法与帧头对齐），其余都必须收到；同时统计出错后连续丢失的最多帧数
+//
+// 编译：gcc -O2 -I.. -o frame_feed_sim frame_feed_sim.c
+// 用法：frame_feed_sim [帧数] [随机种子]    默认1000000帧、种子1
+// 返回：有未收到的正确帧或帧内容不一致时返回1
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define UF_HOST
+#define bit                 unsigned char
+#include "../uart_frame.c"
+
+#define TOTAL_SLAVES        35            // 与uart4.h保持一致
+#define SIM_ERROR_PCT       20            // 注入错误的帧所占百分比
+
+enum { ERR_NONE, ERR_DROP, ERR_EXTRA, ERR_FLIP, ERR_KINDS };
+
+static const char *err_name[ERR_KINDS] = { "none", "dropped", "extra", "flipped" };
+
+// 已送入字节的来源：frame为帧序号（-1=插入或翻转的字节），pos为帧内位置
+typedef struct {
+    long frame;
+    unsigned char pos;
+    unsigned char val;
+} SimByte;
+
+typedef struct {
+    unsigned long frames[ERR_KINDS];      // 各类帧数
+    unsigned long received;               // 收到的未注入错误的帧
+    unsigned long salvaged;               // 多字节帧中原始6字节仍被完整收到
+    unsigned long spurious[ERR_KINDS];    // 误同步帧（按最近一次注入的错误分类）
+    unsigned long lost;                   // 丢失的未注入错误的帧
+    unsigned long max_lost_run;           // 出错后连续丢失的最多帧数
+} SimStats;
+
+static SimByte window[UART_BUFF_SIZE];    // 最近送入的6个字节
+static int failed;
+
+// 送入一个字节，返回1=收到原始帧frame，-1=误同步帧，0=未得到帧
+static int Sim_Feed(unsigned char val, long frame, unsigned char pos)
+{
+    unsigned char i;
+
+    for (i = 1; i < UART_BUFF_SIZE; i++)
+    {
+        window[i - 1] = window[i];
+    }
+    window[UART_BUFF_SIZE - 1].frame = frame;
+    window[UART_BUFF_SIZE - 1].pos = pos;
+    window[UART_BUFF_SIZE - 1].val = val;
+
+    if (!UART4_FrameFeed(val))
+    {
+        return 0;
+    }
+    for (i = 0; i < UART_BUFF_SIZE; i++)
+    {
+        if (uart_rx_buff[i] != window[i].val)
+        {
+            fprintf(stderr, "frame buffer differs from the last %u bytes received\n", UART_BUFF_SIZE);
+            failed = 1;
+            return -1;
+        }
+    }
+    for (i = 0; i < UART_BUFF_SIZE; i++)
+    {
+        if (window[i].frame < 0 || window[i].frame != window[0].frame || window[i].pos != i)
+        {
+            return -1;
+        }
+    }
+    return 1;
+}
+
+static void Sim_Run(int gaps, unsigned long count, unsigned int seed, SimStats *st)
+{
+    unsigned char frame[UART_BUFF_SIZE];
+    unsigned long k;
+    unsigned long lost_run = 0;
+    unsigned char i;
+    unsigned char at;
+    unsigned char n;
+    int err;
+    int last_err = ERR_NONE;
+    int spurious_in_frame;
+    int got;
+    int r;
+
+    srand(seed);
+    uart_rx_len = 0;
+    for (i = 0; i < UART_BUFF_SIZE; i++)
+    {
+        window[i].frame = -1;
+    }
+
+    for (k = 0; k < count && !failed; k++)
+    {
+        frame[0] = (unsigned char)(1 + rand() % 3);
+        frame[1] = (unsigned char)(1 + rand() % TOTAL_SLAVES);
+        frame[UART_BUFF_SIZE - 1] = frame[0] + frame[1];
+        for (i = 2; i < UART_BUFF_SIZE - 1; i++)
+        {
+            frame[i] = (unsigned char)rand();
+            frame[UART_BUFF_SIZE - 1] += frame[i];
+        }
+
+        err = (rand() % 100 < SIM_ERROR_PCT) ? 1 + rand() % (ERR_KINDS - 1) : ERR_NONE;
+        st->frames[err]++;
+        if (err != ERR_NONE)
+        {
+            last_err = err;
+        }
+        at = (unsigned char)(rand() % (UART_BUFF_SIZE + (err == ERR_EXTRA)));
+        spurious_in_frame = 0;
+        got = 0;
+
+        for (i = 0; i <= UART_BUFF_SIZE; i++)
+        {
+            if (err == ERR_EXTRA && i == at)
+            {
+                for (n = (unsigned char)(1 + rand() % 3); n > 0; n--)
+                {
+                    if (Sim_Feed((unsigned char)rand(), -1, 0) < 0)
+                    {
+                        st->spurious[last_err]++;
+                    }
+                }
+            }
+            if (i == UART_BUFF_SIZE || (err == ERR_DROP && i == at))
+            {
+                continue;
+            }
+            if (err == ERR_FLIP && i == at)
+            {
+                r = Sim_Feed((unsigned char)(frame[i] ^ (1 << (rand() % 8))), -1, 0);
+            }
+            else
+            {
+                r = Sim_Feed(frame[i], (long)k, i);
+            }
+            if (r > 0)
+            {
+                got = 1;
+            }
+            else if (r < 0)
+            {
+                st->spurious[last_err]++;
+                if (i < UART_BUFF_SIZE - 1)
+                {
+                    spurious_in_frame = 1;
+                }
+            }
+        }
+
+        if (err == ERR_NONE)
+        {
+            if (got)
+            {
+                st->received++;
+                lost_run = 0;
+            }
+            else if (!gaps && spurious_in_frame)
+            {
+                st->lost++;
+                if (++lost_run > st->max_lost_run)
+                {
+                    st->max_lost_run = lost_run;
+                }
+            }
+            else
+            {
+                fprintf(stderr, "good frame %lu not received (%s)\n", k, gaps ? "with gaps" : "back-to-back");
+                failed = 1;
+            }
+        }
+        else if (got)
+        {
+            st->salvaged++;
+        }
+
+        if (gaps)
+        {
+            if ((st->spurious[ERR_DROP] | st->spurious[ERR_FLIP]) != 0)
+            {
+                fprintf(stderr, "frame %lu: %s frame produced a frame\n", k, err_name[last_err]);
+                failed = 1;
+            }
+            uart_rx_len = 0;              // 帧间静默超时（Timer0_ISR）
+        }
+    }
+}
+
+static void Sim_Report(const char *name, const SimStats *st)
+{
+    int e;
+
+    fprintf(stderr, "%s: frames %lu good, %lu dropped, %lu extra, %lu flipped\n", name,
+            st->frames[ERR_NONE], st->frames[ERR_DROP], st->frames[ERR_EXTRA], st->frames[ERR_FLIP]);
+    fprintf(stderr, "  good received %lu, lost to false sync %lu (longest run %lu), salvaged %lu\n",
+            st->received, st->lost, st->max_lost_run, st->salvaged);
+    fprintf(stderr, "  false sync after:");
+    for (e = ERR_NONE; e < ERR_KINDS; e++)
+    {
+        fprintf(stderr, " %s %lu", err_name[e], st->spurious[e]);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long count = 1000000;
+    unsigned int seed = 1;
+    SimStats gap_stats = {{0}};
+    SimStats b2b_stats = {{0}};
+
+    if (argc > 1)
+    {
+        count = strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2)
+    {
+        seed = (unsigned int)strtoul(argv[2], NULL, 10);
+    }
+
+    Sim_Run(1, count, seed, &gap_stats);
+    if (!failed)
+    {
+        Sim_Run(0, count, seed, &b2b_stats);
+    }
+    if (failed)
+    {
+        return 1;
+    }
+
+    Sim_Report("with gaps", &gap_stats);
+    Sim_Report("back-to-back", &b2b_stats);
+    fprintf(stderr, "PASS\n");
+    return 0;
+}
@@ -0,0 +1,439 @@
+// EEPROM日志掉电测试（上位机工具，标准C）
+// 以RAM模拟EEPROM（写入只能1→0、擦除整扇区置0xFF）直接编译固件的iap_log.c，
+// 随机追加快照类与流水类记录，并在任意一次字节写入或扇区擦除中途模拟掉电
+// （写入只完成部分位、擦除只完成部分字节），每次重新挂载后核对回放结果：
+//   快照类：等于最后一次成功写入的值，或掉电时正在写入的值
+//   流水类：序号连续，且以最后一次成功写入（或掉电时正在写入）的记录结尾，内容完整
+// 日志区之后另设一个定长记录区（IapArea_*），与日志交替写入带序号的记录，按流水类同样核对；
+// 并随机清除已有记录附加字节中的位，核对附加字节只有已清除（或掉电时正在清除）的位为0
+//
+// 编译：gcc -O2 -I.. -o iap_log_sim iap_log_sim.c
+// 用法：iap_log_sim [循环次数] [随机种子]    默认20000次、种子1
+// 返回：发现不一致时返回1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#define IAP_LOG_HOST
+#define IAP_LOG_SECTORS     6             // 模拟用少量扇区，使环形回收频繁发生
+#define bit                 unsigned char
+#define code
+
+#include "../iap_log.c"
+
+#define AREA_SECTORS        4             // 定长记录区扇区数（紧接日志区）
+#define AREA_REC_LEN        40            // 定长记录长度
+#define AREA_AUX_LEN        2             // 附加字节数（每扇区11条）
+#define AUX_MODEL_SIZE      64            // 附加字节模型按序号取模保存（大于区内最多记录数）
+#define FLASH_SIZE          ((unsigned long)(IAP_LOG_SECTORS + AREA_SECTORS) * IAP_SECTOR_SIZE)
+#define PIN_TYPES           3             // 快照类型1~3
+#define PIN_LEN_MAX         80            // 3×(80+3)字节，不超过扇区可用空间的一半
+#define STREAM_TYPE         0x10
+#define STREAM_LEN_MAX      40
+
+// ------------------- 模拟EEPROM -------------------
+static unsigned char flash[FLASH_SIZE];
+static unsigned long op_count;            // 已执行的写入/擦除次数
+static unsigned long cut_at;              // 第几次操作时掉电（0=不掉电）
+static unsigned long erase_count[IAP_LOG_SECTORS + AREA_SECTORS];
+static jmp_buf cut_env;
+static unsigned long loops = 20000;       // 主循环变量（跨longjmp保持）
+static unsigned long loop;
+static unsigned long cuts;
+static unsigned long min_kept = (unsigned long)-1;
+
+unsigned char SimFlash_Read(unsigned long addr)
+{
+    return flash[addr];
+}
+
+void SimFlash_Program(unsigned long addr, unsigned char dat)
+{
+    if (++op_count == cut_at)
+    {
+        flash[addr] &= (unsigned char)(dat | rand());     // 只写入部分位
+        longjmp(cut_env, 1);
+    }
+    flash[addr] &= dat;
+}
+
+void SimFlash_Erase(unsigned long addr)
+{
+    unsigned long sector = addr / IAP_SECTOR_SIZE;
+
+    erase_count[sector]++;
+    if (++op_count == cut_at)
+    {
+        memset(&flash[addr], 0xFF, (size_t)(rand() % IAP_SECTOR_SIZE));   // 只擦除一部分
+        longjmp(cut_env, 1);
+    }
+    memset(&flash[addr], 0xFF, IAP_SECTOR_SIZE);
+}
+
+// ------------------- 参考模型 -------------------
+typedef struct {
+    unsigned char len;
+    unsigned char dat[PIN_LEN_MAX];
+} PinValue;
+
+static PinValue model_pin[PIN_TYPES + 1];         // 已确认的快照值（len=0xFF表示无）
+static unsigned long model_serial;                // 已确认的最后一条流水序号（0=无）
+static unsigned char pending_type;                // 掉电时正在写入的类型（0=无）
+static PinValue pending_pin;
+static unsigned long next_serial = 1;
+static IapArea area;
+static unsigned long model_area_serial;           // 已确认的最后一条定长记录序号（0=无）
+static unsigned char area_pending;                // 掉电时正在写入定长记录
+static unsigned long next_area_serial = 1;
+static unsigned long min_area_kept = (unsigned long)-1;
+static unsigned long aux_serial[AUX_MODEL_SIZE];  // 附加字节模型：记录序号
+static unsigned int aux_clr[AUX_MODEL_SIZE];      // 已确认清除的位
+static unsigned long aux_pending_serial;          // 掉电时正在清除附加字节的记录（0=无）
+static unsigned int aux_pending_bits;
+static unsigned long aux_marks;
+
+// 本次挂载的回放结果
+static PinValue got_pin[PIN_TYPES + 1];
+static unsigned long got_first;
+static unsigned long got_last;
+static unsigned long got_count;
+static int got_error;
+
+static void Stream_Fill(unsigned long serial, unsigned char *buf, unsigned char len)
+{
+    unsigned char i;
+
+    buf[0] = (unsigned char)serial;
+    buf[1] = (unsigned char)(serial >> 8);
+    buf[2] = (unsigned char)(serial >> 16);
+    buf[3] = (unsigned char)(serial >> 24);
+    for (i = 4; i < len; i++)
+    {
+        buf[i] = (unsigned char)(serial * 31 + i);
+    }
+}
+
+void IapLog_OnReplay(unsigned char type, const unsigned char *payload, unsigned char len)
+{
+    unsigned char ref[STREAM_LEN_MAX];
+    unsigned long serial;
+
+    if (type >= 1 && type <= PIN_TYPES)
+    {
+        got_pin[type].len = len;
+        memcpy(got_pin[type].dat, payload, len);
+        return;
+    }
+    if (type != STREAM_TYPE || len < 4 || len > STREAM_LEN_MAX)
+    {
+        fprintf(stderr, "unexpected record type 0x%02X len %u\n", type, len);
+        got_error = 1;
+        return;
+    }
+
+    serial = (unsigned long)payload[0] | ((unsigned long)payload[1] << 8) |
+             ((unsigned long)payload[2] << 16) | ((unsigned long)payload[3] << 24);
+    Stream_Fill(serial, ref, len);
+    if (memcmp(ref, payload, len) != 0)
+    {
+        fprintf(stderr, "stream %lu payload corrupted\n", serial);
+        got_error = 1;
+    }
+    if (got_count > 0 && serial != got_last + 1)
+    {
+        fprintf(stderr, "stream gap: %lu after %lu\n", serial, got_last);
+        got_error = 1;
+    }
+    if (got_count == 0)
+    {
+        got_first = serial;
+    }
+    got_last = serial;
+    got_count++;
+}
+
+// 挂载完成后核对回放结果，并把掉电时正在写入的记录按实际结果并入模型
+static int Check_Replay(void)
+{
+    unsigned char t;
+    int ok = !got_error;
+
+    for (t = 1; t <= PIN_TYPES; t++)
+    {
+        int same_model = got_pin[t].len == model_pin[t].len &&
+                         (got_pin[t].len == 0xFF ||
+                          memcmp(got_pin[t].dat, model_pin[t].dat, got_pin[t].len) == 0);
+        int same_pending = pending_type == t && got_pin[t].len == pending_pin.len &&
+                           memcmp(got_pin[t].dat, pending_pin.dat, pending_pin.len) == 0;
+
+        if (!same_model && !same_pending)
+        {
+            fprintf(stderr, "pinned type %u mismatch (got len %u, want %u)\n",
+                    t, got_pin[t].len, model_pin[t].len);
+            ok = 0;
+        }
+        model_pin[t] = got_pin[t];
+    }
+
+    if (pending_type == STREAM_TYPE && got_count > 0 && got_last == next_serial - 1)
+    {
+        model_serial = got_last;
+    }
+    if ((model_serial == 0 && got_count != 0) || (model_serial != 0 && got_last != model_serial))
+    {
+        fprintf(stderr, "stream tail %lu, want %lu\n", got_count ? got_last : 0UL, model_serial);
+        ok = 0;
+    }
+    // 未提交的流水序号不再复用
+    if (pending_type == STREAM_TYPE && model_serial != next_serial - 1)
+    {
+        next_serial = model_serial + 1;
+    }
+    pending_type = 0;
+    return ok;
+}
+
+// 遍历定长记录区核对：序号连续、内容完整，以最后一次成功写入（或掉电时正在写入）的记录结尾
+static int Check_Area(void)
+{
+    IapAreaIter it;
+    unsigned char buf[AREA_REC_LEN];
+    unsigned char ref[AREA_REC_LEN];
+    unsigned char aux[AREA_AUX_LEN];
+    unsigned long serial;
+    unsigned long last = 0;
+    unsigned long count = 0;
+    unsigned int cleared;
+    unsigned int want;
+    int ok = 1;
+
+    IapArea_IterBegin(&area, &it);
+    while (IapArea_Next(&area, &it))
+    {
+        IapArea_Read(&it, 0, buf, AREA_REC_LEN);
+        serial = (unsigned long)buf[0] | ((unsigned long)buf[1] << 8) |
+                 ((unsigned long)buf[2] << 16) | ((unsigned long)buf[3] << 24);
+        Stream_Fill(serial, ref, AREA_REC_LEN);
+        if (memcmp(ref, buf, AREA_REC_LEN) != 0)
+        {
+            fprintf(stderr, "area record %lu corrupted\n", serial);
+            ok = 0;
+        }
+        IapArea_Read(&it, IAP_AREA_AUX(AREA_REC_LEN), aux, AREA_AUX_LEN);
+        cleared = (unsigned int)(~((unsigned int)aux[0] | ((unsigned int)aux[1] << 8)) & 0xFFFF);
+        want = (aux_serial[serial % AUX_MODEL_SIZE] == serial) ? aux_clr[serial % AUX_MODEL_SIZE] : 0;
+        if ((cleared & want) != want ||
+            (cleared & ~want & ~(serial == aux_pending_serial ? aux_pending_bits : 0)) != 0)
+        {
+            fprintf(stderr, "area record %lu aux bits %04X, want %04X\n", serial, cleared, want);
+            ok = 0;
+        }
+        if (serial == aux_pending_serial)
+        {
+            aux_clr[serial % AUX_MODEL_SIZE] = want | (cleared & aux_pending_bits);
+        }
+        if (count > 0 && serial != last + 1)
+        {
+            fprintf(stderr, "area gap: %lu after %lu\n", serial, last);
+            ok = 0;
+        }
+        last = serial;
+        count++;
+    }
+
+    if (area_pending && count > 0 && last == next_area_serial - 1)
+    {
+        model_area_serial = last;
+    }
+    if ((model_area_serial == 0 && count != 0) || (model_area_serial != 0 && last != model_area_serial))
+    {
+        fprintf(stderr, "area tail %lu, want %lu\n", count ? last : 0UL, model_area_serial);
+        ok = 0;
+    }
+    if (area_pending && model_area_serial != next_area_serial - 1)
+    {
+        next_area_serial = model_area_serial + 1;
+    }
+    area_pending = 0;
+    aux_pending_serial = 0;
+    if (next_area_serial > (unsigned long)AREA_SECTORS * IAP_AREA_SLOTS_AUX(AREA_REC_LEN, AREA_AUX_LEN) && count < min_area_kept)
+    {
+        min_area_kept = count;
+    }
+    return ok;
+}
+
+static void Area_Append(void)
+{
+    unsigned char buf[AREA_REC_LEN];
+
+    Stream_Fill(next_area_serial, buf, AREA_REC_LEN);
+    aux_serial[next_area_serial % AUX_MODEL_SIZE] = next_area_serial;
+    aux_clr[next_area_serial % AUX_MODEL_SIZE] = 0;
+    area_pending = 1;
+    next_area_serial++;
+    IapArea_Begin(&area);
+    IapArea_Put(&area, buf, 16);                  // 分两次写入，同固件逐段写入
+    IapArea_Put(&area, buf + 16, AREA_REC_LEN - 16);
+    IapArea_Commit(&area);
+    model_area_serial = next_area_serial - 1;
+    area_pending = 0;
+}
+
+// 随机选一条已有记录，清除其附加字节中的一位（同固件删除已写入EEPROM的历史记录）
+static void Area_Mark(void)
+{
+    IapAreaIter it;
+    unsigned char buf[4];
+    unsigned long serial = 0;
+    unsigned int bit_no = (unsigned int)(rand() % (AREA_AUX_LEN * 8));
+    int n = rand() % (AREA_SECTORS * IAP_AREA_SLOTS_AUX(AREA_REC_LEN, AREA_AUX_LEN));
+
+    IapArea_IterBegin(&area, &it);
+    while (n-- >= 0 && IapArea_Next(&area, &it))
+    {
+        IapArea_Read(&it, 0, buf, 4);
+        serial = (unsigned long)buf[0] | ((unsigned long)buf[1] << 8) |
+                 ((unsigned long)buf[2] << 16) | ((unsigned long)buf[3] << 24);
+    }
+    if (serial == 0 || n >= 0)
+    {
+        return;                                   // 区内记录不足n条
+    }
+    aux_pending_serial = serial;
+    aux_pending_bits = 1U << bit_no;
+    IapArea_ClearBits(&it, (unsigned char)(IAP_AREA_AUX(AREA_REC_LEN) + bit_no / 8), (unsigned char)(1U << (bit_no % 8)));
+    aux_clr[serial % AUX_MODEL_SIZE] |= aux_pending_bits;
+    aux_pending_serial = 0;
+    aux_marks++;
+}
+
+static void Random_Append(void)
+{
+    unsigned char buf[IAP_LOG_REC_MAX];
+    unsigned char type;
+    unsigned char len;
+    unsigned char i;
+
+    if (rand() % 3 == 0)
+    {
+        Area_Append();
+        return;
+    }
+    if (rand() % 8 == 0)
+    {
+        Area_Mark();
+        return;
+    }
+    if (rand() % 4 == 0)
+    {
+        type = (unsigned char)(1 + rand() % PIN_TYPES);
+        len = (unsigned char)(rand() % (PIN_LEN_MAX + 1));
+        for (i = 0; i < len; i++)
+        {
+            buf[i] = (unsigned char)rand();
+        }
+        pending_type = type;
+        pending_pin.len = len;
+        memcpy(pending_pin.dat, buf, len);
+        IapLog_Append(type, buf, len);
+        model_pin[type] = pending_pin;
+    }
+    else
+    {
+        len = (unsigned char)(4 + rand() % (STREAM_LEN_MAX - 3));
+        Stream_Fill(next_serial, buf, len);
+        pending_type = STREAM_TYPE;
+        next_serial++;
+        IapLog_Append(STREAM_TYPE, buf, len);
+        model_serial = next_serial - 1;
+    }
+    pending_type = 0;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long erase_min;
+    unsigned long erase_max;
+    unsigned int s;
+    unsigned char t;
+    int n;
+
+    if (argc > 1)
+    {
+        loops = strtoul(argv[1], NULL, 10);
+    }
+    srand(argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : 1U);
+
+    memset(flash, 0xFF, sizeof(flash));
+    area.first = IAP_LOG_SECTORS;
+    area.sectors = AREA_SECTORS;
+    area.rec_len = AREA_REC_LEN;
+    area.aux_len = AREA_AUX_LEN;
+    for (t = 0; t <= PIN_TYPES; t++)
+    {
+        model_pin[t].len = 0xFF;
+    }
+
+    for (loop = 0; loop < loops; loop++)
+    {
+        // 约一半的循环在随后的若干次操作内掉电
+        cut_at = (rand() % 2) ? op_count + 1 + (unsigned long)(rand() % 400) : 0;
+
+        if (setjmp(cut_env) == 0)
+        {
+            for (t = 0; t <= PIN_TYPES; t++)
+            {
+                got_pin[t].len = 0xFF;
+            }
+            got_count = 0;
+            got_error = 0;
+
+            IapLog_Mount();
+            IapArea_Mount(&area);
+            if (!Check_Replay() || !Check_Area())
+            {
+                fprintf(stderr, "FAILED at loop %lu (op %lu)\n", loop, op_count);
+                return 1;
+            }
+            if (loop > (unsigned long)IAP_LOG_SECTORS * 20 && got_count < min_kept)
+            {
+                min_kept = got_count;
+            }
+
+            for (n = rand() % 60; n > 0; n--)
+            {
+                Random_Append();
+            }
+        }
+        else
+        {
+            cuts++;
+        }
+    }
+
+    erase_min = erase_max = erase_count[0];
+    for (s = 1; s < IAP_LOG_SECTORS; s++)
+    {
+        if (erase_count[s] < erase_min)
+        {
+            erase_min = erase_count[s];
+        }
+        if (erase_count[s] > erase_max)
+        {
+            erase_max = erase_count[s];
+        }
+    }
+
+    fprintf(stderr, "loops %lu, power cuts %lu, flash ops %lu, stream records %lu\n",
+            loops, cuts, op_count, next_serial - 1);
+    fprintf(stderr, "min stream records kept after wrap %lu (%d sectors)\n",
+            min_kept, IAP_LOG_SECTORS);
+    fprintf(stderr, "sector erases min %lu max %lu\n", erase_min, erase_max);
+    fprintf(stderr, "area records %lu, min kept after wrap %lu (%d sectors x %d slots, less torn slots), aux marks %lu\n",
+            next_area_serial - 1, min_area_kept, AREA_SECTORS, IAP_AREA_SLOTS_AUX(AREA_REC_LEN, AREA_AUX_LEN), aux_marks);
+    fprintf(stderr, "PASS\n");
+    return 0;
+}
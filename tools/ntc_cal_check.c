@@ -0,0 +1,203 @@
+// NTC单传感器校准误差检查（上位机工具，标准C）
+// 按固件NTC_CalibApply的方法（单精度浮点）为每组B值/25℃阻值计算修正表，
+// 再按ADC_To_Temp的查表+修正插值（整数运算）换算全部有效ADC码，
+// 与该组参数下的B值公式（双精度，即NTC_USE_LUT=0时的浮点实现）逐一比对，给出最大误差
+//
+// 编译：gcc -O2 -o ntc_cal_check ntc_cal_check.c -lm
+// 用法：ntc_cal_check            扫描B值3700~4300（步长50）、25℃阻值9k~11k（步长250Ω）
+// 返回：任一组合误差超过NTC_CAL_MAX_ERR（0.1℃）时返回1
+//
+// 名义NTC参数、查表和修正表参数与uart4.h保持一致；修改后需同步
+
+#include <stdio.h>
+#include <math.h>
+
+// 与uart4.h保持一致
+#define NTC_R_REF       10000UL
+#define NTC_R0          10000UL
+#define NTC_T0          298.15
+#define NTC_B_VALUE     3950.0
+#define NTC_LUT_SHIFT   4
+#define NTC_CAL_BASE    (-4000)
+#define NTC_CAL_SHIFT   11
+#define NTC_CAL_KNOTS   10
+
+#define NTC_LUT_STEP    (1 << NTC_LUT_SHIFT)
+#define NTC_CAL_MAX_ERR 1             // 允许的最大误差（0.1℃）
+#define TEMP_INVALID    (-990)
+
+#define SWEEP_B_MIN     3700
+#define SWEEP_B_MAX     4300
+#define SWEEP_B_STEP    50
+#define SWEEP_R0_MIN    900           // 25℃阻值（10Ω，与NTC_Calib.r0_10ohm相同单位）
+#define SWEEP_R0_MAX    1100
+#define SWEEP_R0_STEP   25
+
+static short lut[4096 / NTC_LUT_STEP + 1];
+static unsigned int lut_first;
+static unsigned int adc_min;
+static unsigned int adc_max;
+static short corr[NTC_CAL_KNOTS];
+
+// B值公式（双精度，r0单位Ω）
+static double Formula_Celsius(unsigned int adc_val, double r0, double b_value)
+{
+    double Rntc = (4096.0 * (double)NTC_R_REF) / (double)adc_val - (double)NTC_R_REF;
+    double temp_k = 1.0 / (log(Rntc / r0) / b_value + 1.0 / NTC_T0);
+    return temp_k - 273.15;
+}
+
+// 与固件ADC_To_Temp浮点实现相同（偏移为0）
+static short Formula_Deci(unsigned int adc_val, double r0, double b_value)
+{
+    double temp_c;
+
+    if (adc_val == 0 || adc_val >= 4096)
+    {
+        return TEMP_INVALID;
+    }
+    temp_c = Formula_Celsius(adc_val, r0, b_value);
+    if (temp_c < -40.0 || temp_c > 125.0)
+    {
+        return TEMP_INVALID;
+    }
+    return (short)(temp_c * 10.0 + 0.5);
+}
+
+// 名义查表（与tools/ntc_lut_gen.c生成方法相同）
+static void Lut_Build(void)
+{
+    unsigned int adc;
+    unsigned int k;
+    unsigned int lut_last;
+
+    adc_min = 0;
+    adc_max = 0;
+    for (adc = 1; adc < 4096; adc++)
+    {
+        if (Formula_Deci(adc, (double)NTC_R0, NTC_B_VALUE) != TEMP_INVALID)
+        {
+            if (adc_min == 0)
+            {
+                adc_min = adc;
+            }
+            adc_max = adc;
+        }
+    }
+    lut_first = adc_min >> NTC_LUT_SHIFT;
+    lut_last = (adc_max >> NTC_LUT_SHIFT) + 1;
+    for (k = lut_first; k <= lut_last; k++)
+    {
+        lut[k - lut_first] = (short)floor(Formula_Celsius(k * NTC_LUT_STEP, (double)NTC_R0, NTC_B_VALUE) * 100.0 + 0.5);
+    }
+}
+
+// 与固件NTC_CalibApply逐句对应（单精度）
+static void Calib_Apply(unsigned int b_value, unsigned int r0_10ohm)
+{
+    unsigned char i;
+    float t_nom;
+    float ln_r;
+    float t_cal;
+    float ln_r0;
+
+    ln_r0 = logf((float)NTC_R0 / ((float)r0_10ohm * 10.0f));
+    for (i = 0; i < NTC_CAL_KNOTS; i++)
+    {
+        t_nom = (float)(NTC_CAL_BASE + ((long)i << NTC_CAL_SHIFT)) / 100.0f;
+        ln_r = (float)NTC_B_VALUE * (1.0f / (t_nom + 273.15f) - 1.0f / (float)NTC_T0);
+        t_cal = 1.0f / (1.0f / (float)NTC_T0 + (ln_r + ln_r0) / (float)b_value) - 273.15f;
+        corr[i] = (short)((t_cal - t_nom) * 100.0f + ((t_cal >= t_nom) ? 0.5f : -0.5f));
+    }
+}
+
+// 与固件ADC_To_Temp查表实现（含校准修正）逐句对应
+static short Lut_Deci(unsigned int adc_val)
+{
+    unsigned char idx;
+    unsigned char frac;
+    short t0;
+    short temp_centi;
+    unsigned int cal_pos;
+
+    if (adc_val < adc_min || adc_val > adc_max)
+    {
+        return TEMP_INVALID;
+    }
+    idx = (unsigned char)((adc_val >> NTC_LUT_SHIFT) - lut_first);
+    frac = (unsigned char)(adc_val & (NTC_LUT_STEP - 1));
+    t0 = lut[idx];
+    temp_centi = t0 + (short)(((unsigned int)(lut[idx + 1] - t0) * frac) >> NTC_LUT_SHIFT);
+
+    cal_pos = (temp_centi > NTC_CAL_BASE) ? (unsigned int)(temp_centi - NTC_CAL_BASE) : 0;
+    idx = (unsigned char)(cal_pos >> NTC_CAL_SHIFT);
+    cal_pos &= (1 << NTC_CAL_SHIFT) - 1;
+    temp_centi += corr[idx] + (short)(((long)(corr[idx + 1] - corr[idx]) * cal_pos) >> NTC_CAL_SHIFT);
+
+    return (short)((temp_centi + 5) / 10);
+}
+
+int main(void)
+{
+    unsigned int b_value;
+    unsigned int r0;
+    unsigned int adc;
+    unsigned int compared;
+    unsigned long total = 0;
+    short ref;
+    short got;
+    int err;
+    int max_err = 0;
+    unsigned int worst_b = 0;
+    unsigned int worst_r0 = 0;
+    unsigned int worst_adc = 0;
+    int fail = 0;
+
+    Lut_Build();
+
+    printf("   B    R0   codes  max err\n");
+    for (b_value = SWEEP_B_MIN; b_value <= SWEEP_B_MAX; b_value += SWEEP_B_STEP)
+    {
+        for (r0 = SWEEP_R0_MIN; r0 <= SWEEP_R0_MAX; r0 += SWEEP_R0_STEP)
+        {
+            int combo_err = 0;
+
+            Calib_Apply(b_value, r0);
+            compared = 0;
+            for (adc = adc_min; adc <= adc_max; adc++)
+            {
+                ref = Formula_Deci(adc, (double)r0 * 10.0, (double)b_value);
+                got = Lut_Deci(adc);
+                if (ref == TEMP_INVALID)
+                {
+                    continue;   // 校准参数下超出-40℃~125℃：浮点实现返回无效，查表实现仍给出温度
+                }
+                err = ref > got ? ref - got : got - ref;
+                if (err > combo_err)
+                {
+                    combo_err = err;
+                }
+                if (err > max_err)
+                {
+                    max_err = err;
+                    worst_b = b_value;
+                    worst_r0 = r0;
+                    worst_adc = adc;
+                }
+                compared++;
+            }
+            total += compared;
+            printf("%5u %5u0 %6u  %d.%d C%s\n", b_value, r0, compared,
+                   combo_err / 10, combo_err % 10, combo_err > NTC_CAL_MAX_ERR ? "  FAIL" : "");
+            if (combo_err > NTC_CAL_MAX_ERR)
+            {
+                fail = 1;
+            }
+        }
+    }
+
+    fprintf(stderr, "compared %lu codes, max error %d.%d C (B %u, R0 %u0, ADC %u), limit 0.%d C\n",
+            total, max_err / 10, max_err % 10, worst_b, worst_r0, worst_adc, NTC_CAL_MAX_ERR);
+    fprintf(stderr, "%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,177 @@
+// NTC温度查表生成器（上位机工具，标准C）
+// 按uart4.h中的NTC参数（B值法）计算查表节点，输出可直接粘贴到1.20uart4.c的表定义，
+// 并对全部4096个ADC码逐一比对查表插值结果与原B值公式，给出最大误差和上位机耗时对比
+//
+// 编译：gcc -O2 -o ntc_lut_gen ntc_lut_gen.c -lm
+// 用法：ntc_lut_gen > table.txt       表定义输出到标准输出，校验结果输出到标准错误
+// 返回：误差超过NTC_LUT_MAX_ERR（0.1℃）或有效区间不连续时返回1
+//
+// 修改NTC_R_REF/NTC_R0/NTC_T0/NTC_B_VALUE或NTC_LUT_SHIFT后需重新生成
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+// 与uart4.h保持一致
+#define NTC_R_REF       10000UL
+#define NTC_R0          10000UL
+#define NTC_T0          298.15
+#define NTC_B_VALUE     3950.0
+#define NTC_LUT_SHIFT   4             // 节点间隔2^4=16个ADC码
+
+#define NTC_LUT_STEP    (1 << NTC_LUT_SHIFT)
+#define NTC_LUT_MAX_ERR 1             // 允许的最大误差（0.1℃）
+#define TEMP_INVALID    (-990)
+
+// 原B值公式（与固件ADC_To_Temp的浮点实现相同，双精度）
+static double Formula_Celsius(unsigned int adc_val)
+{
+    double Rntc = (4096.0 * (double)NTC_R_REF) / (double)adc_val - (double)NTC_R_REF;
+    double temp_k = 1.0 / (log(Rntc / (double)NTC_R0) / NTC_B_VALUE + 1.0 / NTC_T0);
+    return temp_k - 273.15;
+}
+
+static short Formula_Deci(unsigned int adc_val)
+{
+    double temp_c;
+
+    if (adc_val == 0 || adc_val >= 4096)
+    {
+        return TEMP_INVALID;
+    }
+    temp_c = Formula_Celsius(adc_val);
+    if (temp_c < -40.0 || temp_c > 125.0)
+    {
+        return TEMP_INVALID;
+    }
+    return (short)(temp_c * 10.0 + 0.5);
+}
+
+static short lut[4096 / NTC_LUT_STEP + 1];
+static unsigned int lut_first;
+static unsigned int lut_last;
+static unsigned int adc_min;
+static unsigned int adc_max;
+
+// 查表插值（与固件ADC_To_Temp查表实现逐句对应）
+static short Lut_Deci(unsigned int adc_val)
+{
+    unsigned char idx;
+    unsigned char frac;
+    short t0;
+    short temp_centi;
+
+    if (adc_val < adc_min || adc_val > adc_max)
+    {
+        return TEMP_INVALID;
+    }
+    idx = (unsigned char)((adc_val >> NTC_LUT_SHIFT) - lut_first);
+    frac = (unsigned char)(adc_val & (NTC_LUT_STEP - 1));
+    t0 = lut[idx];
+    temp_centi = t0 + (short)(((unsigned int)(lut[idx + 1] - t0) * frac) >> NTC_LUT_SHIFT);
+    return (short)((temp_centi + 5) / 10);
+}
+
+int main(void)
+{
+    unsigned int adc;
+    unsigned int k;
+    int err;
+    int max_err = 0;
+    unsigned int max_err_adc = 0;
+    unsigned int valid_count = 0;
+    volatile long sink = 0;
+    clock_t t_start;
+    double t_formula;
+    double t_lut;
+    int rep;
+
+    // 1. 由原公式确定有效ADC区间（-40℃~125℃），并检查区间连续
+    adc_min = 0;
+    adc_max = 0;
+    for (adc = 0; adc < 4096; adc++)
+    {
+        if (Formula_Deci(adc) != TEMP_INVALID)
+        {
+            if (adc_min == 0)
+            {
+                adc_min = adc;
+            }
+            else if (adc != adc_max + 1)
+            {
+                fprintf(stderr, "valid ADC range is not contiguous at %u\n", adc);
+                return 1;
+            }
+            adc_max = adc;
+            valid_count++;
+        }
+    }
+
+    // 2. 生成节点（单位0.01℃），只保留有效区间用到的节点
+    lut_first = adc_min >> NTC_LUT_SHIFT;
+    lut_last = (adc_max >> NTC_LUT_SHIFT) + 1;
+    for (k = lut_first; k <= lut_last; k++)
+    {
+        lut[k - lut_first] = (short)floor(Formula_Celsius(k * NTC_LUT_STEP) * 100.0 + 0.5);
+    }
+
+    // 3. 全部4096个ADC码逐一比对
+    for (adc = 0; adc < 4096; adc++)
+    {
+        short ref = Formula_Deci(adc);
+        short got = Lut_Deci(adc);
+
+        if ((ref == TEMP_INVALID) != (got == TEMP_INVALID))
+        {
+            fprintf(stderr, "validity mismatch at ADC %u\n", adc);
+            return 1;
+        }
+        err = ref > got ? ref - got : got - ref;
+        if (err > max_err)
+        {
+            max_err = err;
+            max_err_adc = adc;
+        }
+    }
+
+    // 4. 上位机耗时对比（仅反映相对开销，单片机上的实际周期需在目标板上测量）
+    t_start = clock();
+    for (rep = 0; rep < 200; rep++)
+    {
+        for (adc = 1; adc < 4096; adc++)
+        {
+            sink += Formula_Deci(adc);
+        }
+    }
+    t_formula = (double)(clock() - t_start) / CLOCKS_PER_SEC;
+    t_start = clock();
+    for (rep = 0; rep < 200; rep++)
+    {
+        for (adc = 1; adc < 4096; adc++)
+        {
+            sink += Lut_Deci(adc);
+        }
+    }
+    t_lut = (double)(clock() - t_start) / CLOCKS_PER_SEC;
+
+    // 5. 输出表定义
+    printf("#define NTC_LUT_FIRST       %-6u// 首节点序号（ADC码 >> NTC_LUT_SHIFT）\n", lut_first);
+    printf("#define NTC_LUT_SIZE        %-6u// 节点数\n", lut_last - lut_first + 1);
+    printf("#define NTC_ADC_VALID_MIN   %-6u// 最小有效ADC码（对应-40℃）\n", adc_min);
+    printf("#define NTC_ADC_VALID_MAX   %-6u// 最大有效ADC码（对应125℃）\n", adc_max);
+    printf("static short code ntc_temp_lut[NTC_LUT_SIZE] = {");
+    for (k = 0; k <= lut_last - lut_first; k++)
+    {
+        printf("%s%6d,", (k % 10 == 0) ? "\n    " : " ", lut[k]);
+    }
+    printf("\n};\n");
+
+    fprintf(stderr, "valid ADC %u..%u (%u codes), %u knots\n",
+            adc_min, adc_max, valid_count, lut_last - lut_first + 1);
+    fprintf(stderr, "max error %d.%d C at ADC %u (limit 0.%d C)\n",
+            max_err / 10, max_err % 10, max_err_adc, NTC_LUT_MAX_ERR);
+    fprintf(stderr, "host time: formula %.3fs, lut %.3fs (%.1fx)\n",
+            t_formula, t_lut, t_lut > 0 ? t_formula / t_lut : 0.0);
+
+    return (max_err > NTC_LUT_MAX_ERR) ? 1 : 0;
+}
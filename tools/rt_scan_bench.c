@@ -0,0 +1,154 @@
+// 实时数据表扫描对比（上位机工具，标准C）
+// 对比原结构体数组（每从站一条DataRecord）与按字段分列+位图两种布局下，
+// "统计有效且超温从站"这一全表扫描的耗时，并核对两种布局结果一致
+//
+// 编译：gcc -O2 -o rt_scan_bench rt_scan_bench.c
+// 用法：rt_scan_bench [从站数] [异常比例%]    默认60个从站、5%异常
+//
+// 上位机缓存行为与单片机不同，结果仅反映访问量的相对差异；
+// 单片机上的实际周期需在目标板上测量
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define MAX_SLAVES          1024
+#define ALARM_TEMP_DECI     250
+#define RT_BITMAP_BYTES     ((MAX_SLAVES + 7) / 8)
+#define RT_BIT_TEST(map, idx)   ((map)[(idx) >> 3] & (1 << ((idx) & 7)))
+#define RT_BIT_SET(map, idx)    ((map)[(idx) >> 3] |= (unsigned char)(1 << ((idx) & 7)))
+#define SCAN_REPEAT         200000
+
+// 与uart4.h中DataRecord布局一致（RTC时间以6字节代替）
+typedef struct {
+    unsigned char pid;
+    unsigned char aid;
+    unsigned char temp;
+    short temp_deci;
+    unsigned char reserved[1];
+    unsigned char volt1;
+    unsigned char volt2;
+    unsigned char fosc;
+    unsigned long timestamp;
+    unsigned char save_time[6];
+    unsigned char is_valid;
+} DataRecord;
+
+static DataRecord aos[MAX_SLAVES];
+static short rt_temp_deci[MAX_SLAVES];
+static unsigned char rt_valid_map[RT_BITMAP_BYTES];
+static unsigned char rt_abnormal_map[RT_BITMAP_BYTES];
+
+// 原布局：逐条读取结构体并比较温度
+static unsigned int Scan_AoS(unsigned int n)
+{
+    unsigned int i;
+    unsigned int count = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        if (aos[i].is_valid && aos[i].temp_deci > ALARM_TEMP_DECI)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// 新布局：与固件DisplayPage4相同，先按字节跳过无异常的8个从站
+static unsigned int Scan_Bitmap(unsigned int n)
+{
+    unsigned int i;
+    unsigned int count = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        if ((i & 7) == 0 && (rt_valid_map[i >> 3] & rt_abnormal_map[i >> 3]) == 0)
+        {
+            i |= 7;
+            continue;
+        }
+        if (RT_BIT_TEST(rt_valid_map, i) && RT_BIT_TEST(rt_abnormal_map, i))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int n = 60;
+    unsigned int pct = 5;
+    unsigned int i;
+    unsigned int rep;
+    unsigned int c_aos;
+    unsigned int c_bmp;
+    volatile unsigned long sink = 0;
+    clock_t t_start;
+    double t_aos;
+    double t_bmp;
+
+    if (argc > 1)
+    {
+        n = (unsigned int)atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        pct = (unsigned int)atoi(argv[2]);
+    }
+    if (n == 0 || n > MAX_SLAVES || pct > 100)
+    {
+        fprintf(stderr, "usage: rt_scan_bench [1..%d] [0..100]\n", MAX_SLAVES);
+        return 1;
+    }
+
+    // 两种布局写入相同数据（约90%从站在线）
+    srand(1);
+    for (i = 0; i < n; i++)
+    {
+        short t = (short)((unsigned int)rand() % 100 < pct ? 260 + rand() % 200 : rand() % 250);
+        int valid = (rand() % 10) != 0;
+
+        aos[i].aid = (unsigned char)(i + 1);
+        aos[i].temp_deci = t;
+        aos[i].is_valid = (unsigned char)valid;
+        rt_temp_deci[i] = t;
+        if (valid)
+        {
+            RT_BIT_SET(rt_valid_map, i);
+        }
+        if (t > ALARM_TEMP_DECI)
+        {
+            RT_BIT_SET(rt_abnormal_map, i);
+        }
+    }
+
+    c_aos = Scan_AoS(n);
+    c_bmp = Scan_Bitmap(n);
+    if (c_aos != c_bmp)
+    {
+        fprintf(stderr, "result mismatch: aos %u, bitmap %u\n", c_aos, c_bmp);
+        return 1;
+    }
+
+    t_start = clock();
+    for (rep = 0; rep < SCAN_REPEAT; rep++)
+    {
+        sink += Scan_AoS(n);
+    }
+    t_aos = (double)(clock() - t_start) / CLOCKS_PER_SEC;
+    t_start = clock();
+    for (rep = 0; rep < SCAN_REPEAT; rep++)
+    {
+        sink += Scan_Bitmap(n);
+    }
+    t_bmp = (double)(clock() - t_start) / CLOCKS_PER_SEC;
+
+    printf("slaves %u, abnormal %u\n", n, c_aos);
+    printf("bytes touched per scan: aos %lu, bitmap %u\n",
+           (unsigned long)(n * sizeof(DataRecord)), 2 * ((n + 7) / 8));
+    printf("host time (%d scans): aos %.3fs, bitmap %.3fs (%.1fx)\n",
+           SCAN_REPEAT, t_aos, t_bmp, t_bmp > 0 ? t_aos / t_bmp : 0.0);
+    return 0;
+}
@@ -0,0 +1,181 @@
+// 二进制遥测记录参考解码器（上位机/网关侧，标准C，不依赖单片机头文件）
+// 记录格式与固件uart4.h"二进制遥测配置"一致：13字节固定长度，小端序
+//
+// 编译：gcc -o telemetry_decode telemetry_decode.c
+// 用法：telemetry_decode [抓包文件]      不带参数时从标准输入读取
+// 输出：每条有效记录一行，类型,AID,PID,数值1,数值2,滴答(ms)
+//
+// 流中混入的ASCII命令回复或损坏字节会被跳过：遇到同步字且类型、校验和都正确才输出，
+// 否则前移1字节继续查找（与固件接收端的滑动窗口组帧方式相同）
+
+#include <stdio.h>
+
+#define TELEMETRY_SYNC          0xA5
+#define TELEMETRY_REC_LEN       13
+#define TELEMETRY_TYPE_SAMPLE   0x01
+#define TELEMETRY_TYPE_ALARM    0x02
+#define TELEMETRY_TYPE_RECOVERY 0x03
+#define TELEMETRY_TYPE_MAX_TEMP 0x04
+#define TELEMETRY_TYPE_COMM_LOSS    0x05
+#define TELEMETRY_TYPE_COMM_RESTORE 0x06
+#define TELEMETRY_TYPE_WARNING  0x07
+#define TELEMETRY_TYPE_RATE_RISE 0x08
+#define TELEMETRY_TYPE_MIN_TEMP 0x09
+#define TEMP_INVALID            (-990)
+
+// 校验一条记录：同步字、已知类型、[1]~[11]字节累加和
+static int Telemetry_Valid(const unsigned char *rec)
+{
+    unsigned char sum = 0;
+    int i;
+
+    if (rec[0] != TELEMETRY_SYNC)
+    {
+        return 0;
+    }
+    if (rec[1] < TELEMETRY_TYPE_SAMPLE || rec[1] > TELEMETRY_TYPE_MIN_TEMP)
+    {
+        return 0;
+    }
+    for (i = 1; i < TELEMETRY_REC_LEN - 1; i++)
+    {
+        sum = (unsigned char)(sum + rec[i]);
+    }
+    return sum == rec[TELEMETRY_REC_LEN - 1];
+}
+
+// 输出0.1℃温度，带单位（无效值显示为"invalid"）
+static void PrintTemp(int deci)
+{
+    if (deci == TEMP_INVALID)
+    {
+        printf("invalid");
+    }
+    else if (deci < 0)
+    {
+        printf("-%d.%dC", (-deci) / 10, (-deci) % 10);
+    }
+    else
+    {
+        printf("%d.%dC", deci / 10, deci % 10);
+    }
+}
+
+// 解码并打印一条有效记录
+static void Telemetry_Print(const unsigned char *rec)
+{
+    int value1 = (short)(rec[4] | (rec[5] << 8));
+    unsigned int value2 = rec[6] | (rec[7] << 8);
+    unsigned long tick = (unsigned long)rec[8] | ((unsigned long)rec[9] << 8) |
+                         ((unsigned long)rec[10] << 16) | ((unsigned long)rec[11] << 24);
+
+    switch (rec[1])
+    {
+        case TELEMETRY_TYPE_SAMPLE:
+            printf("sample,%u,%u,", rec[2], rec[3]);
+            PrintTemp(value1);
+            printf(",%umV", value2);
+            break;
+
+        case TELEMETRY_TYPE_ALARM:
+            printf("alarm,%u,%u,", rec[2], rec[3]);
+            PrintTemp(value1);
+            printf(",%umV", value2);
+            break;
+
+        case TELEMETRY_TYPE_RECOVERY:
+            printf("recovery,%u,%u,", rec[2], rec[3]);
+            PrintTemp(value1);
+            printf(",peak ");
+            PrintTemp((int)value2);
+            break;
+
+        case TELEMETRY_TYPE_MAX_TEMP:
+            printf("max_temp,%u,%u,", rec[2], rec[3]);
+            PrintTemp(value1);
+            printf(",%umV", value2);
+            break;
+
+        case TELEMETRY_TYPE_COMM_LOSS:
+            printf("comm_loss,%u,%u,silent %ds,offline #%u", rec[2], rec[3], value1, value2);
+            break;
+
+        case TELEMETRY_TYPE_COMM_RESTORE:
+            printf("comm_restore,%u,%u,,offline #%u", rec[2], rec[3], value2);
+            break;
+
+        case TELEMETRY_TYPE_WARNING:
+            printf("warning,%u,%u,", rec[2], rec[3]);
+            PrintTemp(value1);
+            printf(",%umV", value2);
+            break;
+
+        case TELEMETRY_TYPE_RATE_RISE:
+            printf("rate_rise,%u,%u,", rec[2], rec[3]);
+            PrintTemp(value1);
+            printf(",%u.%uC/min", value2 / 10, value2 % 10);
+            break;
+
+        case TELEMETRY_TYPE_MIN_TEMP:
+            printf("min_temp,%u,%u,", rec[2], rec[3]);
+            PrintTemp(value1);
+            printf(",%umV", value2);
+            break;
+    }
+    printf(",%lu\n", tick);
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    unsigned char win[TELEMETRY_REC_LEN];
+    int len = 0;
+    int c;
+    int i;
+    unsigned long skipped = 0;
+
+    if (argc > 1)
+    {
+        in = fopen(argv[1], "rb");
+        if (in == NULL)
+        {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    while ((c = fgetc(in)) != EOF)
+    {
+        win[len++] = (unsigned char)c;
+        if (len < TELEMETRY_REC_LEN)
+        {
+            continue;
+        }
+
+        if (Telemetry_Valid(win))
+        {
+            Telemetry_Print(win);
+            len = 0;
+        }
+        else
+        {
+            // 丢弃首字节，窗口左移一位继续查找
+            for (i = 1; i < TELEMETRY_REC_LEN; i++)
+            {
+                win[i - 1] = win[i];
+            }
+            len = TELEMETRY_REC_LEN - 1;
+            skipped++;
+        }
+    }
+
+    if (skipped > 0)
+    {
+        fprintf(stderr, "skipped %lu byte(s) while resyncing\n", skipped);
+    }
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+    return 0;
+}
@@ -0,0 +1,209 @@
+// 软件定时器（分层时间轮）对比测试（上位机工具，标准C）
+// 直接编译固件的timer_wheel.c，随机启动/重启/取消定时器（含超过总跨度的长定时、回调中重启），
+// 随机模拟主循环停顿（一次处理多个节拍，超过255个节拍时中断侧丢弃多余节拍），
+// 与逐个扫描全部定时器的参考模型对比：每个定时器必须在到期节拍当拍回调，且只回调一次
+// 节拍计数从接近32位回绕处开始，覆盖节拍计数回绕
+//
+// 编译：gcc -O2 -I.. -o timer_wheel_sim timer_wheel_sim.c
+// 用法：timer_wheel_sim [循环次数] [随机种子]    默认200000次、种子1
+// 返回：发现不一致时返回1
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TW_HOST
+#define bit                 unsigned char
+
+static unsigned char EA;                  // 固件中为中断总开关，此处仅占位
+
+// C251的long为32位：按32位编译时间轮，节拍计数回绕与固件一致（假定上位机int为32位）
+#define long                int
+#include "../timer_wheel.c"
+#undef long
+
+typedef unsigned int Tick;                // 与固件unsigned long等宽的节拍计数
+
+#define SIM_START_TICK      ((Tick)(0xFFFFFFFFUL - 3UL * TW_SPAN))   // 起始节拍（运行中发生32位回绕）
+#define SIM_KEEP_IDS        (TW_TIMER_COUNT / 4)   // 0~SIM_KEEP_IDS-1只在自身回调中重启，保证长定时能走到到期
+
+// ------------------- 参考模型 -------------------
+static unsigned char ref_running[TW_TIMER_COUNT];
+static Tick ref_expire[TW_TIMER_COUNT];
+static unsigned long expired_count;
+static unsigned long long_count;          // 超过总跨度的定时次数
+static int failed;
+
+static Tick Random_Ticks(void)
+{
+    switch (rand() % 8)
+    {
+    case 0:
+        return (Tick)(rand() % 3);                            // 0/1/2（0按1处理）
+    case 1:
+        return (Tick)(rand() % TW_SLOTS);
+    case 2:
+    case 3:
+        return (Tick)(rand() % (TW_SLOTS * TW_SLOTS));
+    case 4:
+        return ((Tick)rand() * 7919U) % TW_SPAN;
+    case 5:
+        long_count++;
+        return TW_SPAN + ((Tick)rand() * 7919U) % (2 * TW_SPAN);
+    default:
+        return TW_SEC(10 + rand() % 3600);                   // 离线超时的实际取值范围
+    }
+}
+
+static unsigned char Random_Id(void)
+{
+    return (unsigned char)(SIM_KEEP_IDS + rand() % (TW_TIMER_COUNT - SIM_KEEP_IDS));
+}
+
+static void Sim_Start(unsigned char id, Tick ticks)
+{
+    TimerWheel_Start(id, ticks);
+    ref_running[id] = 1;
+    ref_expire[id] = TimerWheel_Now() + (ticks ? ticks : 1);
+}
+
+static void Sim_Cancel(unsigned char id)
+{
+    TimerWheel_Cancel(id);
+    ref_running[id] = 0;
+}
+
+void TimerWheel_OnExpire(unsigned char id)
+{
+    Tick now = TimerWheel_Now();
+
+    if (id >= TW_TIMER_COUNT || !ref_running[id])
+    {
+        fprintf(stderr, "timer %u expired while stopped (tick %u)\n", id, now);
+        failed = 1;
+        return;
+    }
+    if (ref_expire[id] != now)
+    {
+        fprintf(stderr, "timer %u expired at tick %u, due %u\n", id, now, ref_expire[id]);
+        failed = 1;
+    }
+    ref_running[id] = 0;
+    expired_count++;
+
+        if (id < SIM_KEEP_IDS)
+    {
+        Sim_Start(id, Random_Ticks());
+        return;
+    }
+
+    // 回调中重启本定时器或操作其他定时器
+    switch (rand() % 4)
+    {
+    case 0:
+        Sim_Start(id, Random_Ticks());
+        break;
+    case 1:
+        Sim_Start(Random_Id(), Random_Ticks());
+        break;
+    case 2:
+        Sim_Cancel(Random_Id());
+        break;
+    default:
+        break;
+    }
+}
+
+// 全扫描核对：已到期未回调的定时器、运行状态不一致
+static void Sim_Check(void)
+{
+    Tick now = TimerWheel_Now();
+    unsigned char id;
+
+    for (id = 0; id < TW_TIMER_COUNT; id++)
+    {
+        if (ref_running[id] != TimerWheel_IsRunning(id))
+        {
+            fprintf(stderr, "timer %u running state %u, expected %u (tick %u)\n",
+                    id, TimerWheel_IsRunning(id), ref_running[id], now);
+            failed = 1;
+        }
+        if (ref_running[id] && (int)(ref_expire[id] - now) <= 0)
+        {
+            fprintf(stderr, "timer %u missed, due %u, now %u\n", id, ref_expire[id], now);
+            failed = 1;
+        }
+    }
+}
+
+// 模拟中断：ticks个节拍（每节拍TW_TICK_MS次1ms中断）
+static void Sim_Isr(Tick ticks)
+{
+    Tick ms;
+
+    for (ms = ticks * TW_TICK_MS; ms > 0; ms--)
+    {
+        TimerWheel_IsrTick();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long loops = 200000;
+    unsigned long loop;
+    unsigned long stalls = 0;
+    Tick start_tick;
+    unsigned char n;
+
+    if (argc > 1)
+    {
+        loops = strtoul(argv[1], NULL, 0);
+    }
+    srand(argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 0) : 1);
+
+    TimerWheel_Init();
+    tw_now = SIM_START_TICK;
+    start_tick = tw_now;
+    for (n = 0; n < SIM_KEEP_IDS; n++)
+    {
+        Sim_Start(n, Random_Ticks());
+    }
+
+    for (loop = 0; loop < loops && !failed; loop++)
+    {
+        for (n = (unsigned char)(rand() % 4); n > 0; n--)
+        {
+            if (rand() % 5 == 0)
+            {
+                Sim_Cancel(Random_Id());
+            }
+            else
+            {
+                Sim_Start(Random_Id(), Random_Ticks());
+            }
+        }
+
+        // 主循环大多每节拍运行一次，偶尔停顿（含超过255个节拍的长停顿）
+        if (rand() % 50 == 0)
+        {
+            Sim_Isr((Tick)(1 + rand() % 400));
+            stalls++;
+        }
+        else
+        {
+            Sim_Isr((Tick)(1 + rand() % 2));
+        }
+        TimerWheel_Run();
+        Sim_Check();
+    }
+
+    if (failed)
+    {
+        fprintf(stderr, "FAILED at loop %lu\n", loop);
+        return 1;
+    }
+    fprintf(stderr, "loops %lu, ticks %u, stalls %lu, expired %lu, beyond-span starts %lu\n",
+            loops, tw_now - start_tick, stalls, expired_count, long_count);
+    fprintf(stderr, "tick counter wrapped: %s\n", tw_now < start_tick ? "yes" : "no");
+    fprintf(stderr, "PASS\n");
+    return 0;
+}
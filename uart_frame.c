@@ -0,0 +1,51 @@
+// 串口接收组帧（6字节协议帧滑动窗口，格式见uart_frame.h）
+// 纯数据处理，不访问寄存器；在UART4接收中断中调用，校验和直接在此计算，不与主循环共用Protocol_Check
+// 上位机测试：tools/frame_feed_sim.c 直接编译本文件（定义UF_HOST），注入丢字节/多字节/错位字节核对重新同步
+
+#ifndef UF_HOST
+#include "STC32G.H"
+#endif
+#include "uart_frame.h"
+
+// ------------------- 全局变量 -------------------
+unsigned char uart_rx_buff[UART_BUFF_SIZE] = {0};  // 组帧滑动窗口（6字节协议帧，仅ISR使用）
+unsigned char uart_rx_len = 0;                     // 组帧窗口内数据长度
+
+// ------------------- 对外接口 -------------------
+// 滑动窗口组帧：逐字节送入uart_rx_buff，窗口满6字节且FCS校验通过返回1，同时窗口长度清零，
+// 下一字节重新开始组帧（帧内容留在uart_rx_buff中，调用方须在下一字节到来前取走）；
+// 校验失败时不清空窗口，下一字节到来时丢弃首字节左移一位，直到重新对齐到有效帧
+bit UART4_FrameFeed(unsigned char dat)
+{
+    unsigned char i;
+    unsigned char fcs;
+
+    // 窗口已满但未通过校验：丢弃首字节，窗口左移一位
+    if (uart_rx_len >= UART_BUFF_SIZE)
+    {
+        for (i = 1; i < UART_BUFF_SIZE; i++)
+        {
+            uart_rx_buff[i - 1] = uart_rx_buff[i];
+        }
+        uart_rx_len = UART_BUFF_SIZE - 1;
+    }
+
+    uart_rx_buff[uart_rx_len++] = dat;
+
+    if (uart_rx_len < UART_BUFF_SIZE)
+    {
+        return 0;
+    }
+
+    fcs = 0;
+    for (i = 0; i < UART_BUFF_SIZE - 1; i++)
+    {
+        fcs += uart_rx_buff[i];
+    }
+    if (fcs != uart_rx_buff[UART_BUFF_SIZE - 1])
+    {
+        return 0;
+    }
+    uart_rx_len = 0;
+    return 1;
+}
@@ -0,0 +1,17 @@
+#ifndef __UART_FRAME_H__
+#define __UART_FRAME_H__
+
+// ------------------- 组帧配置 -------------------
+// 协议帧固定6字节：PID、AID、3字节数据、FCS（前5字节求和）。接收字节逐个送入滑动窗口，
+// 窗口满6字节且FCS校验通过即得到一帧；校验失败时窗口逐字节左移，直到重新对齐到有效帧。
+// 总线静默超过帧间超时时由定时器中断直接将uart_rx_len清零（见Timer0_ISR）
+#define UART_BUFF_SIZE  6             // 串口接收缓冲区大小（6字节协议帧）
+
+// ------------------- 全局变量声明 -------------------
+extern unsigned char uart_rx_buff[UART_BUFF_SIZE];  // 组帧滑动窗口（仅ISR使用）
+extern unsigned char uart_rx_len;                 // 组帧窗口内数据长度
+
+// ------------------- 函数声明 -------------------
+bit UART4_FrameFeed(unsigned char dat);           // 送入一个接收字节，得到有效帧返回1（帧在uart_rx_buff中）
+
+#endif